@@ -49,6 +49,8 @@ public class MySQL : ModuleRules
 
     
         PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+        // The awaitable query API (MySQLCoroutine.h) uses C++20 coroutines
+        CppStandard = CppStandardVersion.Cpp20;
 
         UndefinedIdentifierWarningLevel = WarningLevel.Off;
         bEnableExceptions = true;
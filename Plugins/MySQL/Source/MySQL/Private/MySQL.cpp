@@ -1,6 +1,7 @@
 // Copyright Athian Games. All Rights Reserved. 
 
 #include "MySQL.h"
+#include "MySQLBPLibrary.h"
 
 #define LOCTEXT_NAMESPACE "FMySQLModule"
 
@@ -35,6 +36,8 @@ void FMySQLModule::StartupModule()
 	// CopyDLL(TEXT("libcrypto-1_1-x64.dll"));
 	// CopyDLL(TEXT("libssl-1_1-x64.dll"));
 
+	// Image uploads and decodes run on worker threads, which must not load modules themselves
+	UMySQLBPLibrary::CreateImageWrapperModule();
 }
 
 
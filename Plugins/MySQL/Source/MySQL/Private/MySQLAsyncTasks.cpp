@@ -7,6 +7,33 @@
 #include "Async/Async.h"
 
 
+void FMySQLSelfReleasingTask::ReleaseOnGameThread(const TWeakObjectPtr<AMySQLDBConnectionActor>& DBConnectionActor)
+{
+	check(IsInGameThread());
+
+	// Copy before deleting: OwningTask owns this object.
+	FAsyncTaskBase* Task = OwningTask;
+	if (!Task)
+	{
+		return;
+	}
+
+	if (DBConnectionActor.IsValid())
+	{
+		DBConnectionActor->OnAsyncTaskReleased(Task);
+	}
+
+	// DoWork has already posted this callback and is returning; this only waits for the worker to unwind.
+	Task->EnsureCompletion();
+	delete Task;
+}
+
+bool FMySQLSelfReleasingTask::CanDeliverResults(const TWeakObjectPtr<AMySQLDBConnectionActor>& DBConnectionActor)
+{
+	return DBConnectionActor.IsValid() && DBConnectionActor->IsValidLowLevel() && !DBConnectionActor->HasEndedPlay();
+}
+
+
 OpenMySQLConnectionTask::OpenMySQLConnectionTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, int32 connectionID,
 	TWeakObjectPtr<UMySQLDBConnector> dbConnector, FString server, FString dBName, FString userID, FString password, int32 port, TArray<FMySQLOptionPair> options)
 {
@@ -37,22 +64,20 @@ void OpenMySQLConnectionTask::DoWork()
         
 		AsyncTask(ENamedThreads::GameThread, [this, ConnectionStatus, ErrorMessage]()
 		{
-			if (CurrentDBConnectionActor.IsValid())
+			if (CanDeliverResults(CurrentDBConnectionActor))
 			{
-				CurrentDBConnectionActor->bIsConnectionBusy = false;
-				if(!ConnectionStatus)
-				{
-					CurrentDBConnectionActor->ResetLastConnection();
-				}
-                
+				// Release queries that were queued while the handshake was running, or fail them and drop the
+				// connector if it failed
+				CurrentDBConnectionActor->OnConnectionOpened(ConnectionID, ConnectionStatus);
+
 				// Call the event for the server
 				CurrentDBConnectionActor->OnConnectionStateChanged(ConnectionStatus, ConnectionID, ErrorMessage);
                 
 				// Check if this connection was requested by a client
-				if (CurrentDBConnectionActor->ClientRequestMap.Contains(ConnectionID))
+				if (CurrentDBConnectionActor->ClientConnectionRequestMap.Contains(ConnectionID))
 				{
 					// Find the client actor
-					FClientRequest ClientRequest = CurrentDBConnectionActor->ClientRequestMap[ConnectionID];
+					FClientRequest ClientRequest = CurrentDBConnectionActor->ClientConnectionRequestMap[ConnectionID];
 					APlayerController* Client = Cast<APlayerController>(ClientRequest.RequestingClient);
                     
 					if (Client)
@@ -62,17 +87,29 @@ void OpenMySQLConnectionTask::DoWork()
 					}
                     
 					// Remove from the map
-					CurrentDBConnectionActor->ClientRequestMap.Remove(ConnectionID);
+					CurrentDBConnectionActor->ClientConnectionRequestMap.Remove(ConnectionID);
 				}
 			}
+
+			ReleaseOnGameThread(CurrentDBConnectionActor);
+		});
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, [this]()
+		{
+			ReleaseOnGameThread(CurrentDBConnectionActor);
 		});
 	}
 }
 
 
-UpdateMySQLQueryAsyncTask::UpdateMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int32 queryID, TArray<FString> queries)
+UpdateMySQLQueryAsyncTask::UpdateMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID, TArray<FString> queries, TArray<FMySQLParam> params,
+	bool useTransaction)
 {
 	Queries = queries;
+	Params = params;
+	bUseTransaction = useTransaction;
 	CurrentDBConnectionActor = dbConnectionActor;
 	MySQLDBConnector = dbConnector;
 	ConnectionID = connectionID;
@@ -88,23 +125,36 @@ void UpdateMySQLQueryAsyncTask::DoWork()
 {
 	FString ErrorMessage;
 	bool currentUpdateQueryStatus = false;
+	const bool bIsBatch = Params.Num() == 0 && (Queries.Num() > 1 || bUseTransaction);
+	TArray<FMySQLStatementResult> StatementResults;
     
 	if (MySQLDBConnector.IsValid() && MySQLDBConnector->IsValidLowLevel())
 	{
-		for (int iIndex = 0; iIndex < Queries.Num(); iIndex++)
+		if (Params.Num() > 0)
+		{
+			MySQLDBConnector->ExecuteParams(ConnectionID, QueryID, Queries[0], Params, currentUpdateQueryStatus, ErrorMessage);
+		}
+		else if (bIsBatch)
+		{
+			MySQLDBConnector->ExecuteBatch(ConnectionID, QueryID, Queries, bUseTransaction, StatementResults, currentUpdateQueryStatus, ErrorMessage);
+		}
+		else if (Queries.Num() > 0)
 		{
-			MySQLDBConnector->UpdateDataFromQuery(ConnectionID, QueryID, Queries[iIndex], currentUpdateQueryStatus, ErrorMessage);
+			MySQLDBConnector->UpdateDataFromQuery(ConnectionID, QueryID, Queries[0], currentUpdateQueryStatus, ErrorMessage);
 		}
 	}
 
-	AsyncTask(ENamedThreads::GameThread, [this, currentUpdateQueryStatus, ErrorMessage]()
+	AsyncTask(ENamedThreads::GameThread, [this, currentUpdateQueryStatus, ErrorMessage, bIsBatch, StatementResults = MoveTemp(StatementResults)]()
 	{
-		if (CurrentDBConnectionActor.IsValid() && CurrentDBConnectionActor->IsValidLowLevel())
+		if (CanDeliverResults(CurrentDBConnectionActor))
 		{
-			CurrentDBConnectionActor->bIsConnectionBusy = false;
             
 			// Forward results to server event handler
 			CurrentDBConnectionActor->OnQueryUpdateStatusChanged(ConnectionID, QueryID, currentUpdateQueryStatus, ErrorMessage);
+			if (bIsBatch)
+			{
+				CurrentDBConnectionActor->OnQueryBatchStatusChanged(ConnectionID, QueryID, currentUpdateQueryStatus, ErrorMessage, StatementResults);
+			}
             
 			// Check if this query was requested by a client
 			if (CurrentDBConnectionActor->ClientRequestMap.Contains(QueryID))
@@ -120,18 +170,24 @@ void UpdateMySQLQueryAsyncTask::DoWork()
 				CurrentDBConnectionActor->ClientRequestMap.Remove(QueryID);
 			}
             
-			CurrentDBConnectionActor->ExecuteNextQueryTask();
+			CurrentDBConnectionActor->OnQueryResultDelivered(QueryID, currentUpdateQueryStatus);
+			CurrentDBConnectionActor->OnQueryTaskCompleted(ConnectionID);
 		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
 	});
 }
 
-SelectMySQLQueryAsyncTask::SelectMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int32 queryID, FString query)
+SelectMySQLQueryAsyncTask::SelectMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID, FString query,
+	EMySQLResultLayout resultLayout, int32 batchSize)
 {
 	Query = query;
 	CurrentDBConnectionActor = dbConnectionActor;
 	MySQLDBConnector = dbConnector;
 	ConnectionID = connectionID;
 	QueryID = queryID;
+	ResultLayout = resultLayout;
+	BatchSize = batchSize;
 }
 
 SelectMySQLQueryAsyncTask::~SelectMySQLQueryAsyncTask()
@@ -146,9 +202,28 @@ void SelectMySQLQueryAsyncTask::DoWork()
 	TArray<FMySQLDataTable> ResultByColumn;
 	TArray<FMySQLDataRow> ResultByRow;
 
-	if (MySQLDBConnector.IsValid())
+	if (MySQLDBConnector.IsValid() && BatchSize > 0)
+	{
+		int32 BatchIndex = 0;
+		MySQLDBConnector->SelectDataStreaming(ConnectionID, Query, BatchSize, ResultLayout,
+			[this, &BatchIndex](TArray<FMySQLDataTable>& BatchByColumn, TArray<FMySQLDataRow>& BatchByRow)
+			{
+				// Posted in order ahead of the final status callback below
+				AsyncTask(ENamedThreads::GameThread, [DBConnectionActor = CurrentDBConnectionActor, ConnectionID = ConnectionID, QueryID = QueryID, BatchIndex,
+					BatchByColumn = MoveTemp(BatchByColumn), BatchByRow = MoveTemp(BatchByRow)]()
+				{
+					if (CanDeliverResults(DBConnectionActor))
+					{
+						DBConnectionActor->OnQuerySelectBatchReceived(ConnectionID, QueryID, BatchIndex, BatchByColumn, BatchByRow);
+					}
+				});
+				BatchIndex++;
+			},
+			SelectQueryStatus, ErrorMessage);
+	}
+	else if (MySQLDBConnector.IsValid())
 	{
-		MySQLDBConnector->SelectDataFromQuery(ConnectionID, Query, SelectQueryStatus, ErrorMessage, ResultByColumn, ResultByRow);
+		MySQLDBConnector->SelectDataFromQuery(ConnectionID, Query, SelectQueryStatus, ErrorMessage, ResultByColumn, ResultByRow, ResultLayout);
 	}
 	else
 	{
@@ -156,11 +231,10 @@ void SelectMySQLQueryAsyncTask::DoWork()
 		SelectQueryStatus = false;
 	}
 
-	AsyncTask(ENamedThreads::GameThread, [this, SelectQueryStatus, ErrorMessage, ResultByColumn, ResultByRow]()
+	AsyncTask(ENamedThreads::GameThread, [this, SelectQueryStatus, ErrorMessage, ResultByColumn = MoveTemp(ResultByColumn), ResultByRow = MoveTemp(ResultByRow)]()
 	{
-		if (CurrentDBConnectionActor.IsValid() && CurrentDBConnectionActor->IsValidLowLevel())
+		if (CanDeliverResults(CurrentDBConnectionActor))
 		{
-			CurrentDBConnectionActor->bIsConnectionBusy = false;
             
 			// Forward results to server event handler
 			CurrentDBConnectionActor->OnQuerySelectStatusChanged(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, ResultByColumn, ResultByRow);
@@ -172,25 +246,125 @@ void SelectMySQLQueryAsyncTask::DoWork()
 				APlayerController* Client = Cast<APlayerController>(CurrentDBConnectionActor->ClientRequestMap[QueryID].RequestingClient);
 				if (Client)
 				{
-					CurrentDBConnectionActor->ClientReceiveQueryResults(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, ResultByColumn, ResultByRow);
+					CurrentDBConnectionActor->SendQueryResultsToClient(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, ResultByColumn, ResultByRow);
 				}
                 
 				// Clean up
 				CurrentDBConnectionActor->ClientRequestMap.Remove(QueryID);
 			}
             
-			CurrentDBConnectionActor->ExecuteNextQueryTask();
+			CurrentDBConnectionActor->OnQueryResultDelivered(QueryID, SelectQueryStatus);
+			CurrentDBConnectionActor->OnQueryTaskCompleted(ConnectionID);
 		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
 	});
 }
 
 
-UpdateMySQLImageAsyncTask::UpdateMySQLImageAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int32 queryID, FString query, FString updateParameter, int parameterID, FString imagePath)
+SelectTypedMySQLQueryAsyncTask::SelectTypedMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector,
+	int32 connectionID, int64 queryID, FString query, TArray<FMySQLParam> params)
+{
+	Query = query;
+	Params = params;
+	CurrentDBConnectionActor = dbConnectionActor;
+	MySQLDBConnector = dbConnector;
+	ConnectionID = connectionID;
+	QueryID = queryID;
+}
+
+SelectTypedMySQLQueryAsyncTask::~SelectTypedMySQLQueryAsyncTask()
+{
+
+}
+
+void SelectTypedMySQLQueryAsyncTask::DoWork()
+{
+	FString ErrorMessage;
+	bool SelectQueryStatus = false;
+	FMySQLTypedResult Result;
+
+	if (MySQLDBConnector.IsValid())
+	{
+		MySQLDBConnector->SelectTyped(ConnectionID, Query, Params, Result, SelectQueryStatus, ErrorMessage);
+	}
+	else
+	{
+		ErrorMessage = "Invalid Connection";
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [this, SelectQueryStatus, ErrorMessage, Result = MoveTemp(Result)]()
+	{
+		if (CanDeliverResults(CurrentDBConnectionActor))
+		{
+			CurrentDBConnectionActor->OnQueryTypedSelectStatusChanged(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, Result);
+			CurrentDBConnectionActor->OnQueryResultDelivered(QueryID, SelectQueryStatus);
+			CurrentDBConnectionActor->OnQueryTaskCompleted(ConnectionID);
+		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
+	});
+}
+
+
+BulkInsertMySQLAsyncTask::BulkInsertMySQLAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID,
+	int64 queryID, FString table, TArray<FString> columns, TArray<FMySQLDataRow> rows)
+{
+	Table = MoveTemp(table);
+	Columns = MoveTemp(columns);
+	Rows = MoveTemp(rows);
+	CurrentDBConnectionActor = dbConnectionActor;
+	MySQLDBConnector = dbConnector;
+	ConnectionID = connectionID;
+	QueryID = queryID;
+}
+
+BulkInsertMySQLAsyncTask::~BulkInsertMySQLAsyncTask()
+{
+
+}
+
+void BulkInsertMySQLAsyncTask::DoWork()
+{
+	FString ErrorMessage;
+	bool InsertStatus = false;
+	int64 InsertedRows = 0;
+
+	if (MySQLDBConnector.IsValid())
+	{
+		MySQLDBConnector->BulkInsert(ConnectionID, QueryID, Table, Columns, Rows, InsertedRows, InsertStatus, ErrorMessage);
+	}
+	else
+	{
+		ErrorMessage = "Invalid Connection";
+	}
+
+	// The rows are no longer needed; don't keep them alive until the game thread gets to the callback
+	Rows.Empty();
+
+	AsyncTask(ENamedThreads::GameThread, [this, InsertStatus, InsertedRows, ErrorMessage]()
+	{
+		if (CanDeliverResults(CurrentDBConnectionActor))
+		{
+			CurrentDBConnectionActor->OnBulkInsertStatusChanged(ConnectionID, QueryID, InsertStatus, ErrorMessage, InsertedRows);
+			CurrentDBConnectionActor->OnQueryResultDelivered(QueryID, InsertStatus);
+			CurrentDBConnectionActor->OnQueryTaskCompleted(ConnectionID);
+		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
+	});
+}
+
+
+UpdateMySQLImageAsyncTask::UpdateMySQLImageAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID, FString query, FString updateParameter, int parameterID, FString imagePath,
+	EMySQLImageEncoding encoding, TArray<uint8> imageData)
 {
 	Query = query;
 	UpdateParameter = updateParameter;
 	ParameterID = parameterID;
 	ImagePath = imagePath;
+	Encoding = encoding;
+	ImageData = MoveTemp(imageData);
 	CurrentDBConnectionActor = dbConnectionActor;
 	MySQLDBConnector = dbConnector;
 	ConnectionID = connectionID;
@@ -210,7 +384,14 @@ void UpdateMySQLImageAsyncTask::DoWork()
 
 	if (MySQLDBConnector.IsValid())
 	{
-		 MySQLDBConnector->UpdateImageFromPath(ConnectionID, QueryID, Query, UpdateParameter, ParameterID, ImagePath, UpdateQueryStatus, ErrorMessage);
+		if (ImagePath.IsEmpty())
+		{
+			MySQLDBConnector->UpdateImageFromData(ConnectionID, QueryID, Query, ImageData, UpdateQueryStatus, ErrorMessage);
+		}
+		else
+		{
+			MySQLDBConnector->UpdateImageFromPath(ConnectionID, QueryID, Query, UpdateParameter, ParameterID, ImagePath, UpdateQueryStatus, ErrorMessage, Encoding);
+		}
 	}
 	else
 	{
@@ -220,9 +401,14 @@ void UpdateMySQLImageAsyncTask::DoWork()
 	
 	AsyncTask(ENamedThreads::GameThread, [this, UpdateQueryStatus, ErrorMessage]()
 	{
-		if (CurrentDBConnectionActor.IsValid() && CurrentDBConnectionActor->IsValidLowLevel())
+		if (CanDeliverResults(CurrentDBConnectionActor))
 		{
-			CurrentDBConnectionActor->bIsConnectionBusy = false;
+			// Cached selects may hold the image that was just replaced
+			if (UpdateQueryStatus)
+			{
+				CurrentDBConnectionActor->ClearImageCache();
+			}
+
 			CurrentDBConnectionActor->OnImageUpdateStatusChanged(ConnectionID, QueryID, UpdateQueryStatus, ErrorMessage);
         
 			// Check if this was a client request
@@ -236,18 +422,22 @@ void UpdateMySQLImageAsyncTask::DoWork()
 				CurrentDBConnectionActor->ClientRequestMap.Remove(QueryID);
 			}
         
-			CurrentDBConnectionActor->ExecuteNextQueryTask();
+			CurrentDBConnectionActor->OnQueryResultDelivered(QueryID, UpdateQueryStatus);
+			CurrentDBConnectionActor->OnQueryTaskCompleted(ConnectionID);
 		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
 	});
 }
 
 
 SelectMySQLImageAsyncTask::SelectMySQLImageAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector,
-	int32 connectionID, int32 queryID, FString query)
+	int32 connectionID, int64 queryID, FString query, TSharedPtr<FMySQLImageCache, ESPMode::ThreadSafe> imageCache)
 {
 	Query = query;
 	CurrentDBConnectionActor = dbConnectionActor;
 	MySQLDBConnector = dbConnector;
+	ImageCache = imageCache;
 	ConnectionID = connectionID;
 	QueryID = queryID;
 
@@ -260,45 +450,124 @@ SelectMySQLImageAsyncTask::~SelectMySQLImageAsyncTask()
 
 void SelectMySQLImageAsyncTask::DoWork()
 {
-	bool SelectQueryStatus;
+	bool SelectQueryStatus = false;
 	FString ErrorMessage;
-	UTexture2D* SelectedTexture = nullptr;
+	uint64 CacheGeneration = 0;
+	FMySQLDecodedImagePtr CachedImage = ImageCache.IsValid() ? ImageCache->Find(ConnectionID, Query, CacheGeneration) : nullptr;
+	TArray<uint8> ImageData;
 
-	if (MySQLDBConnector.IsValid())
+	if (CachedImage.IsValid())
+	{
+		SelectQueryStatus = true;
+	}
+	else if (MySQLDBConnector.IsValid())
 	{
-		SelectedTexture = MySQLDBConnector->SelectImageFromQuery(ConnectionID, QueryID, Query, SelectQueryStatus, ErrorMessage);
+		MySQLDBConnector->SelectImageFromQuery(ConnectionID, QueryID, Query, ImageData, SelectQueryStatus, ErrorMessage);
 	}
 	else
 	{
 		ErrorMessage = "InValid Connection";
-		SelectQueryStatus = false;
 	}
-	
-	AsyncTask(ENamedThreads::GameThread, [this, SelectQueryStatus, ErrorMessage, SelectedTexture]()
-{
-	if (CurrentDBConnectionActor.IsValid() && CurrentDBConnectionActor->IsValidLowLevel())
+
+	// The connection is free as soon as the blob has arrived, so the next query can run while this one decodes
+	Async(EAsyncExecution::ThreadPool, [DBConnectionActor = CurrentDBConnectionActor, ImageCache = ImageCache, ConnectionID = ConnectionID, QueryID = QueryID,
+		Query = Query, SelectQueryStatus, ErrorMessage, CachedImage, CacheGeneration, ImageData = MoveTemp(ImageData)]() mutable
 	{
-		CurrentDBConnectionActor->bIsConnectionBusy = false;
-		CurrentDBConnectionActor->OnImageSelectStatusChanged(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, SelectedTexture);
-        
-		// Check if this was a client request
-		if (CurrentDBConnectionActor->ClientRequestMap.Contains(QueryID))
+		FMySQLDecodedImagePtr Image = CachedImage;
+		if (SelectQueryStatus && !Image.IsValid())
 		{
-			APlayerController* Client = Cast<APlayerController>(CurrentDBConnectionActor->ClientRequestMap[QueryID].RequestingClient);
-			if (Client)
+			TSharedRef<FMySQLDecodedImage, ESPMode::ThreadSafe> Decoded = MakeShared<FMySQLDecodedImage, ESPMode::ThreadSafe>();
+			if (UMySQLBPLibrary::DecodeImageData(ImageData, Decoded->BGRA, Decoded->Width, Decoded->Height))
 			{
-				CurrentDBConnectionActor->ClientReceiveImageSelectStatus(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, SelectedTexture);
+				Image = Decoded;
+				if (ImageCache.IsValid())
+				{
+					ImageCache->Add(ConnectionID, Query, Image, CacheGeneration);
+				}
+			}
+			else
+			{
+				SelectQueryStatus = false;
+				ErrorMessage = "Selected data is not a PNG, JPEG or BMP image";
 			}
-			CurrentDBConnectionActor->ClientRequestMap.Remove(QueryID);
 		}
-        
-		CurrentDBConnectionActor->ExecuteNextQueryTask();
-	}
-});
 
+		AsyncTask(ENamedThreads::GameThread, [DBConnectionActor, ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, Image]()
+		{
+			if (!CanDeliverResults(DBConnectionActor))
+			{
+				return;
+			}
+
+			UTexture2D* SelectedTexture = Image.IsValid() ? UMySQLBPLibrary::CreateTextureFromBGRA(Image->BGRA, Image->Width, Image->Height) : nullptr;
+			DBConnectionActor->OnImageSelectStatusChanged(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, SelectedTexture);
+
+			// Check if this was a client request
+			if (DBConnectionActor->ClientRequestMap.Contains(QueryID))
+			{
+				APlayerController* Client = Cast<APlayerController>(DBConnectionActor->ClientRequestMap[QueryID].RequestingClient);
+				if (Client)
+				{
+					DBConnectionActor->ClientReceiveImageSelectStatus(ConnectionID, QueryID, SelectQueryStatus, ErrorMessage, SelectedTexture);
+				}
+				DBConnectionActor->ClientRequestMap.Remove(QueryID);
+			}
+
+			DBConnectionActor->OnQueryResultDelivered(QueryID, SelectQueryStatus);
+		});
+	});
+
+	AsyncTask(ENamedThreads::GameThread, [this]()
+	{
+		if (CanDeliverResults(CurrentDBConnectionActor))
+		{
+			CurrentDBConnectionActor->OnQueryTaskCompleted(ConnectionID);
+		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
+	});
 }
 
 
 
 
 
+
+
+KeepAliveMySQLConnectionTask::KeepAliveMySQLConnectionTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector,
+	int32 connectionID)
+{
+	CurrentDBConnectionActor = dbConnectionActor;
+	MySQLDBConnector = dbConnector;
+	ConnectionID = connectionID;
+}
+
+KeepAliveMySQLConnectionTask::~KeepAliveMySQLConnectionTask()
+{
+
+}
+
+void KeepAliveMySQLConnectionTask::DoWork()
+{
+	bool bIsAlive = false;
+	FString ErrorMessage;
+
+	if (MySQLDBConnector.IsValid())
+	{
+		bIsAlive = MySQLDBConnector->KeepAlive(ConnectionID, ErrorMessage);
+	}
+	else
+	{
+		ErrorMessage = "InValid Connection";
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [this, bIsAlive, ErrorMessage]()
+	{
+		if (CanDeliverResults(CurrentDBConnectionActor))
+		{
+			CurrentDBConnectionActor->OnKeepAliveCompleted(ConnectionID, bIsAlive, ErrorMessage);
+		}
+
+		ReleaseOnGameThread(CurrentDBConnectionActor);
+	});
+}
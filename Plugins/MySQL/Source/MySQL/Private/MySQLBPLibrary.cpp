@@ -46,44 +46,52 @@ void UMySQLBPLibrary::GetTexturePixels(UTexture2D* Texture, TArray<FColor>& OutP
 
 
 
-UTexture2D* UMySQLBPLibrary::LoadTexturefromCharData(char* ImageChar)
+bool UMySQLBPLibrary::DecodeImageData(const TArray<uint8>& ImageData, TArray<uint8>& OutBGRA, int32& OutWidth, int32& OutHeight)
 {
-	CreateImageWrapperModule();
+	if (!ImageWrapperModule || ImageData.Num() == 0)
+	{
+		return false;
+	}
 
-	if (ImageWrapperModule)
+	const EImageFormat ImageFormat = ImageWrapperModule->DetectImageFormat(ImageData.GetData(), ImageData.Num());
+	if (ImageFormat == EImageFormat::Invalid)
 	{
-		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(EImageFormat::PNG);
+		return false;
+	}
 
-		int length = reinterpret_cast<size_t>(ImageChar);
-		TArray<uint8> CompressedImageData;
-		CompressedImageData.AddUninitialized(length);
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(ImageFormat);
+	if (ImageWrapper.IsValid() && ImageWrapper->SetCompressed(ImageData.GetData(), ImageData.Num())
+		&& ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutBGRA))
+	{
+		OutWidth = static_cast<int32>(ImageWrapper->GetWidth());
+		OutHeight = static_cast<int32>(ImageWrapper->GetHeight());
+		return OutBGRA.Num() == static_cast<int64>(OutWidth) * OutHeight * 4;
+	}
+	return false;
+}
 
-		for (int i = 0; i < length; i++)
-		{
-			CompressedImageData[i] = ImageChar[i];
-		}
+UTexture2D* UMySQLBPLibrary::CreateTextureFromBGRA(const TArray<uint8>& BGRA, int32 Width, int32 Height)
+{
+	check(IsInGameThread());
 
-		if (ImageWrapper.IsValid() && ImageWrapper->SetCompressed(CompressedImageData.GetData(),
-		                                                          CompressedImageData.Num()))
-		{
-			TArray<uint8> UncompressedBGRA;
-			if (ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, UncompressedBGRA))
-			{
-				if (UTexture2D* Texture = UTexture2D::CreateTransient(ImageWrapper->GetWidth(),
-				                                                      ImageWrapper->GetHeight(), PF_B8G8R8A8))
-				{
-					void* TextureData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-					FMemory::Memcpy(TextureData, UncompressedBGRA.GetData(), UncompressedBGRA.Num());
-					Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
-
-					Texture->UpdateResource();
-					return Texture;
-				}
-			}
-		}
+	if (Width <= 0 || Height <= 0 || BGRA.Num() != Width * Height * 4)
+	{
+		return nullptr;
 	}
 
-	return nullptr;
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
+	if (!Texture)
+	{
+		return nullptr;
+	}
+
+	void* TextureData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(TextureData, BGRA.GetData(), BGRA.Num());
+	Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
+
+	// Enqueues the RHI resource creation and upload on the render thread
+	Texture->UpdateResource();
+	return Texture;
 }
 
 char* UMySQLBPLibrary::GetCharFromTextureData(UTexture2D* Texture, FString Path)
@@ -163,47 +171,56 @@ void UMySQLBPLibrary::CreateImageWrapperModule()
 	}
 }
 
-char* UMySQLBPLibrary::GetRawImageFromPath(FString ImagePath)
+bool UMySQLBPLibrary::GetImageBytesFromPath(const FString& ImagePath, EMySQLImageEncoding Encoding, TArray<uint8>& OutBytes, FString& ErrorMessage)
 {
-	CreateImageWrapperModule();
-	void* imagebytes = nullptr;
-	if (ImageWrapperModule)
+	// Runs on workers, where loading a module is not allowed; FMySQLModule::StartupModule loads it
+	if (!ImageWrapperModule)
 	{
-		FString Extension = FPaths::GetExtension(ImagePath);
-		EImageFormat ImageFormat;
+		ErrorMessage = TEXT("The ImageWrapper module is not loaded");
+		return false;
+	}
 
-		if (Extension.Equals("jpeg", ESearchCase::IgnoreCase) || Extension.Equals("jpg", ESearchCase::IgnoreCase))
-		{
-			ImageFormat = EImageFormat::JPEG;
-		}
-		else if (Extension.Equals("png", ESearchCase::IgnoreCase))
-		{
-			ImageFormat = EImageFormat::PNG;
-		}
-		else
-		{
-			ImageFormat = EImageFormat::BMP;
-		}
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *ImagePath))
+	{
+		ErrorMessage = FString::Printf(TEXT("Could not read %s"), *ImagePath);
+		return false;
+	}
 
-		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(ImageFormat);
+	const EImageFormat SourceFormat = ImageWrapperModule->DetectImageFormat(FileData.GetData(), FileData.Num());
+	if (SourceFormat == EImageFormat::Invalid)
+	{
+		ErrorMessage = FString::Printf(TEXT("%s is not a PNG, JPEG or BMP image"), *ImagePath);
+		return false;
+	}
+
+	const EImageFormat TargetFormat = Encoding == EMySQLImageEncoding::PNG ? EImageFormat::PNG
+		: Encoding == EMySQLImageEncoding::JPEG ? EImageFormat::JPEG
+		: SourceFormat;
 
-		TArray<uint8> RawFileData;
-		if (FFileHelper::LoadFileToArray(RawFileData, *ImagePath))
+	// Already in the requested format: store the compressed file as-is
+	if (TargetFormat == SourceFormat)
+	{
+		OutBytes = MoveTemp(FileData);
+		return true;
+	}
+
+	TSharedPtr<IImageWrapper> Decoder = ImageWrapperModule->CreateImageWrapper(SourceFormat);
+	TSharedPtr<IImageWrapper> Encoder = ImageWrapperModule->CreateImageWrapper(TargetFormat);
+	TArray<uint8> BGRA;
+	if (Decoder.IsValid() && Encoder.IsValid() && Decoder->SetCompressed(FileData.GetData(), FileData.Num())
+		&& Decoder->GetRaw(ERGBFormat::BGRA, 8, BGRA)
+		&& Encoder->SetRaw(BGRA.GetData(), BGRA.Num(), Decoder->GetWidth(), Decoder->GetHeight(), ERGBFormat::BGRA, 8))
+	{
+		OutBytes = Encoder->GetCompressed(TargetFormat == EImageFormat::JPEG ? 90 : 0);
+		if (OutBytes.Num() > 0)
 		{
-			if (ImageWrapper.IsValid() && ImageWrapper->SetCompressed(RawFileData.GetData(), RawFileData.Num()))
-			{
-				TArray<uint8> UncompressedBGRA;
-				if (ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, UncompressedBGRA))
-				{
-					const int64 RawNum = UncompressedBGRA.Num();
-					imagebytes = FMemory::Malloc(RawNum);
-					FMemory::Memcpy(imagebytes, UncompressedBGRA.GetData(), RawNum);
-				}
-			}
+			return true;
 		}
 	}
 
-	return static_cast<char*>(imagebytes);
+	ErrorMessage = FString::Printf(TEXT("Could not re-encode %s"), *ImagePath);
+	return false;
 }
 
 
@@ -270,3 +287,155 @@ TArray<FString> UMySQLBPLibrary::GetSplitStringArray(FString Input, FString Patt
 
 	return Results;
 }
+
+FMySQLParam UMySQLBPLibrary::MakeMySQLParamNull()
+{
+	return FMySQLParam();
+}
+
+FMySQLParam UMySQLBPLibrary::MakeMySQLParamInt(int64 Value)
+{
+	FMySQLParam Param;
+	Param.Type = EMySQLParamType::Int;
+	Param.IntValue = Value;
+	return Param;
+}
+
+FMySQLParam UMySQLBPLibrary::MakeMySQLParamFloat(double Value)
+{
+	FMySQLParam Param;
+	Param.Type = EMySQLParamType::Float;
+	Param.FloatValue = Value;
+	return Param;
+}
+
+FMySQLParam UMySQLBPLibrary::MakeMySQLParamString(const FString& Value)
+{
+	FMySQLParam Param;
+	Param.Type = EMySQLParamType::String;
+	Param.StringValue = Value;
+	return Param;
+}
+
+FMySQLParam UMySQLBPLibrary::MakeMySQLParamBool(bool Value)
+{
+	FMySQLParam Param;
+	Param.Type = EMySQLParamType::Bool;
+	Param.IntValue = Value ? 1 : 0;
+	return Param;
+}
+
+FMySQLParam UMySQLBPLibrary::MakeMySQLParamBlob(const TArray<uint8>& Value)
+{
+	FMySQLParam Param;
+	Param.Type = EMySQLParamType::Blob;
+	Param.BlobValue = Value;
+	return Param;
+}
+
+int32 UMySQLBPLibrary::FindTypedColumn(const FMySQLTypedResult& Result, const FString& Name)
+{
+	return Result.Columns.IndexOfByPredicate([&Name](const FMySQLTypedColumn& Column)
+	{
+		return Column.Name.Equals(Name, ESearchCase::IgnoreCase);
+	});
+}
+
+// Returns the column if Row is in range and the value is not null
+static const FMySQLTypedColumn* GetTypedCell(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	if (!Result.Columns.IsValidIndex(Column) || Row < 0 || Row >= Result.NumRows)
+	{
+		return nullptr;
+	}
+	const FMySQLTypedColumn& TypedColumn = Result.Columns[Column];
+	return TypedColumn.IsNull(Row) ? nullptr : &TypedColumn;
+}
+
+bool UMySQLBPLibrary::IsTypedValueNull(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	return GetTypedCell(Result, Column, Row) == nullptr;
+}
+
+int64 UMySQLBPLibrary::GetTypedInt(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	if (const FMySQLTypedColumn* TypedColumn = GetTypedCell(Result, Column, Row))
+	{
+		switch (TypedColumn->Type)
+		{
+		case EMySQLColumnType::Int:
+			return TypedColumn->IntValues[Row];
+		case EMySQLColumnType::Float:
+			return static_cast<int64>(TypedColumn->FloatValues[Row]);
+		case EMySQLColumnType::DateTime:
+			return TypedColumn->DateTimeValues[Row].ToUnixTimestamp();
+		default:
+			break;
+		}
+	}
+	return 0;
+}
+
+double UMySQLBPLibrary::GetTypedFloat(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	if (const FMySQLTypedColumn* TypedColumn = GetTypedCell(Result, Column, Row))
+	{
+		switch (TypedColumn->Type)
+		{
+		case EMySQLColumnType::Float:
+			return TypedColumn->FloatValues[Row];
+		case EMySQLColumnType::Int:
+			return static_cast<double>(TypedColumn->IntValues[Row]);
+		default:
+			break;
+		}
+	}
+	return 0.0;
+}
+
+FString UMySQLBPLibrary::GetTypedString(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	if (const FMySQLTypedColumn* TypedColumn = GetTypedCell(Result, Column, Row))
+	{
+		switch (TypedColumn->Type)
+		{
+		case EMySQLColumnType::Int:
+			return LexToString(TypedColumn->IntValues[Row]);
+		case EMySQLColumnType::Float:
+			return LexToString(TypedColumn->FloatValues[Row]);
+		case EMySQLColumnType::String:
+			return TypedColumn->StringValues[Row];
+		case EMySQLColumnType::DateTime:
+			return TypedColumn->DateTimeValues[Row].ToString(TEXT("%Y-%m-%d %H:%M:%S"));
+		case EMySQLColumnType::Blob:
+			{
+				const int32 Start = TypedColumn->BlobOffsets[Row];
+				const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(TypedColumn->BlobData.GetData() + Start),
+					TypedColumn->BlobOffsets[Row + 1] - Start);
+				return FString(Converted.Length(), Converted.Get());
+			}
+		}
+	}
+	return FString();
+}
+
+FDateTime UMySQLBPLibrary::GetTypedDateTime(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	const FMySQLTypedColumn* TypedColumn = GetTypedCell(Result, Column, Row);
+	if (TypedColumn && TypedColumn->Type == EMySQLColumnType::DateTime)
+	{
+		return TypedColumn->DateTimeValues[Row];
+	}
+	return FDateTime();
+}
+
+TArray<uint8> UMySQLBPLibrary::GetTypedBlob(const FMySQLTypedResult& Result, int32 Column, int32 Row)
+{
+	const FMySQLTypedColumn* TypedColumn = GetTypedCell(Result, Column, Row);
+	if (TypedColumn && TypedColumn->Type == EMySQLColumnType::Blob)
+	{
+		const int32 Start = TypedColumn->BlobOffsets[Row];
+		return TArray<uint8>(TypedColumn->BlobData.GetData() + Start, TypedColumn->BlobOffsets[Row + 1] - Start);
+	}
+	return TArray<uint8>();
+}
@@ -0,0 +1,114 @@
+// Copyright Athian Games. All Rights Reserved. 
+
+
+#include "MySQLConnectionPoolSubsystem.h"
+#include "Async/Async.h"
+
+
+void UMySQLConnectionPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	MaintenanceHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UMySQLConnectionPoolSubsystem::RunMaintenance), MaintenanceIntervalSeconds);
+}
+
+void UMySQLConnectionPoolSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(MaintenanceHandle);
+
+	// Connectors still holding a lease keep their pool alive; those handles are closed when released
+	for (auto& Entry : Pools)
+	{
+		for (const shared_ptr<FMySQLConnectionPool>& Pool : Entry.Value)
+		{
+			Pool->Shutdown();
+		}
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+shared_ptr<FMySQLConnectionPool> UMySQLConnectionPoolSubsystem::GetOrCreatePool(const FString& Server, const FString& DBName, const FString& UserID,
+	const FString& Password, int32 Port, const TArray<FMySQLOptionPair>& Options)
+{
+	FMySQLConnectSettings Settings;
+	Settings.Server = TCHAR_TO_UTF8(*Server);
+	Settings.DBName = TCHAR_TO_UTF8(*DBName);
+	Settings.UserID = TCHAR_TO_UTF8(*UserID);
+	Settings.Password = TCHAR_TO_UTF8(*Password);
+	Settings.Port = Port;
+	Settings.Options = Options;
+
+	// The DSN only narrows the search; a handle is never shared unless every setting matches exactly
+	const FString DSN = FString::Printf(TEXT("%s@%s:%d/%s"), *UserID, *Server, Port, *DBName);
+	TArray<shared_ptr<FMySQLConnectionPool>>& Candidates = Pools.FindOrAdd(DSN);
+	for (const shared_ptr<FMySQLConnectionPool>& Candidate : Candidates)
+	{
+		if (Candidate->GetSettings() == Settings)
+		{
+			return Candidate;
+		}
+	}
+
+	shared_ptr<FMySQLConnectionPool> Pool = make_shared<FMySQLConnectionPool>(Settings);
+	ApplyLimits(*Pool);
+	Candidates.Add(Pool);
+	return Pool;
+}
+
+void UMySQLConnectionPoolSubsystem::SetPoolLimits(int32 MinConnections, int32 MaxConnections, float IdleTimeout)
+{
+	MaxConnectionsPerDSN = FMath::Max(MaxConnections, 1);
+	MinConnectionsPerDSN = FMath::Clamp(MinConnections, 0, MaxConnectionsPerDSN);
+	IdleTimeoutSeconds = FMath::Max(IdleTimeout, 1.f);
+
+	for (auto& Entry : Pools)
+	{
+		for (const shared_ptr<FMySQLConnectionPool>& Pool : Entry.Value)
+		{
+			ApplyLimits(*Pool);
+		}
+	}
+}
+
+void UMySQLConnectionPoolSubsystem::ApplyLimits(FMySQLConnectionPool& Pool) const
+{
+	// Workers read the limits while leasing, the pool swaps them under its lock
+	Pool.SetLimits(MinConnectionsPerDSN, MaxConnectionsPerDSN, IdleTimeoutSeconds);
+}
+
+TArray<FMySQLPoolStats> UMySQLConnectionPoolSubsystem::GetPoolStats() const
+{
+	TArray<FMySQLPoolStats> Stats;
+	Stats.Reserve(Pools.Num());
+	for (const auto& Entry : Pools)
+	{
+		for (int32 iIndex = 0; iIndex < Entry.Value.Num(); iIndex++)
+		{
+			// Pools that share a DSN are told apart by position, never by anything derived from the password
+			FMySQLPoolStats& Item = Stats.AddDefaulted_GetRef();
+			Item.DSN = iIndex == 0 ? Entry.Key : FString::Printf(TEXT("%s (%d)"), *Entry.Key, iIndex + 1);
+			Item.IdleConnections = Entry.Value[iIndex]->GetNumIdle();
+			Item.LeasedConnections = Entry.Value[iIndex]->GetNumLeased();
+		}
+	}
+	return Stats;
+}
+
+bool UMySQLConnectionPoolSubsystem::RunMaintenance(float DeltaTime)
+{
+	// Closing and opening connections blocks, so it never runs on the game thread
+	for (const auto& Entry : Pools)
+	{
+		for (const shared_ptr<FMySQLConnectionPool>& Pool : Entry.Value)
+		{
+			Async(EAsyncExecution::ThreadPool, [Pool]()
+			{
+				Pool->Maintain();
+			});
+		}
+	}
+	return true;
+}
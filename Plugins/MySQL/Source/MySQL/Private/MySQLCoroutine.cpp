@@ -0,0 +1,158 @@
+// Copyright Athian Games. All Rights Reserved.
+
+#include "MySQLCoroutine.h"
+#include "MySQLDBConnectionActor.h"
+#include "MySQLDBConnector.h"
+#include "Tasks/Task.h"
+
+
+FMySQLSessionQuery::FMySQLSessionQuery(FMySQLSession* InSession, const FString& InSql, const TArray<FMySQLParam>& InParams, bool bInIsSelect)
+	: Session(InSession)
+	, Sql(InSql)
+	, Params(InParams)
+	, bIsSelect(bInIsSelect)
+{
+}
+
+bool FMySQLSessionQuery::await_suspend(std::coroutine_handle<> Awaiting)
+{
+	// Already on a worker: run right here and carry on without suspending
+	if (!IsInGameThread())
+	{
+		Outcome = Session->Run(Sql, Params, bIsSelect);
+		return false;
+	}
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Awaiting]()
+	{
+		Outcome = Session->Run(Sql, Params, bIsSelect);
+		Awaiting.resume();
+	});
+	return true;
+}
+
+
+FMySQLSession::FMySQLSession(TWeakObjectPtr<AMySQLDBConnectionActor> InActor, const FMySQLSessionLeasePtr& InLease, int32 InConnectionID, int64 InQueryID)
+	: Actor(InActor)
+	, Lease(InLease)
+	, ConnectionID(InConnectionID)
+	, QueryID(InQueryID)
+	, bIsHeld(true)
+{
+}
+
+FMySQLSession::FMySQLSession(FMySQLSession&& Other)
+{
+	*this = MoveTemp(Other);
+}
+
+FMySQLSession& FMySQLSession::operator=(FMySQLSession&& Other)
+{
+	if (this != &Other)
+	{
+		Release();
+		Actor = Other.Actor;
+		Lease = MoveTemp(Other.Lease);
+		ConnectionID = Other.ConnectionID;
+		QueryID = Other.QueryID;
+		bIsHeld = Other.bIsHeld;
+		bAllSuccessful = Other.bAllSuccessful;
+		Other.bIsHeld = false;
+	}
+	return *this;
+}
+
+FMySQLSession::~FMySQLSession()
+{
+	Release();
+}
+
+void FMySQLSession::Release()
+{
+	if (!bIsHeld)
+	{
+		return;
+	}
+	bIsHeld = false;
+	Lease.Reset();
+
+	// The queue belongs to the game thread, and this may run on a worker
+	AsyncTask(ENamedThreads::GameThread, [Actor = Actor, ConnectionID = ConnectionID, QueryID = QueryID, bAllSuccessful = bAllSuccessful]()
+	{
+		if (Actor.IsValid() && Actor->IsValidLowLevel() && !Actor->HasEndedPlay())
+		{
+			Actor->OnQueryResultDelivered(QueryID, bAllSuccessful);
+			Actor->OnQueryTaskCompleted(ConnectionID);
+		}
+	});
+}
+
+FMySQLQueryOutcome FMySQLSession::Run(const FString& Sql, const TArray<FMySQLParam>& Params, bool bIsSelect)
+{
+	FMySQLQueryOutcome Outcome;
+	if (!bIsHeld || !Lease.IsValid())
+	{
+		Outcome.ErrorMessage = TEXT("Session not Valid");
+		bAllSuccessful = false;
+		return Outcome;
+	}
+
+	// Held until the query is done, so the actor can't close the connection underneath it
+	FScopeLock Lock(&Lease->Mutex);
+	UMySQLDBConnector* CurrentConnector = Lease->Connector;
+	if (!CurrentConnector)
+	{
+		Outcome.ErrorMessage = TEXT("Session not Valid");
+	}
+	else if (bIsSelect)
+	{
+		CurrentConnector->SelectTyped(ConnectionID, Sql, Params, Outcome.Result, Outcome.IsSuccessful, Outcome.ErrorMessage);
+	}
+	else if (Params.Num() > 0)
+	{
+		CurrentConnector->ExecuteParams(ConnectionID, QueryID, Sql, Params, Outcome.IsSuccessful, Outcome.ErrorMessage);
+	}
+	else
+	{
+		CurrentConnector->UpdateDataFromQuery(ConnectionID, QueryID, Sql, Outcome.IsSuccessful, Outcome.ErrorMessage);
+	}
+
+	bAllSuccessful &= Outcome.IsSuccessful;
+	return Outcome;
+}
+
+
+FMySQLSessionAwaitable::FMySQLSessionAwaitable(TWeakObjectPtr<AMySQLDBConnectionActor> InActor, int32 InConnectionID)
+	: Actor(InActor)
+	, ConnectionID(InConnectionID)
+{
+}
+
+void FMySQLSessionAwaitable::await_suspend(std::coroutine_handle<> Awaiting)
+{
+	// The session is handed over on the game thread, but the coroutine continues on a worker
+	TFunction<void()> Enqueue = [this, Awaiting]()
+	{
+		AMySQLDBConnectionActor* CurrentActor = Actor.Get();
+		if (!CurrentActor)
+		{
+			UE::Tasks::Launch(UE_SOURCE_LOCATION, [Awaiting]() { Awaiting.resume(); });
+			return;
+		}
+
+		CurrentActor->EnqueueSession(ConnectionID, [this, Awaiting](FMySQLSession&& Granted)
+		{
+			Session = MoveTemp(Granted);
+			UE::Tasks::Launch(UE_SOURCE_LOCATION, [Awaiting]() { Awaiting.resume(); });
+		});
+	};
+
+	if (IsInGameThread())
+	{
+		Enqueue();
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, MoveTemp(Enqueue));
+	}
+}
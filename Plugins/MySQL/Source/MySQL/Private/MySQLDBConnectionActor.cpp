@@ -1,18 +1,25 @@
 // Copyright, Athian Games. All Rights Reserved. 
 
 #include "MySQLDBConnectionActor.h"
+#include "MySQLConnectionPoolSubsystem.h"
+#include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "TimerManager.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformFileManager.h"
 #include "HAL/FileManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Async/Async.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 // Sets default values
 AMySQLDBConnectionActor::AMySQLDBConnectionActor()
 {
-    // Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-    PrimaryActorTick.bCanEverTick = true;
+    // Tasks clean themselves up from their completion callbacks, so nothing needs per-frame polling.
+    PrimaryActorTick.bCanEverTick = false;
     bIsConnectionBusy = false;
     
     // Set up replication
@@ -30,63 +37,48 @@ AMySQLDBConnectionActor::AMySQLDBConnectionActor()
 // Called when the game starts or when spawned
 void AMySQLDBConnectionActor::BeginPlay()
 {
+    bHasEndedPlay = false;
     CloseAllConnections();
     Super::BeginPlay();
-}
-
-FCriticalSection Mutex;
-
-// Called every frame
-void AMySQLDBConnectionActor::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
 
-    Mutex.Lock(); // Lock access to shared resources
-    // Clean up finished tasks
-    CleanUpFinishedTasks<OpenMySQLConnectionTask>(OpenConnectionTasks);
-    CleanUpFinishedTasks<UpdateMySQLQueryAsyncTask>(UpdateQueryTasks);
-    CleanUpFinishedTasks<SelectMySQLQueryAsyncTask>(SelectQueryTasks);
-    CleanUpFinishedTasks<UpdateMySQLImageAsyncTask>(UpdateImageQueryTasks);
-    CleanUpFinishedTasks<SelectMySQLImageAsyncTask>(SelectImageQueryTasks);
-    Mutex.Unlock(); // Unlock access to shared resources
-    
-    // Update the busy state
-    bIsConnectionBusy = OpenConnectionTasks.Num() > 0
-        || UpdateQueryTasks.Num() > 0
-        || SelectQueryTasks.Num() > 0
-        || UpdateImageQueryTasks.Num() > 0
-        || SelectImageQueryTasks.Num() > 0;
-
-    if (!bIsConnectionBusy)
+    if (KeepAliveIntervalSeconds > 0.f)
     {
-        for (auto& entry : ConnectionToNextQueryIDMap)
-        {
-            entry.Value = 0;
-        }
+        GetWorldTimerManager().SetTimer(KeepAliveTimer, this, &AMySQLDBConnectionActor::SendKeepAlives, KeepAliveIntervalSeconds, true);
     }
 }
 
+void AMySQLDBConnectionActor::OnAsyncTaskReleased(FAsyncTaskBase* Task)
+{
+    ActiveTasks.Remove(Task);
+    bIsConnectionBusy = ActiveTasks.Num() > 0;
+}
+
 void AMySQLDBConnectionActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    // Ensure all UpdateQueryTasks have completed
-    for(const auto& Task : UpdateQueryTasks)
+    // Completion callbacks queued from here on only delete their task; nothing is broadcast
+    // on an actor whose play has ended.
+    bHasEndedPlay = true;
+
+    // Ensure all running tasks have completed
+    for (FAsyncTaskBase* Task : ActiveTasks)
     {
-        if(Task && !Task->IsDone())
-        {
-            Task->EnsureCompletion();
-        }
+        Task->EnsureCompletion();
     }
-    UpdateQueryTasks.Empty();
 
-    // Ensure all SelectQueryTasks have completed
-    for(const auto& Task : SelectQueryTasks)
+    // The skipped callbacks would have started the next queued queries; fail those instead,
+    // so the close below runs right away rather than waiting behind them
+    TMap<int32, FMySQLConnectionQueue> Abandoned = MoveTemp(ConnectionQueues);
+    ConnectionQueues.Empty();
+    for (auto& Entry : Abandoned)
     {
-        if(Task && !Task->IsDone())
+        for (FQueryTaskData& AbandonedTask : Entry.Value.Pending)
         {
-            Task->EnsureCompletion();
+            AbandonQueryTask(AbandonedTask);
         }
     }
-    SelectQueryTasks.Empty();
+
+    // Nothing will report these any more
+    QueryRegistry.FailAll();
 
     // Now you can safely close all connections
     CloseAllConnections();
@@ -146,12 +138,6 @@ void AMySQLDBConnectionActor::ClientReceiveConnectionStatus_Implementation(APlay
             // Create a dummy connector to keep track of the connection
             UMySQLDBConnector* DummyConnector = NewObject<UMySQLDBConnector>(this);
             SQLConnectors.Add(ConnectionID, DummyConnector);
-            
-            // Make sure we have an entry in the query ID map
-            if (!ConnectionToNextQueryIDMap.Contains(ConnectionID))
-            {
-                ConnectionToNextQueryIDMap.Add(ConnectionID, 0);
-            }
         }
         
         // Forward to the event
@@ -203,20 +189,22 @@ void AMySQLDBConnectionActor::ServerExecuteQuery_Implementation(const FQueryRequ
             {
                 MySQLOptions = MySQLOptionsAsset->ConnectionOptions;
             }
+            AttachConnectionPool(NewConnector, Server, DBName, UserID, Password, Port, MySQLOptions);
             
+            // Queries issued before the handshake finishes wait in the connection queue
+            ConnectionQueues.FindOrAdd(ConnectionID).bInFlight = true;
+
             // Create the connection and store the requesting client info
-            FAsyncTask<OpenMySQLConnectionTask>* OpenConnectionTask = StartAsyncTask<OpenMySQLConnectionTask>(
+            StartAsyncTask<OpenMySQLConnectionTask>(
                 this, ConnectionID, NewConnector, Server, DBName, UserID, Password, Port, MySQLOptions);
             
-            OpenConnectionTasks.Add(OpenConnectionTask);
-            
             // Store client info to send result back when connection completes
             if (Client)
             {
                 FClientRequest ClientRequest;
                 ClientRequest.QueryID = -1; // Special value for connection
                 ClientRequest.RequestingClient = Cast<AActor>(Client);
-                ClientRequestMap.Add(ConnectionID, ClientRequest);
+                ClientConnectionRequestMap.Add(ConnectionID, ClientRequest);
             }
             
             return;
@@ -224,28 +212,40 @@ void AMySQLDBConnectionActor::ServerExecuteQuery_Implementation(const FQueryRequ
     }
     
     // Regular query handling
-    int32 QueryID = GenerateQueryID(QueryRequest.ConnectionID);
-    
-    // Store the client request for sending back results
-    APlayerController* Client = Cast<APlayerController>(GetOwner());
-    if (Client)
-    {
-        FClientRequest ClientRequest;
-        ClientRequest.QueryID = QueryID;
-        ClientRequest.RequestingClient = Client;
-        ClientRequestMap.Add(QueryID, ClientRequest);
-    }
-    
+    const int64 PreviousQueryID = GetLastQueryID(QueryRequest.ConnectionID);
+
     if (QueryRequest.bIsSelectQuery)
     {
         // Execute a select query
         SelectDataFromQuery(QueryRequest.ConnectionID, QueryRequest.QueryString);
     }
+    else if (QueryRequest.BatchQueries.Num() > 0)
+    {
+        // Execute a batch of update queries in one round trip
+        UpdateDataFromMultipleQueries(QueryRequest.ConnectionID, QueryRequest.BatchQueries, EQueryExecutionContext::Default, QueryRequest.bUseTransaction);
+    }
+    else if (QueryRequest.Params.Num() > 0)
+    {
+        // Execute a parameterized update query
+        ExecuteParams(QueryRequest.ConnectionID, QueryRequest.QueryString, QueryRequest.Params);
+    }
     else
     {
         // Execute an update query
         UpdateDataFromQuery(QueryRequest.ConnectionID, QueryRequest.QueryString);
     }
+
+    // Store the client request under the handle the query was queued with, so its results find their way back.
+    // Results are only delivered on a later frame, so registering after queueing is in time.
+    const int64 QueryID = GetLastQueryID(QueryRequest.ConnectionID);
+    APlayerController* Client = Cast<APlayerController>(GetOwner());
+    if (Client && QueryID != PreviousQueryID)
+    {
+        FClientRequest ClientRequest;
+        ClientRequest.QueryID = QueryID;
+        ClientRequest.RequestingClient = Client;
+        ClientRequestMap.Add(QueryID, ClientRequest);
+    }
 }
 
 bool AMySQLDBConnectionActor::ServerExecuteImageQuery_Validate(const FQueryRequest& QueryRequest)
@@ -262,14 +262,8 @@ void AMySQLDBConnectionActor::ServerExecuteImageQuery_Implementation(const FQuer
         return; // Safety check
     }
     
-    int32 QueryID = GenerateQueryID(QueryRequest.ConnectionID);
-    
-    // Store the client request for sending back results
-    FClientRequest ClientRequest;
-    ClientRequest.QueryID = QueryID;
-    ClientRequest.RequestingClient = GetOwner();
-    ClientRequestMap.Add(QueryID, ClientRequest);
-    
+    const int64 PreviousQueryID = GetLastQueryID(QueryRequest.ConnectionID);
+
     if (QueryRequest.bIsSelectQuery)
     {
         // Execute a select image query
@@ -280,32 +274,268 @@ void AMySQLDBConnectionActor::ServerExecuteImageQuery_Implementation(const FQuer
         // Execute an update image query
         UpdateImageFromPath(QueryRequest.ConnectionID, QueryRequest.QueryString, 
                            QueryRequest.UpdateParameter, QueryRequest.ParameterID, 
-                           QueryRequest.ImagePath);
+                           QueryRequest.ImagePath, EQueryExecutionContext::Default, QueryRequest.ImageEncoding);
+    }
+
+    // Store the client request for sending back results
+    const int64 QueryID = GetLastQueryID(QueryRequest.ConnectionID);
+    if (QueryID != PreviousQueryID)
+    {
+        FClientRequest ClientRequest;
+        ClientRequest.QueryID = QueryID;
+        ClientRequest.RequestingClient = GetOwner();
+        ClientRequestMap.Add(QueryID, ClientRequest);
     }
 }
 
+// Sizes announced by the server are only trusted up to this, so a corrupt or hostile stream can't force huge allocations
+static constexpr int32 MaxQueryResultBytes = 256 * 1024 * 1024;
+
 // Client-side callback implementations
-void AMySQLDBConnectionActor::ClientReceiveQueryResults_Implementation(int32 ConnectionID, int32 QueryID, bool IsSuccessful, 
-                            const FString& ErrorMessage, const TArray<FMySQLDataTable>& ResultByColumn, 
-                            const TArray<FMySQLDataRow>& ResultByRow)
+// Only the column layout goes on the wire; the client rebuilds the rows from it
+static void EncodeQueryResults(const TArray<FMySQLDataTable>& ResultByColumn, const TArray<FMySQLDataRow>& ResultByRow,
+                               TArray<uint8>& OutPayload, int32& OutUncompressedSize, bool& bOutIsCompressed)
+{
+    TArray<uint8> Raw;
+    FMemoryWriter Writer(Raw);
+
+    if (ResultByColumn.Num() > 0 || ResultByRow.Num() == 0)
+    {
+        int32 NumColumns = ResultByColumn.Num();
+        Writer << NumColumns;
+        for (const FMySQLDataTable& Column : ResultByColumn)
+        {
+            Writer << const_cast<FString&>(Column.ColumnName);
+            Writer << const_cast<TArray<FString>&>(Column.ColumnData);
+        }
+    }
+    else
+    {
+        // Rows-only results have no column names; transpose them
+        int32 NumColumns = ResultByRow[0].RowData.Num();
+        Writer << NumColumns;
+        TArray<FString> ColumnData;
+        for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ColumnIndex++)
+        {
+            FString ColumnName;
+            Writer << ColumnName;
+
+            ColumnData.Reset(ResultByRow.Num());
+            for (const FMySQLDataRow& Row : ResultByRow)
+            {
+                ColumnData.Add(Row.RowData.IsValidIndex(ColumnIndex) ? Row.RowData[ColumnIndex] : FString());
+            }
+            Writer << ColumnData;
+        }
+    }
+
+    OutUncompressedSize = Raw.Num();
+    int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Raw.Num());
+    OutPayload.SetNumUninitialized(CompressedSize);
+    bOutIsCompressed = FCompression::CompressMemory(NAME_Oodle, OutPayload.GetData(), CompressedSize, Raw.GetData(), Raw.Num())
+        && CompressedSize < Raw.Num();
+
+    if (bOutIsCompressed)
+    {
+        OutPayload.SetNum(CompressedSize);
+    }
+    else
+    {
+        OutPayload = MoveTemp(Raw);
+    }
+}
+
+static bool DecodeQueryResults(const TArray<uint8>& Payload, int32 UncompressedSize, bool bIsCompressed,
+                               TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow)
 {
+    TArray<uint8> Raw;
+    if (bIsCompressed)
+    {
+        if (UncompressedSize < 0 || UncompressedSize > MaxQueryResultBytes)
+        {
+            return false;
+        }
+
+        Raw.SetNumUninitialized(UncompressedSize);
+        if (!FCompression::UncompressMemory(NAME_Oodle, Raw.GetData(), UncompressedSize, Payload.GetData(), Payload.Num()))
+        {
+            return false;
+        }
+    }
+
+    FMemoryReader Reader(bIsCompressed ? Raw : Payload);
+    int32 NumColumns = 0;
+    Reader << NumColumns;
+    if (NumColumns < 0 || NumColumns > Reader.TotalSize())
+    {
+        return false;
+    }
+
+    ResultByColumn.SetNum(NumColumns);
+    for (FMySQLDataTable& Column : ResultByColumn)
+    {
+        Reader << Column.ColumnName;
+        Reader << Column.ColumnData;
+    }
+    if (Reader.IsError())
+    {
+        return false;
+    }
+
+    const int32 NumRows = NumColumns > 0 ? ResultByColumn[0].ColumnData.Num() : 0;
+    ResultByRow.SetNum(NumRows);
+    for (int32 RowIndex = 0; RowIndex < NumRows; RowIndex++)
+    {
+        TArray<FString>& RowData = ResultByRow[RowIndex].RowData;
+        RowData.Reserve(NumColumns);
+        for (const FMySQLDataTable& Column : ResultByColumn)
+        {
+            RowData.Add(Column.ColumnData.IsValidIndex(RowIndex) ? Column.ColumnData[RowIndex] : FString());
+        }
+    }
+    return true;
+}
+
+void AMySQLDBConnectionActor::SendQueryResultsToClient(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+                                                       const TArray<FMySQLDataTable>& ResultByColumn, const TArray<FMySQLDataRow>& ResultByRow)
+{
+    TWeakObjectPtr<AMySQLDBConnectionActor> WeakThis(this);
+    Async(EAsyncExecution::ThreadPool, [WeakThis, ConnectionID, QueryID, IsSuccessful, ErrorMessage, ResultByColumn, ResultByRow]()
+    {
+        TArray<uint8> Payload;
+        int32 UncompressedSize = 0;
+        bool bIsCompressed = false;
+        EncodeQueryResults(ResultByColumn, ResultByRow, Payload, UncompressedSize, bIsCompressed);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, ConnectionID, QueryID, IsSuccessful, ErrorMessage, UncompressedSize, bIsCompressed,
+            Payload = MoveTemp(Payload)]() mutable
+        {
+            if (WeakThis.IsValid() && !WeakThis->HasEndedPlay())
+            {
+                WeakThis->StartOutgoingResult(ConnectionID, QueryID, IsSuccessful, ErrorMessage, UncompressedSize, bIsCompressed, MoveTemp(Payload));
+            }
+        });
+    });
+}
+
+void AMySQLDBConnectionActor::StartOutgoingResult(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+                                                  int32 UncompressedSize, bool bIsCompressed, TArray<uint8>&& Payload)
+{
+    ClientBeginQueryResults(ConnectionID, QueryID, IsSuccessful, ErrorMessage, UncompressedSize, Payload.Num(), bIsCompressed);
+
+    FMySQLOutgoingResult& Outgoing = OutgoingResults.Add(QueryID);
+    Outgoing.ChunkSize = FMath::Clamp(ResultChunkSize, 1024, 60000);
+    Outgoing.NumChunks = FMath::DivideAndRoundUp(Payload.Num(), Outgoing.ChunkSize);
+    Outgoing.Payload = MoveTemp(Payload);
+    PumpOutgoingResult(QueryID);
+}
+
+void AMySQLDBConnectionActor::PumpOutgoingResult(int64 QueryID)
+{
+    FMySQLOutgoingResult* Outgoing = OutgoingResults.Find(QueryID);
+    if (!Outgoing)
+    {
+        return;
+    }
+
+    const int32 Window = FMath::Max(ResultChunkWindow, 1);
+    while (Outgoing->NextChunk < Outgoing->NumChunks && Outgoing->NextChunk - Outgoing->NumAcked < Window)
+    {
+        const int32 Offset = Outgoing->NextChunk * Outgoing->ChunkSize;
+        const int32 Count = FMath::Min(Outgoing->ChunkSize, Outgoing->Payload.Num() - Offset);
+        ClientReceiveQueryResultChunk(QueryID, TArray<uint8>(Outgoing->Payload.GetData() + Offset, Count));
+        Outgoing->NextChunk++;
+    }
+
+    if (Outgoing->NumAcked >= Outgoing->NumChunks)
+    {
+        OutgoingResults.Remove(QueryID);
+    }
+}
+
+bool AMySQLDBConnectionActor::ServerAckQueryResultChunk_Validate(int64 QueryID)
+{
+    return true;
+}
+
+void AMySQLDBConnectionActor::ServerAckQueryResultChunk_Implementation(int64 QueryID)
+{
+    if (FMySQLOutgoingResult* Outgoing = OutgoingResults.Find(QueryID))
+    {
+        Outgoing->NumAcked = FMath::Min(Outgoing->NumAcked + 1, Outgoing->NextChunk);
+        PumpOutgoingResult(QueryID);
+    }
+}
+
+void AMySQLDBConnectionActor::ClientBeginQueryResults_Implementation(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+                                                                     int32 UncompressedSize, int32 PayloadSize, bool bIsCompressed)
+{
+    FMySQLIncomingResult& Incoming = IncomingResults.Add(QueryID);
+    Incoming.ConnectionID = ConnectionID;
+    Incoming.IsSuccessful = IsSuccessful;
+    Incoming.ErrorMessage = ErrorMessage;
+    Incoming.UncompressedSize = UncompressedSize;
+    Incoming.PayloadSize = PayloadSize;
+    Incoming.bIsCompressed = bIsCompressed;
+    Incoming.Payload.Reserve(FMath::Clamp(PayloadSize, 0, MaxQueryResultBytes));
+
+    if (PayloadSize <= 0)
+    {
+        FinishIncomingResult(QueryID);
+    }
+}
+
+void AMySQLDBConnectionActor::ClientReceiveQueryResultChunk_Implementation(int64 QueryID, const TArray<uint8>& Chunk)
+{
+    // Reliable RPCs arrive in order, so pages are simply appended
+    FMySQLIncomingResult* Incoming = IncomingResults.Find(QueryID);
+    ServerAckQueryResultChunk(QueryID);
+    if (!Incoming)
+    {
+        return;
+    }
+
+    Incoming->Payload.Append(Chunk);
+    if (Incoming->Payload.Num() >= Incoming->PayloadSize)
+    {
+        FinishIncomingResult(QueryID);
+    }
+}
+
+void AMySQLDBConnectionActor::FinishIncomingResult(int64 QueryID)
+{
+    FMySQLIncomingResult Incoming;
+    if (!IncomingResults.RemoveAndCopyValue(QueryID, Incoming))
+    {
+        return;
+    }
+
+    TArray<FMySQLDataTable> ResultByColumn;
+    TArray<FMySQLDataRow> ResultByRow;
+    if (!DecodeQueryResults(Incoming.Payload, Incoming.UncompressedSize, Incoming.bIsCompressed, ResultByColumn, ResultByRow))
+    {
+        OnQuerySelectStatusChanged(Incoming.ConnectionID, QueryID, false, TEXT("Received a corrupt query result from the server"),
+            TArray<FMySQLDataTable>(), TArray<FMySQLDataRow>());
+        return;
+    }
+
     // Forward the results to the blueprint event
-    OnQuerySelectStatusChanged(ConnectionID, QueryID, IsSuccessful, ErrorMessage, ResultByColumn, ResultByRow);
+    OnQuerySelectStatusChanged(Incoming.ConnectionID, QueryID, Incoming.IsSuccessful, Incoming.ErrorMessage, ResultByColumn, ResultByRow);
 }
 
-void AMySQLDBConnectionActor::ClientReceiveUpdateStatus_Implementation(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage)
+void AMySQLDBConnectionActor::ClientReceiveUpdateStatus_Implementation(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage)
 {
     // Forward the status to the blueprint event
     OnQueryUpdateStatusChanged(ConnectionID, QueryID, IsSuccessful, ErrorMessage);
 }
 
-void AMySQLDBConnectionActor::ClientReceiveImageSelectStatus_Implementation(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage, UTexture2D* SelectedTexture)
+void AMySQLDBConnectionActor::ClientReceiveImageSelectStatus_Implementation(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage, UTexture2D* SelectedTexture)
 {
     // Forward the status to the blueprint event
     OnImageSelectStatusChanged(ConnectionID, QueryID, IsSuccessful, ErrorMessage, SelectedTexture);
 }
 
-void AMySQLDBConnectionActor::ClientReceiveImageUpdateStatus_Implementation(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage)
+void AMySQLDBConnectionActor::ClientReceiveImageUpdateStatus_Implementation(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage)
 {
     // Forward the status to the blueprint event
     OnImageUpdateStatusChanged(ConnectionID, QueryID, IsSuccessful, ErrorMessage);
@@ -313,27 +543,35 @@ void AMySQLDBConnectionActor::ClientReceiveImageUpdateStatus_Implementation(int3
 
 
 
-int32 AMySQLDBConnectionActor::GenerateQueryID(int32 ConnectionID)
+int64 AMySQLDBConnectionActor::GenerateQueryID(int32 ConnectionID)
 {
-    if (!ConnectionToNextQueryIDMap.Contains(ConnectionID))
-    {
-        ConnectionToNextQueryIDMap.Add(ConnectionID, 0);
-    }
-
-    const int32 QueryID = ConnectionToNextQueryIDMap[ConnectionID];
-    ConnectionToNextQueryIDMap[ConnectionID]++;
+    const int64 QueryID = FMySQLQueryRegistry::AllocateHandle();
+    ConnectionToLastQueryIDMap.Add(ConnectionID, QueryID);
     return QueryID;
 }
 
-int32 AMySQLDBConnectionActor::GetLastQueryID(int32 ConnectionID)
+int64 AMySQLDBConnectionActor::GetLastQueryID(int32 ConnectionID)
+{
+    const int64* QueryID = ConnectionToLastQueryIDMap.Find(ConnectionID);
+    return QueryID ? *QueryID : -1;
+}
+
+bool AMySQLDBConnectionActor::IsQueryPending(int64 QueryID) const
+{
+    return QueryRegistry.IsPending(QueryID);
+}
+
+void AMySQLDBConnectionActor::WhenAll(const TArray<int64>& QueryIDs, const FMySQLQueriesCompleted& OnCompleted)
 {
-    int32 QueryID = -1;
-    if (ConnectionToNextQueryIDMap.Contains(ConnectionID))
+    QueryRegistry.WhenAll(QueryIDs, [QueryIDs, OnCompleted](bool bAllSuccessful)
     {
-        QueryID = ConnectionToNextQueryIDMap[ConnectionID];
-    }
+        OnCompleted.ExecuteIfBound(QueryIDs, bAllSuccessful);
+    });
+}
 
-    return QueryID;
+void AMySQLDBConnectionActor::OnQueryResultDelivered(int64 QueryID, bool IsSuccessful)
+{
+    QueryRegistry.Complete(QueryID, IsSuccessful);
 }
 
 UMySQLDBConnector* AMySQLDBConnectionActor::GetConnector(int32 ConnectionID)
@@ -371,15 +609,12 @@ void AMySQLDBConnectionActor::CloseConnection(int32 ConnectionID)
         }
     }
 
+    // Queued behind any pending queries on this connection
     FQueryTaskData CloseConnectionTask;
     CloseConnectionTask.ConnectionID = ConnectionID;
+    CloseConnectionTask.QueryID = -1;
     CloseConnectionTask.QueryType = EQueryType::Close;
-    QueryTaskQueue.Add(CloseConnectionTask);
-
-    if (!bIsQueryTaskRunning)
-    {
-        ExecuteNextQueryTask();
-    }
+    EnqueueQueryTask(MoveTemp(CloseConnectionTask));
 }
 
 void AMySQLDBConnectionActor::CloseAllConnections()
@@ -404,6 +639,16 @@ void AMySQLDBConnectionActor::CloseAllConnections()
         }
     }
 
+    // Sessions aren't tracked as tasks; wait for the query each may be running and fail the rest of theirs
+    for (const TWeakPtr<FMySQLSessionLease, ESPMode::ThreadSafe>& WeakLease : SessionLeases)
+    {
+        if (FMySQLSessionLeasePtr Lease = WeakLease.Pin())
+        {
+            Lease->Revoke();
+        }
+    }
+    SessionLeases.Empty();
+
     TArray<int32> ConnectionKeys;
     SQLConnectors.GetKeys(ConnectionKeys);
 
@@ -417,7 +662,12 @@ void AMySQLDBConnectionActor::CloseAllConnections()
 
 UMySQLDBConnector* AMySQLDBConnectionActor::CreateDBConnector(int32& ConnectionID)
 {
+    // A failed open frees its ID, so the count alone can land on a connection that is still in use
     ConnectionID = SQLConnectors.Num();
+    while (SQLConnectors.Contains(ConnectionID))
+    {
+        ConnectionID++;
+    }
     if (SQLConnectors.Num() > ConnectionID)
     {
         if (UMySQLDBConnector* NewConnector = SQLConnectors[ConnectionID])
@@ -429,10 +679,28 @@ UMySQLDBConnector* AMySQLDBConnectionActor::CreateDBConnector(int32& ConnectionI
     }
 
     UMySQLDBConnector* NewConnector = NewObject<UMySQLDBConnector>();
+    NewConnector->StatementCacheSize = PreparedStatementCacheSize;
+    NewConnector->IdlePingThresholdSeconds = ConnectionIdleCheckSeconds;
+    NewConnector->LoadDataRowThreshold = BulkInsertLoadDataThreshold;
     SQLConnectors.Add(ConnectionID, NewConnector);
     return NewConnector;
 }
 
+void AMySQLDBConnectionActor::AttachConnectionPool(UMySQLDBConnector* Connector, const FString& Server, const FString& DBName, const FString& UserID,
+                                                   const FString& Password, int32 Port, const TArray<FMySQLOptionPair>& Options)
+{
+    UGameInstance* GameInstance = GetGameInstance();
+    if (!bUseConnectionPool || !GameInstance)
+    {
+        return;
+    }
+
+    if (UMySQLConnectionPoolSubsystem* PoolSubsystem = GameInstance->GetSubsystem<UMySQLConnectionPoolSubsystem>())
+    {
+        Connector->ConnectionPool = PoolSubsystem->GetOrCreatePool(Server, DBName, UserID, Password, Port, Options);
+    }
+}
+
 void AMySQLDBConnectionActor::CopyDLL(FString DLLName)
 {
     const FString Pluginpath = IPluginManager::Get().FindPlugin(TEXT("MySQL"))->GetBaseDir();
@@ -458,17 +726,12 @@ void AMySQLDBConnectionActor::CopyDLL(FString DLLName)
     }
 }
 
-void AMySQLDBConnectionActor::ResetLastConnection()
+void AMySQLDBConnectionActor::ResetConnection(int32 ConnectionID)
 {
-    const int32 ConnectionID = SQLConnectors.Num() - 1;
-    if(ConnectionID >= 0)
+    UMySQLDBConnector* CurrentConnector = nullptr;
+    if (SQLConnectors.RemoveAndCopyValue(ConnectionID, CurrentConnector) && CurrentConnector)
     {
-        if(UMySQLDBConnector* CurrentConnector = SQLConnectors[ConnectionID])
-        {
-            CurrentConnector->ConditionalBeginDestroy();
-            CurrentConnector = nullptr;
-        }
-        SQLConnectors.Remove(ConnectionID);
+        CurrentConnector->ConditionalBeginDestroy();
     }
 }
 
@@ -494,7 +757,6 @@ void AMySQLDBConnectionActor::CreateNewConnection(FString Server, FString DBName
         
         // IMPORTANT: Simulate a local connection ID for the client to use
         int32 SimulatedConnectionID = SQLConnectors.Num();
-        ConnectionToNextQueryIDMap.Add(SimulatedConnectionID, 0);
         
         // Notify the client that a connection attempt is in progress
         OnConnectionStateChanged(true, SimulatedConnectionID, TEXT("Connection request sent to server"));
@@ -517,99 +779,304 @@ void AMySQLDBConnectionActor::CreateNewConnection(FString Server, FString DBName
     {
         MySQLOptions = MySQLOptionsAsset->ConnectionOptions;
     }
+    AttachConnectionPool(NewConnector, Server, DBName, UserID, Password, Port, MySQLOptions);
+
+    // Queries issued before the handshake finishes wait in the connection queue
+    ConnectionQueues.FindOrAdd(ConnectionID).bInFlight = true;
     
-    FAsyncTask<OpenMySQLConnectionTask>* OpenConnectionTask = StartAsyncTask<OpenMySQLConnectionTask>(
+    StartAsyncTask<OpenMySQLConnectionTask>(
         this, ConnectionID, NewConnector, Server, DBName, UserID, Password, Port, MySQLOptions);
     
-    OpenConnectionTasks.Add(OpenConnectionTask);
 }
 
-void AMySQLDBConnectionActor::ExecuteNextQueryTask()
+void AMySQLDBConnectionActor::EnqueueQueryTask(FQueryTaskData&& TaskData)
 {
-    if(IsValidLowLevel())
+    const int32 ConnectionID = TaskData.ConnectionID;
+
+    // Keepalive and close tasks carry no handle
+    if (TaskData.QueryID >= 0)
+    {
+        QueryRegistry.Register(TaskData.QueryID);
+    }
+
+    FMySQLConnectionQueue& Queue = ConnectionQueues.FindOrAdd(ConnectionID);
+    Queue.Pending.Add(MoveTemp(TaskData));
+    Queue.PeakPending = FMath::Max(Queue.PeakPending, Queue.Pending.Num());
+
+    DispatchQueryTask(ConnectionID);
+}
+
+void AMySQLDBConnectionActor::DispatchQueryTask(int32 ConnectionID)
+{
+    if(!IsValidLowLevel())
+    {
+        return;
+    }
+
+    FMySQLConnectionQueue* Queue = ConnectionQueues.Find(ConnectionID);
+
+    // Tasks that cannot start (connection already gone) are dropped so they don't block the queue
+    while (Queue && !Queue->bInFlight && Queue->Pending.Num() > 0)
     {
-        if(QueryTaskQueue.Num() > 0)
+        FQueryTaskData TaskData = MoveTemp(Queue->Pending[0]);
+        Queue->Pending.RemoveAt(0, 1, EAllowShrinking::No);
+
+        UMySQLDBConnector* CurrentConnector = GetConnector(ConnectionID);
+        if(CurrentConnector == nullptr)
         {
-            FQueryTaskData& TaskData = QueryTaskQueue.Last();
-            UMySQLDBConnector* CurrentConnector = GetConnector(TaskData.ConnectionID);
-            if(CurrentConnector == nullptr)
+            UE_LOG(LogTemp, Warning, TEXT("CurrentConnector is null for connection %d, dropping query %lld"), ConnectionID, TaskData.QueryID);
+
+            // Waiters may queue new queries, which can move the queues
+            AbandonQueryTask(TaskData);
+            Queue = ConnectionQueues.Find(ConnectionID);
+            continue;
+        }
+
+        Queue->bInFlight = true;
+        switch (TaskData.QueryType)
+        {
+        case EQueryType::Update:
             {
-                UE_LOG(LogTemp, Warning, TEXT("CurrentConnector is null"));
-                return;
+                StartAsyncTask<UpdateMySQLQueryAsyncTask>(
+                    this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries, TaskData.Params, TaskData.bUseTransaction);
+            }
+            break;
+        case EQueryType::Select:
+            {
+                StartAsyncTask<SelectMySQLQueryAsyncTask>(
+                    this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries[0], TaskData.ResultLayout, TaskData.BatchSize);
             }
+            break;
+        case EQueryType::TypedSelect:
+            {
+                StartAsyncTask<SelectTypedMySQLQueryAsyncTask>(
+                    this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries[0], TaskData.Params);
+            }
+            break;
+        case EQueryType::BulkInsert:
+            {
+                StartAsyncTask<BulkInsertMySQLAsyncTask>(
+                    this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries[0], MoveTemp(TaskData.Columns), MoveTemp(TaskData.Rows));
+            }
+            break;
+        case EQueryType::ImageUpdate:
+            {
+                StartAsyncTask<UpdateMySQLImageAsyncTask>(
+                    this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries[0], TaskData.UpdateParameter, TaskData.ParameterID, TaskData.ImagePath,
+                    TaskData.ImageEncoding, MoveTemp(TaskData.ImageData));
+            }
+            break;
+        case EQueryType::ImageSelect:
+            {
+                if (ImageCacheSizeMB > 0 && !ImageCache.IsValid())
+                {
+                    ImageCache = MakeShared<FMySQLImageCache, ESPMode::ThreadSafe>(static_cast<int64>(ImageCacheSizeMB) * 1024 * 1024);
+                }
 
-            bIsQueryTaskRunning = true;
-            switch (TaskData.QueryType)
+                StartAsyncTask<SelectMySQLImageAsyncTask>(
+                    this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries[0], ImageCacheSizeMB > 0 ? ImageCache : nullptr);
+            }
+            break;
+        case EQueryType::KeepAlive:
+            {
+                StartAsyncTask<KeepAliveMySQLConnectionTask>(this, CurrentConnector, TaskData.ConnectionID);
+            }
+            break;
+        case EQueryType::Close:
             {
-            case EQueryType::Update:
+                CurrentConnector->CloseConnection(TaskData.ConnectionID);
+                SQLConnectors.Remove(TaskData.ConnectionID);
+                ConnectionToLastQueryIDMap.Remove(TaskData.ConnectionID);
+
+                // Queries queued behind the close never run
+                TArray<FQueryTaskData> Abandoned = MoveTemp(Queue->Pending);
+                ConnectionQueues.Remove(TaskData.ConnectionID);
+                Queue = nullptr;
+                for (FQueryTaskData& AbandonedTask : Abandoned)
                 {
-                    FAsyncTask<UpdateMySQLQueryAsyncTask>* UpdateQueryTask = StartAsyncTask<UpdateMySQLQueryAsyncTask>(this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries);
-                    if(UpdateQueryTask == nullptr)
-                    {
-                        UE_LOG(LogTemp, Warning, TEXT("UpdateQueryTask is null"));
-                        return;
-                    }
-                    UpdateQueryTasks.Add(UpdateQueryTask);
+                    AbandonQueryTask(AbandonedTask);
                 }
-                break;
-            case EQueryType::Select:
+            }
+            break;
+        case EQueryType::Session:
+            {
+                // Stays in flight until the session is released
+                SessionLeases.RemoveAllSwap([](const TWeakPtr<FMySQLSessionLease, ESPMode::ThreadSafe>& Lease) { return !Lease.IsValid(); });
+                FMySQLSessionLeasePtr Lease = MakeShared<FMySQLSessionLease, ESPMode::ThreadSafe>(CurrentConnector);
+                SessionLeases.Add(Lease);
+                TaskData.OnSessionGranted(FMySQLSession(this, Lease, TaskData.ConnectionID, TaskData.QueryID));
+            }
+            break;
+        case EQueryType::Endplay:
+            {
+                TMap<int32, FMySQLConnectionQueue> Abandoned = MoveTemp(ConnectionQueues);
+                ConnectionQueues.Empty();
+                for (auto& Entry : Abandoned)
                 {
-                    FAsyncTask<SelectMySQLQueryAsyncTask>* SelectQueryTask = StartAsyncTask<SelectMySQLQueryAsyncTask>(this, CurrentConnector, TaskData.ConnectionID, TaskData.QueryID, TaskData.Queries[0]);
-                    if(SelectQueryTask == nullptr)
+                    for (FQueryTaskData& AbandonedTask : Entry.Value.Pending)
                     {
-                        UE_LOG(LogTemp, Warning, TEXT("SelectQueryTask is null"));
-                        return;
+                        AbandonQueryTask(AbandonedTask);
                     }
-                    SelectQueryTasks.Add(SelectQueryTask);
-                }
-                break;
-            case EQueryType::Close:
-                {
-                    CurrentConnector->CloseConnection(TaskData.ConnectionID);
-                    SQLConnectors.Remove(TaskData.ConnectionID);
-                    ConnectionToNextQueryIDMap.Remove(TaskData.ConnectionID);
-                    bIsQueryTaskRunning = false;
                 }
-                break;
-            case EQueryType::Endplay:
-                {
-                    QueryTaskQueue.Empty();
-                    CloseAllConnections();
-                    Super::EndPlay(EEndPlayReason::Type::Quit);
-                }
-                break;
-            default:
-                break;
+                CloseAllConnections();
+                Super::EndPlay(EEndPlayReason::Type::Quit);
+                return;
             }
-            QueryTaskQueue.RemoveAt(QueryTaskQueue.Num() - 1);
+        default:
+            Queue->bInFlight = false;
+            break;
         }
-        else
+    }
+}
+
+void AMySQLDBConnectionActor::AbandonQueryTask(FQueryTaskData& TaskData)
+{
+    if (TaskData.OnSessionGranted)
+    {
+        TaskData.OnSessionGranted(FMySQLSession());
+    }
+    if (TaskData.QueryID >= 0)
+    {
+        OnQueryResultDelivered(TaskData.QueryID, false);
+    }
+}
+
+void AMySQLDBConnectionActor::OnQueryTaskCompleted(int32 ConnectionID)
+{
+    if (FMySQLConnectionQueue* Queue = ConnectionQueues.Find(ConnectionID))
+    {
+        Queue->bInFlight = false;
+        Queue->Completed++;
+        Queue->LastActivityTime = FPlatformTime::Seconds();
+    }
+    DispatchQueryTask(ConnectionID);
+}
+
+void AMySQLDBConnectionActor::OnKeepAliveCompleted(int32 ConnectionID, bool bIsAlive, const FString& ErrorMessage)
+{
+    if (!bIsAlive)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Keepalive failed for connection %d: %s"), ConnectionID, *ErrorMessage);
+    }
+
+    if (FMySQLConnectionQueue* Queue = ConnectionQueues.Find(ConnectionID))
+    {
+        Queue->bInFlight = false;
+        Queue->LastActivityTime = FPlatformTime::Seconds();
+    }
+    DispatchQueryTask(ConnectionID);
+}
+
+void AMySQLDBConnectionActor::SendKeepAlives()
+{
+    const double Now = FPlatformTime::Seconds();
+
+    TArray<int32> IdleConnections;
+    for (const auto& Entry : ConnectionQueues)
+    {
+        const FMySQLConnectionQueue& Queue = Entry.Value;
+        if (!Queue.bInFlight && Queue.Pending.Num() == 0 && Now - Queue.LastActivityTime >= KeepAliveIntervalSeconds)
+        {
+            IdleConnections.Add(Entry.Key);
+        }
+    }
+
+    // Enqueue after iterating; dispatching can remove queues
+    for (int32 ConnectionID : IdleConnections)
+    {
+        FQueryTaskData KeepAliveTask;
+        KeepAliveTask.ConnectionID = ConnectionID;
+        KeepAliveTask.QueryID = -1;
+        KeepAliveTask.QueryType = EQueryType::KeepAlive;
+        EnqueueQueryTask(MoveTemp(KeepAliveTask));
+    }
+}
+
+void AMySQLDBConnectionActor::OnConnectionOpened(int32 ConnectionID, bool ConnectionStatus)
+{
+    if (!ConnectionStatus)
+    {
+        ResetConnection(ConnectionID);
+    }
+
+    FMySQLConnectionQueue* Queue = ConnectionQueues.Find(ConnectionID);
+    if (!Queue)
+    {
+        return;
+    }
+
+    // Failed handshake: nothing queued on this connection can ever run
+    if (!ConnectionStatus)
+    {
+        if (Queue->Pending.Num() > 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Connection %d failed to open, failing %d queued queries"), ConnectionID, Queue->Pending.Num());
+        }
+
+        // Removed first, the callbacks below may enqueue again
+        TArray<FQueryTaskData> Abandoned = MoveTemp(Queue->Pending);
+        ConnectionQueues.Remove(ConnectionID);
+        for (FQueryTaskData& AbandonedTask : Abandoned)
+        {
+            AbandonQueryTask(AbandonedTask);
+        }
+        return;
+    }
+
+    Queue->bInFlight = false;
+    Queue->LastActivityTime = FPlatformTime::Seconds();
+    DispatchQueryTask(ConnectionID);
+}
+
+bool AMySQLDBConnectionActor::CheckIsQueryRunning()
+{
+    for (const auto& Entry : ConnectionQueues)
+    {
+        if (Entry.Value.bInFlight || Entry.Value.Pending.Num() > 0)
         {
-            bIsQueryTaskRunning = false;
+            return true;
         }
     }
+    return false;
+}
+
+int32 AMySQLDBConnectionActor::GetPendingQueryCount(int32 ConnectionID) const
+{
+    const FMySQLConnectionQueue* Queue = ConnectionQueues.Find(ConnectionID);
+    return Queue ? Queue->Pending.Num() : 0;
+}
+
+TArray<FMySQLQueueMetrics> AMySQLDBConnectionActor::GetQueueMetrics() const
+{
+    TArray<FMySQLQueueMetrics> Metrics;
+    Metrics.Reserve(ConnectionQueues.Num());
+    for (const auto& Entry : ConnectionQueues)
+    {
+        FMySQLQueueMetrics& Item = Metrics.AddDefaulted_GetRef();
+        Item.ConnectionID = Entry.Key;
+        Item.PendingQueries = Entry.Value.Pending.Num();
+        Item.bQueryInFlight = Entry.Value.bInFlight;
+        Item.PeakPendingQueries = Entry.Value.PeakPending;
+        Item.CompletedQueries = Entry.Value.Completed;
+    }
+    return Metrics;
 }
 
 void AMySQLDBConnectionActor::CreateTaskData(int32 ConnectionID, TArray<FString> Queries, EQueryType QueryType)
 {
-    // Create a struct with the query data and add it to the queue
+    // Create a struct with the query data and add it to the connection's queue
     FQueryTaskData TaskData;
     TaskData.ConnectionID = ConnectionID;
     TaskData.QueryID = GenerateQueryID(ConnectionID);
-    TaskData.Queries = Queries;
+    TaskData.Queries = MoveTemp(Queries);
     TaskData.QueryType = QueryType;
-    QueryTaskQueue.Add(TaskData);
-
-    // If no task is currently running, execute the next task
-    if (!bIsQueryTaskRunning)
-    {
-        ExecuteNextQueryTask();
-    }
+    EnqueueQueryTask(MoveTemp(TaskData));
 }
 
 bool AMySQLDBConnectionActor::HandleQueryExecutionContext(int32 ConnectionID, EQueryExecutionContext ExecutionContext, 
                                                          bool bIsSelectQuery, const FString& Query, 
-                                                         FString& OutErrorMessage)
+                                                         FString& OutErrorMessage,
+                                                         const TArray<FMySQLParam>& Params)
 {
     // Determine if context allows local execution
     bool bCanExecuteLocally = false;
@@ -662,6 +1129,7 @@ bool AMySQLDBConnectionActor::HandleQueryExecutionContext(int32 ConnectionID, EQ
             Request.ConnectionID = ConnectionID;
             Request.QueryString = Query;
             Request.bIsSelectQuery = bIsSelectQuery;
+            Request.Params = Params;
             
             // Send to server
             ServerExecuteQuery(Request);
@@ -695,7 +1163,31 @@ void AMySQLDBConnectionActor::UpdateDataFromQuery(int32 ConnectionID, FString Qu
     CreateTaskData(ConnectionID, Queries, EQueryType::Update);
 }
 
-void AMySQLDBConnectionActor::UpdateDataFromMultipleQueries(int32 ConnectionID, TArray<FString> Queries, EQueryExecutionContext ExecutionContext)
+void AMySQLDBConnectionActor::ExecuteParams(int32 ConnectionID, FString Query, TArray<FMySQLParam> Params, EQueryExecutionContext ExecutionContext)
+{
+    FString ErrorMessage;
+    if (!HandleQueryExecutionContext(ConnectionID, ExecutionContext, false, Query, ErrorMessage, Params))
+    {
+        // If false but no error, it was routed to server
+        if (!ErrorMessage.IsEmpty())
+        {
+            OnQueryUpdateStatusChanged(ConnectionID, -1, false, ErrorMessage);
+        }
+        return;
+    }
+
+    // Execute locally
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries.Add(Query);
+    TaskData.QueryType = EQueryType::Update;
+    TaskData.Params = MoveTemp(Params);
+    EnqueueQueryTask(MoveTemp(TaskData));
+}
+
+void AMySQLDBConnectionActor::UpdateDataFromMultipleQueries(int32 ConnectionID, TArray<FString> Queries, EQueryExecutionContext ExecutionContext,
+    bool UseTransaction)
 {
     FString ErrorMessage;
     bool bHandled = false;
@@ -704,15 +1196,13 @@ void AMySQLDBConnectionActor::UpdateDataFromMultipleQueries(int32 ConnectionID,
     if (!HasAuthority() && (ReplicationMode == EMySQLReplicationMode::ClientToServer || 
                            ExecutionContext == EQueryExecutionContext::ForceServer))
     {
-        // Route each query to server
-        for (const FString& Query : Queries)
-        {
-            FQueryRequest Request;
-            Request.ConnectionID = ConnectionID;
-            Request.QueryString = Query;
-            Request.bIsSelectQuery = false;
-            ServerExecuteQuery(Request);
-        }
+        // Route the whole batch to the server in one request
+        FQueryRequest Request;
+        Request.ConnectionID = ConnectionID;
+        Request.BatchQueries = Queries;
+        Request.bUseTransaction = UseTransaction;
+        Request.bIsSelectQuery = false;
+        ServerExecuteQuery(Request);
         bHandled = true;
     }
     else if (!CanExecuteQueryInCurrentContext())
@@ -733,11 +1223,18 @@ void AMySQLDBConnectionActor::UpdateDataFromMultipleQueries(int32 ConnectionID,
     }
     
     // Execute locally
-    CreateTaskData(ConnectionID, Queries, EQueryType::Update);
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries = MoveTemp(Queries);
+    TaskData.QueryType = EQueryType::Update;
+    TaskData.bUseTransaction = UseTransaction;
+    EnqueueQueryTask(MoveTemp(TaskData));
 }
 
 
-void AMySQLDBConnectionActor::SelectDataFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext)
+void AMySQLDBConnectionActor::SelectDataFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext,
+    EMySQLResultLayout ResultLayout)
 {
     FString ErrorMessage;
     if (!HandleQueryExecutionContext(ConnectionID, ExecutionContext, true, Query, ErrorMessage))
@@ -752,12 +1249,101 @@ void AMySQLDBConnectionActor::SelectDataFromQuery(int32 ConnectionID, FString Qu
     }
     
     // Execute locally
-    TArray<FString> Queries;
-    Queries.Add(Query);
-    CreateTaskData(ConnectionID, Queries, EQueryType::Select);
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries.Add(Query);
+    TaskData.QueryType = EQueryType::Select;
+    TaskData.ResultLayout = ResultLayout;
+    EnqueueQueryTask(MoveTemp(TaskData));
+}
+
+void AMySQLDBConnectionActor::SelectDataStreaming(int32 ConnectionID, FString Query, int32 BatchSize, EMySQLResultLayout ResultLayout)
+{
+    if (!CanExecuteQueryInCurrentContext())
+    {
+        OnQuerySelectStatusChanged(ConnectionID, -1, false, TEXT("Streaming selects can only run where the connection lives"),
+            TArray<FMySQLDataTable>(), TArray<FMySQLDataRow>());
+        return;
+    }
+
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries.Add(Query);
+    TaskData.QueryType = EQueryType::Select;
+    TaskData.ResultLayout = ResultLayout;
+    TaskData.BatchSize = FMath::Max(BatchSize, 1);
+    EnqueueQueryTask(MoveTemp(TaskData));
 }
 
 
+FMySQLSessionAwaitable AMySQLDBConnectionActor::OpenSession(int32 ConnectionID)
+{
+    return FMySQLSessionAwaitable(this, ConnectionID);
+}
+
+void AMySQLDBConnectionActor::EnqueueSession(int32 ConnectionID, TFunction<void(FMySQLSession&&)> OnGranted)
+{
+    if (!CanExecuteQueryInCurrentContext())
+    {
+        // Sessions hold the connection itself, so they only exist where it lives
+        OnGranted(FMySQLSession());
+        return;
+    }
+
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.QueryType = EQueryType::Session;
+    TaskData.OnSessionGranted = MoveTemp(OnGranted);
+    EnqueueQueryTask(MoveTemp(TaskData));
+}
+
+void AMySQLDBConnectionActor::SelectTypedFromQuery(int32 ConnectionID, FString Query, TArray<FMySQLParam> Params)
+{
+    if (!CanExecuteQueryInCurrentContext())
+    {
+        OnQueryTypedSelectStatusChanged(ConnectionID, -1, false, TEXT("Typed selects can only run where the connection lives"), FMySQLTypedResult());
+        return;
+    }
+
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries.Add(Query);
+    TaskData.QueryType = EQueryType::TypedSelect;
+    TaskData.Params = MoveTemp(Params);
+    EnqueueQueryTask(MoveTemp(TaskData));
+}
+
+void AMySQLDBConnectionActor::BulkInsert(int32 ConnectionID, FString Table, TArray<FString> Columns, TArray<FMySQLDataRow> Rows)
+{
+    if (!CanExecuteQueryInCurrentContext())
+    {
+        OnBulkInsertStatusChanged(ConnectionID, -1, false, TEXT("Bulk inserts can only run where the connection lives"), 0);
+        return;
+    }
+
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries.Add(MoveTemp(Table));
+    TaskData.QueryType = EQueryType::BulkInsert;
+    TaskData.Columns = MoveTemp(Columns);
+    TaskData.Rows = MoveTemp(Rows);
+    EnqueueQueryTask(MoveTemp(TaskData));
+}
+
+
+void AMySQLDBConnectionActor::ClearImageCache()
+{
+    if (ImageCache.IsValid())
+    {
+        ImageCache->Empty();
+    }
+}
+
 void AMySQLDBConnectionActor::SelectImageFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext)
 {
     FString ErrorMessage;
@@ -772,17 +1358,17 @@ void AMySQLDBConnectionActor::SelectImageFromQuery(int32 ConnectionID, FString Q
     }
     
     // Execute locally
-    if (UMySQLDBConnector* CurrentConnector = GetConnector(ConnectionID))
+    if (GetConnector(ConnectionID))
     {
-        int32 QueryID = GenerateQueryID(ConnectionID);
-        FAsyncTask<SelectMySQLImageAsyncTask>* SelectImageQueryTask = StartAsyncTask<SelectMySQLImageAsyncTask>(
-            this, CurrentConnector, ConnectionID, QueryID, Query);
-        SelectImageQueryTasks.Add(SelectImageQueryTask);
+        TArray<FString> Queries;
+        Queries.Add(Query);
+        CreateTaskData(ConnectionID, Queries, EQueryType::ImageSelect);
     }
 }
 
 void AMySQLDBConnectionActor::UpdateImageFromPath(int32 ConnectionID, FString Query, FString UpdateParameter, 
-                                                 int ParameterID, FString ImagePath, EQueryExecutionContext ExecutionContext)
+                                                 int ParameterID, FString ImagePath, EQueryExecutionContext ExecutionContext,
+                                                 EMySQLImageEncoding Encoding)
 {
     FString ErrorMessage;
     if (!HandleQueryExecutionContext(ConnectionID, ExecutionContext, false, Query, ErrorMessage))
@@ -797,6 +1383,7 @@ void AMySQLDBConnectionActor::UpdateImageFromPath(int32 ConnectionID, FString Qu
             Request.UpdateParameter = UpdateParameter;
             Request.ParameterID = ParameterID;
             Request.ImagePath = ImagePath;
+            Request.ImageEncoding = Encoding;
             Request.bIsSelectQuery = false;
             Request.bIsImageQuery = true;
             
@@ -810,15 +1397,38 @@ void AMySQLDBConnectionActor::UpdateImageFromPath(int32 ConnectionID, FString Qu
     }
     
     // Execute locally
-    if (UMySQLDBConnector* CurrentConnector = GetConnector(ConnectionID))
+    if (GetConnector(ConnectionID))
     {
-        int32 QueryID = GenerateQueryID(ConnectionID);
-        FAsyncTask<UpdateMySQLImageAsyncTask>* UpdateImageQueryTask = StartAsyncTask<UpdateMySQLImageAsyncTask>(
-            this, CurrentConnector, ConnectionID, QueryID, Query, UpdateParameter, ParameterID, ImagePath);
-        UpdateImageQueryTasks.Add(UpdateImageQueryTask);
+        FQueryTaskData TaskData;
+        TaskData.ConnectionID = ConnectionID;
+        TaskData.QueryID = GenerateQueryID(ConnectionID);
+        TaskData.Queries.Add(Query);
+        TaskData.QueryType = EQueryType::ImageUpdate;
+        TaskData.UpdateParameter = UpdateParameter;
+        TaskData.ParameterID = ParameterID;
+        TaskData.ImagePath = ImagePath;
+        TaskData.ImageEncoding = Encoding;
+        EnqueueQueryTask(MoveTemp(TaskData));
     }
 }
 
+void AMySQLDBConnectionActor::UpdateImageFromBytes(int32 ConnectionID, FString Query, TArray<uint8> ImageData)
+{
+    if (!CanExecuteQueryInCurrentContext() || !GetConnector(ConnectionID))
+    {
+        OnImageUpdateStatusChanged(ConnectionID, -1, false, TEXT("Image uploads from bytes can only run where the connection lives"));
+        return;
+    }
+
+    FQueryTaskData TaskData;
+    TaskData.ConnectionID = ConnectionID;
+    TaskData.QueryID = GenerateQueryID(ConnectionID);
+    TaskData.Queries.Add(Query);
+    TaskData.QueryType = EQueryType::ImageUpdate;
+    TaskData.ImageData = MoveTemp(ImageData);
+    EnqueueQueryTask(MoveTemp(TaskData));
+}
+
 bool AMySQLDBConnectionActor::UpdateImageFromTexture(int32 ConnectionID, FString Query, FString UpdateParameter, 
                                                    int ParameterID, UTexture2D* Texture, EQueryExecutionContext ExecutionContext)
 {
@@ -24,6 +24,9 @@ bool UMySQLDBConnector::CreateNewConnection(int32 ConnectionID, FString Server,
 	{
 		mysqlConnection = new  MySQLConnection();
 	}
+	mysqlConnection->StatementCacheCapacity = FMath::Max(StatementCacheSize, 1);
+	mysqlConnection->IdlePingThresholdSeconds = IdlePingThresholdSeconds;
+	mysqlConnection->Pool = ConnectionPool;
 
 	string serverstring(TCHAR_TO_UTF8(*Server));
 	char* server = _strdup(serverstring.c_str());
@@ -61,7 +64,21 @@ void UMySQLDBConnector::CloseConnection(int32 ConnectionID)
 	
 }
 
-void UMySQLDBConnector::UpdateDataFromQuery(int32 ConnectionID, int32 QueryID, FString Query, bool& IsSuccessful, FString& ErrorMessage)
+bool UMySQLDBConnector::KeepAlive(int32 ConnectionID, FString& ErrorMessage)
+{
+	if (!mysqlConnection)
+	{
+		ErrorMessage = "Connection not Valid";
+		return false;
+	}
+
+	std::string errormessage;
+	const bool bAlive = mysqlConnection->KeepAlive(ConnectionID, errormessage);
+	ErrorMessage = FString(UTF8_TO_TCHAR(errormessage.c_str()));
+	return bAlive;
+}
+
+void UMySQLDBConnector::UpdateDataFromQuery(int32 ConnectionID, int64 QueryID, FString Query, bool& IsSuccessful, FString& ErrorMessage)
 {
 	IsSuccessful= false;
 
@@ -69,23 +86,17 @@ void UMySQLDBConnector::UpdateDataFromQuery(int32 ConnectionID, int32 QueryID, F
 	{
 		if(mysqlConnection && mysqlConnection->IsValidConnection(ConnectionID))
 		{
-		
-			char* query = UMySQLBPLibrary::GetCharfromFString(Query);
-			const char* errormessage = "";
+			std::string query(TCHAR_TO_UTF8(*Query));
+			std::string errormessage;
 	
-			if (mysqlConnection->UpdateDataFromQuery(ConnectionID, query, errormessage))
+			if (mysqlConnection->UpdateDataFromQuery(ConnectionID, query.c_str(), errormessage))
 			{
 				IsSuccessful = true;
 				// Save the query ID and associated connection ID
 				QueryToConnectionMap.Add(QueryID, ConnectionID);
 			}
-			else
-			{
-				ErrorMessage = FString(UTF8_TO_TCHAR(errormessage));
-			}
 	
-			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage));
-		
+			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage.c_str()));
 		}
 		else
 		{
@@ -94,74 +105,269 @@ void UMySQLDBConnector::UpdateDataFromQuery(int32 ConnectionID, int32 QueryID, F
 	}
 }
 
+void UMySQLDBConnector::ExecuteBatch(int32 ConnectionID, int64 QueryID, const TArray<FString>& Queries, bool bUseTransaction,
+	TArray<FMySQLStatementResult>& StatementResults, bool& IsSuccessful, FString& ErrorMessage)
+{
+	IsSuccessful = false;
 
-void UMySQLDBConnector::SelectDataFromQuery(int32 ConnectionID, FString Query, bool& IsSuccessful, FString& ErrorMessage,
-	TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow)
+	if (mysqlConnection && mysqlConnection->IsValidConnection(ConnectionID))
+	{
+		std::vector<std::string> queries;
+		queries.reserve(Queries.Num());
+		for (const FString& Query : Queries)
+		{
+			queries.emplace_back(TCHAR_TO_UTF8(*Query));
+		}
+
+		std::string errormessage;
+		IsSuccessful = mysqlConnection->ExecuteBatch(ConnectionID, queries, bUseTransaction, StatementResults, errormessage);
+		if (IsSuccessful)
+		{
+			QueryToConnectionMap.Add(QueryID, ConnectionID);
+		}
+		ErrorMessage = FString(UTF8_TO_TCHAR(errormessage.c_str()));
+	}
+	else
+	{
+		ErrorMessage = "Connection not Valid";
+	}
+}
+
+void UMySQLDBConnector::ExecuteParams(int32 ConnectionID, int64 QueryID, const FString& Query, const TArray<FMySQLParam>& Params,
+	bool& IsSuccessful, FString& ErrorMessage)
 {
 	IsSuccessful = false;
 
 	if (mysqlConnection && mysqlConnection->IsValidConnection(ConnectionID))
 	{
 		std::string query(TCHAR_TO_UTF8(*Query));
-		std::vector<std::string> ColumnNames;
-		std::vector<std::vector<std::string>> ColumnData;
-		std::string error;
+		std::string errormessage;
 
-		if (mysqlConnection->SelectDataFromQuery(ConnectionID, query.c_str(), ColumnNames, ColumnData, error))
+		if (mysqlConnection->ExecuteParams(ConnectionID, query.c_str(), Params, errormessage))
 		{
 			IsSuccessful = true;
+			QueryToConnectionMap.Add(QueryID, ConnectionID);
+		}
+		else
+		{
+			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage.c_str()));
+		}
+	}
+	else
+	{
+		ErrorMessage = "Connection not Valid";
+	}
+}
+
+void UMySQLDBConnector::SelectDataFromQuery(int32 ConnectionID, FString Query, bool& IsSuccessful, FString& ErrorMessage,
+	TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow, EMySQLResultLayout Layout)
+{
+	SelectDataStreaming(ConnectionID, Query, 0, Layout,
+		[&ResultByColumn, &ResultByRow](TArray<FMySQLDataTable>& BatchByColumn, TArray<FMySQLDataRow>& BatchByRow)
+		{
+			ResultByColumn = MoveTemp(BatchByColumn);
+			ResultByRow = MoveTemp(BatchByRow);
+		},
+		IsSuccessful, ErrorMessage);
+}
+
+void UMySQLDBConnector::SelectDataStreaming(int32 ConnectionID, const FString& Query, int32 BatchSize, EMySQLResultLayout Layout,
+	TFunctionRef<void(TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow)> OnBatch,
+	bool& IsSuccessful, FString& ErrorMessage)
+{
+	IsSuccessful = false;
+
+	if (!mysqlConnection || !mysqlConnection->IsValidConnection(ConnectionID))
+	{
+		ErrorMessage = "Connection not Valid";
+		return;
+	}
+
+	const bool bByColumn = Layout != EMySQLResultLayout::RowsOnly;
+	const bool bByRow = Layout != EMySQLResultLayout::ColumnsOnly;
 
-			for (const auto& ColumnName : ColumnNames)
+	TArray<FString> ColumnNames;
+	TArray<FMySQLDataTable> ResultByColumn;
+	TArray<FMySQLDataRow> ResultByRow;
+	int32 RowsInBatch = 0;
+	int32 BatchesSent = 0;
+
+	auto ResetBatch = [&]()
+	{
+		ResultByColumn.Reset();
+		ResultByRow.Reset();
+		if (bByColumn)
+		{
+			for (const FString& ColumnName : ColumnNames)
 			{
-				FMySQLDataTable NewDataTable;
-				NewDataTable.ColumnName = FString(ColumnName.c_str());
-				ResultByColumn.Add(NewDataTable);
+				FMySQLDataTable& Column = ResultByColumn.AddDefaulted_GetRef();
+				Column.ColumnName = ColumnName;
+				Column.ColumnData.Reserve(BatchSize);
 			}
+		}
+		if (bByRow)
+		{
+			ResultByRow.Reserve(BatchSize);
+		}
+		RowsInBatch = 0;
+	};
 
-			for (const auto& rowdata : ColumnData)
+	auto SendBatch = [&]()
+	{
+		OnBatch(ResultByColumn, ResultByRow);
+		BatchesSent++;
+		ResetBatch();
+	};
+
+	std::string query(TCHAR_TO_UTF8(*Query));
+	std::string error;
+
+	const bool bStatus = mysqlConnection->SelectDataStreaming(ConnectionID, query.c_str(),
+		[&](const MYSQL_FIELD* Fields, unsigned int NumFields)
+		{
+			for (unsigned int iIndex = 0; iIndex < NumFields; iIndex++)
 			{
-				FMySQLDataRow Row;
+				ColumnNames.Add(UTF8_TO_TCHAR(Fields[iIndex].name));
+			}
+			ResetBatch();
+		},
+		[&](MYSQL_ROW Row, const unsigned long* Lengths, unsigned int NumFields)
+		{
+			FMySQLDataRow* RowData = bByRow ? &ResultByRow.AddDefaulted_GetRef() : nullptr;
+			if (RowData)
+			{
+				RowData->RowData.Reserve(NumFields);
+			}
 
-				for (const auto& cdata : rowdata)
+			for (unsigned int iIndex = 0; iIndex < NumFields; iIndex++)
+			{
+				// Converted once, straight from the network buffer
+				FString Cell;
+				if (Row[iIndex])
+				{
+					const FUTF8ToTCHAR Converted(Row[iIndex], static_cast<int32>(Lengths[iIndex]));
+					Cell = FString(Converted.Length(), Converted.Get());
+				}
+				else
 				{
-					int32 CIndex = &cdata - &rowdata[0];
-					if (ResultByColumn.Num() > CIndex)
-					{
-						ResultByColumn[CIndex].ColumnData.Add(FString(cdata.c_str()));
-					}
-					Row.RowData.Add(FString(cdata.c_str()));
+					Cell = TEXT("NULL");
 				}
 
-				ResultByRow.Add(Row);
+				if (bByColumn && bByRow)
+				{
+					ResultByColumn[iIndex].ColumnData.Add(Cell);
+					RowData->RowData.Add(MoveTemp(Cell));
+				}
+				else if (bByColumn)
+				{
+					ResultByColumn[iIndex].ColumnData.Add(MoveTemp(Cell));
+				}
+				else
+				{
+					RowData->RowData.Add(MoveTemp(Cell));
+				}
 			}
+
+			if (BatchSize > 0 && ++RowsInBatch >= BatchSize)
+			{
+				SendBatch();
+			}
+		},
+		error);
+
+	if (!bStatus)
+	{
+		ErrorMessage = FString(UTF8_TO_TCHAR(error.c_str()));
+		return;
+	}
+
+	// Trailing rows; an empty result still delivers one batch carrying the column names
+	if (RowsInBatch > 0 || BatchesSent == 0)
+	{
+		SendBatch();
+	}
+	IsSuccessful = true;
+}
+
+void UMySQLDBConnector::BulkInsert(int32 ConnectionID, int64 QueryID, const FString& Table, const TArray<FString>& Columns,
+	const TArray<FMySQLDataRow>& Rows, int64& InsertedRows, bool& IsSuccessful, FString& ErrorMessage)
+{
+	IsSuccessful = false;
+	InsertedRows = 0;
+
+	if (mysqlConnection && mysqlConnection->IsValidConnection(ConnectionID))
+	{
+		std::vector<std::string> columns;
+		columns.reserve(Columns.Num());
+		for (const FString& Column : Columns)
+		{
+			columns.emplace_back(TCHAR_TO_UTF8(*Column));
+		}
+
+		std::string error;
+		if (mysqlConnection->BulkInsert(ConnectionID, TCHAR_TO_UTF8(*Table), columns, Rows, LoadDataRowThreshold, InsertedRows, error))
+		{
+			IsSuccessful = true;
+			QueryToConnectionMap.Add(QueryID, ConnectionID);
 		}
 		else
 		{
-			ErrorMessage = FString(error.c_str());
+			ErrorMessage = FString(UTF8_TO_TCHAR(error.c_str()));
 		}
 	}
 	else
 	{
 		ErrorMessage = "Connection not Valid";
 	}
+}
 
+void UMySQLDBConnector::SelectTyped(int32 ConnectionID, const FString& Query, const TArray<FMySQLParam>& Params,
+	FMySQLTypedResult& Result, bool& IsSuccessful, FString& ErrorMessage)
+{
+	IsSuccessful = false;
+
+	if (mysqlConnection && mysqlConnection->IsValidConnection(ConnectionID))
+	{
+		std::string query(TCHAR_TO_UTF8(*Query));
+		std::string error;
+
+		if (mysqlConnection->SelectTyped(ConnectionID, query.c_str(), Params, Result, error))
+		{
+			IsSuccessful = true;
+		}
+		else
+		{
+			ErrorMessage = FString(UTF8_TO_TCHAR(error.c_str()));
+		}
+	}
+	else
+	{
+		ErrorMessage = "Connection not Valid";
+	}
 }
 
-void UMySQLDBConnector::UpdateImageFromPath(int32 ConnectionID, int32 QueryID, FString Query,
-	FString UpdateParameter, int ParameterID, FString ImagePath, bool& IsSuccessful, FString& ErrorMessage)
+void UMySQLDBConnector::UpdateImageFromPath(int32 ConnectionID, int64 QueryID, FString Query,
+	FString UpdateParameter, int ParameterID, FString ImagePath, bool& IsSuccessful, FString& ErrorMessage, EMySQLImageEncoding Encoding)
 {
+	IsSuccessful = false;
+
+	TArray<uint8> ImageData;
+	if (UMySQLBPLibrary::GetImageBytesFromPath(ImagePath, Encoding, ImageData, ErrorMessage))
+	{
+		UpdateImageFromData(ConnectionID, QueryID, Query, ImageData, IsSuccessful, ErrorMessage);
+	}
+}
 
+void UMySQLDBConnector::UpdateImageFromData(int32 ConnectionID, int64 QueryID, const FString& Query, const TArray<uint8>& ImageData,
+	bool& IsSuccessful, FString& ErrorMessage)
+{
 	IsSuccessful = false;
 	if(mysqlConnection)
 	{
 		string query(TCHAR_TO_UTF8(*Query));
-		char* querychar = _strdup(query.c_str());
+		std::string errormessage;
 
-		char* ImageChar = UMySQLBPLibrary::GetRawImageFromPath(ImagePath);
-
-		const char* errormessage = "";
-
-		if (mysqlConnection->UpdateImageFromPath(ConnectionID, querychar, ImageChar, errormessage))
+		if (mysqlConnection->UpdateImageFromData(ConnectionID, query.c_str(), ImageData, errormessage))
 		{
 			IsSuccessful = true;
 			
@@ -170,53 +376,38 @@ void UMySQLDBConnector::UpdateImageFromPath(int32 ConnectionID, int32 QueryID, F
 		}
 		else
 		{
-			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage));
+			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage.c_str()));
 		}
-		
-		
 	}
 	else
 	{
 		ErrorMessage = "Connection not Valid";
 	}
-	
 }
 
-UTexture2D* UMySQLDBConnector::SelectImageFromQuery(int32 ConnectionID, int32 QueryID, FString Query,
+void UMySQLDBConnector::SelectImageFromQuery(int32 ConnectionID, int64 QueryID, FString Query, TArray<uint8>& ImageData,
 	bool& IsSuccessful, FString& ErrorMessage)
 {
-
-	UTexture2D* ImageTexture = nullptr;
 	IsSuccessful = false;
 
 	if(mysqlConnection)
 	{
 		string query(TCHAR_TO_UTF8(*Query));
-		char* querychar = _strdup(query.c_str());
-
-		char* ichar = nullptr;
-		const char* errormessage = "";
-		if(mysqlConnection->SelectImageFromQuery(ConnectionID, querychar, ichar,
-		                                         errormessage))
+		std::string errormessage;
+		if(mysqlConnection->SelectImageFromQuery(ConnectionID, query.c_str(), ImageData, errormessage))
 		{
 			IsSuccessful = true;
 			// Save the query ID and associated connection ID
 			QueryToConnectionMap.Add(QueryID, ConnectionID);
-			
-			char* ImageChar = const_cast<char*>(ichar);
-			ImageTexture = UMySQLBPLibrary::LoadTexturefromCharData(ImageChar);
 		}
 		else
 		{
-			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage));
+			ErrorMessage = FString(UTF8_TO_TCHAR(errormessage.c_str()));
 		}
 	}
 	else
 	{
 		ErrorMessage = "Connection not Valid";
 	}
-	
-	return ImageTexture;
-
 }
 
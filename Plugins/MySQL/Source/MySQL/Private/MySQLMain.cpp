@@ -4,6 +4,7 @@
 
 #define WIN32_LEAN_AND_MEAN
 #include <algorithm>
+#include <cctype>
 #include <windows.h>
 #include <sstream> 
 #include <string>
@@ -12,6 +13,8 @@
 #include <codecvt>
 #include <map>
 #include <mutex>
+#include <mysql/errmsg.h>
+#include <mysql/mysqld_error.h>
 
 std::wstring s2ws(const std::string& str) {
 	int slength = static_cast<int>(str.length()) + 1;
@@ -21,13 +24,87 @@ std::wstring s2ws(const std::string& str) {
 	return basic_string<wchar_t, char_traits<wchar_t>, allocator<wchar_t>>(buf.begin(), buf.end());
 }
 
+MYSQL_STMT* FMySQLStatementCache::Find(const string& Sql)
+{
+	auto It = Index.find(Sql);
+	if (It == Index.end())
+	{
+		return nullptr;
+	}
+	Entries.splice(Entries.begin(), Entries, It->second);
+	return It->second->second;
+}
+
+void FMySQLStatementCache::Add(const string& Sql, MYSQL_STMT* Stmt, size_t Capacity)
+{
+	Remove(Sql);
+	Entries.emplace_front(Sql, Stmt);
+	Index[Sql] = Entries.begin();
+
+	while (Entries.size() > Capacity && !Entries.empty())
+	{
+		mysql_stmt_close(Entries.back().second);
+		Index.erase(Entries.back().first);
+		Entries.pop_back();
+	}
+}
+
+void FMySQLStatementCache::Remove(const string& Sql)
+{
+	auto It = Index.find(Sql);
+	if (It != Index.end())
+	{
+		mysql_stmt_close(It->second->second);
+		Entries.erase(It->second);
+		Index.erase(It);
+	}
+}
+
+void FMySQLStatementCache::Clear()
+{
+	for (auto& Entry : Entries)
+	{
+		mysql_stmt_close(Entry.second);
+	}
+	Entries.clear();
+	Index.clear();
+}
+
 void MySQLConnection::CloseConnection(int ConnectionID)
 {
+	ReleaseHandle(ConnectionID);
+
+	// Forget the settings so an explicitly closed connection is never re-established
+	if (ConnectionID < ConnectSettings.size())
+	{
+		ConnectSettings[ConnectionID] = FMySQLConnectSettings();
+	}
+}
+
+void MySQLConnection::ReleaseHandle(int ConnectionID, bool bIsBroken)
+{
+	if (ConnectionID < StatementCaches.size())
+	{
+		// Statements belong to the handle and must be closed before it
+		StatementCaches[ConnectionID].Clear();
+	}
+
 	if (ConnectionID < DBConnections.size())
 	{
 		if (MYSQL* CurrentDBConnection = DBConnections[ConnectionID])
 		{
-			mysql_close(CurrentDBConnection);  // Close the connection
+			if (!Pool)
+			{
+				mysql_close(CurrentDBConnection);  // Close the connection
+			}
+			else if (bIsBroken)
+			{
+				Pool->Discard(CurrentDBConnection);
+			}
+			else
+			{
+				Pool->Release(CurrentDBConnection);
+			}
 			DBConnections[ConnectionID] = nullptr;  // Nullify the pointer in the vector for safety
 		}
 	}
@@ -45,18 +122,33 @@ MYSQL* MySQLConnection::GetDBConnection(int ConnectionID)
 {
 	if (ConnectionID < DBConnections.size())
 	{
+		// A previous reconnect failed; try again while the settings are still known
+		if (!DBConnections[ConnectionID])
+		{
+			string ErrorMessage;
+			return Reconnect(ConnectionID, ErrorMessage) ? DBConnections[ConnectionID] : nullptr;
+		}
+
 		if (MYSQL* CurrentDBConnection = DBConnections[ConnectionID])
 		{
-			// Check if the connection is down (mysql_ping returns non-zero when the connection is down)
-			if (mysql_ping(CurrentDBConnection) != 0)
+			// Recently used handles are trusted; if the server dropped one anyway the query
+			// fails with a lost-connection error and is retried after Reconnect
+			if (!IsIdle(ConnectionID))
 			{
-				// Try to reconnect (using mysql_ping as an example, replace with mariadb_reconnect if that's valid)
-				if (mysql_ping(CurrentDBConnection) != 0)  // Check again after trying to reconnect
-					{
-						return nullptr;  // If still down after reconnect attempt, return nullptr
-					}
+				return CurrentDBConnection;
+			}
+
+			if (mysql_ping(CurrentDBConnection) == 0)
+			{
+				MarkActive(ConnectionID);
+				return CurrentDBConnection;
+			}
+
+			string ErrorMessage;
+			if (Reconnect(ConnectionID, ErrorMessage))
+			{
+				return DBConnections[ConnectionID];
 			}
-			return CurrentDBConnection;
 		}
 	}
 	return nullptr;
@@ -65,14 +157,149 @@ MYSQL* MySQLConnection::GetDBConnection(int ConnectionID)
 
 bool MySQLConnection::IsValidConnection(int ConnectionID)
 {
-	if (GetDBConnection(ConnectionID))
+	// Only checks that a handle exists; liveness is handled by GetDBConnection
+	return ConnectionID < DBConnections.size() && DBConnections[ConnectionID] != nullptr;
+}
+
+void MySQLConnection::MarkActive(int ConnectionID)
+{
+	if (ConnectionID < LastActivity.size())
+	{
+		LastActivity[ConnectionID] = chrono::steady_clock::now();
+	}
+}
+
+bool MySQLConnection::IsIdle(int ConnectionID) const
+{
+	if (IdlePingThresholdSeconds <= 0.0 || ConnectionID >= LastActivity.size())
 	{
 		return true;
 	}
-	else
+	const chrono::duration<double> Idle = chrono::steady_clock::now() - LastActivity[ConnectionID];
+	return Idle.count() >= IdlePingThresholdSeconds;
+}
+
+bool MySQLConnection::IsConnectionLostError(unsigned int ErrorCode)
+{
+	return ErrorCode == CR_SERVER_GONE_ERROR || ErrorCode == CR_SERVER_LOST;
+}
+
+bool MySQLConnection::Reconnect(int ConnectionID, string& ErrorMessage)
+{
+	if (ConnectionID >= ConnectSettings.size() || ConnectSettings[ConnectionID].Server.empty())
+	{
+		ErrorMessage = "Connection Not Found";
+		return false;
+	}
+
+	// Only called once the handle is known to be dead, so never hand it back to a pool
+	ReleaseHandle(ConnectionID, true);
+
+	MYSQL* NewHandle = Pool ? Pool->Acquire(ErrorMessage) : ConnectHandle(ConnectSettings[ConnectionID], ErrorMessage);
+	if (!NewHandle)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MySQL connection %d could not be re-established: %s"), ConnectionID, UTF8_TO_TCHAR(ErrorMessage.c_str()));
+		return false;
+	}
+
+	DBConnections[ConnectionID] = NewHandle;
+	MarkActive(ConnectionID);
+	UE_LOG(LogTemp, Log, TEXT("MySQL connection %d re-established"), ConnectionID);
+	return true;
+}
+
+bool MySQLConnection::KeepAlive(int ConnectionID, string& ErrorMessage)
+{
+	MYSQL* CurrentDBConnection = ConnectionID < DBConnections.size() ? DBConnections[ConnectionID] : nullptr;
+	if (CurrentDBConnection && mysql_ping(CurrentDBConnection) == 0)
+	{
+		MarkActive(ConnectionID);
+		return true;
+	}
+	return Reconnect(ConnectionID, ErrorMessage);
+}
+
+// True when Sql starts with a keyword that only reads (SELECT, SHOW, DESCRIBE, EXPLAIN), so re-running it after a
+// dropped connection can't apply anything twice. Leading comments, WITH (which may end in a write) and
+// SELECT ... INTO count as writes.
+static bool IsReadOnlyQuery(const string& Sql)
+{
+	size_t Start = 0;
+	while (Start < Sql.size() && (isspace(static_cast<unsigned char>(Sql[Start])) || Sql[Start] == '('))
+	{
+		Start++;
+	}
+
+	string Upper;
+	Upper.reserve(Sql.size() - Start);
+	for (size_t iIndex = Start; iIndex < Sql.size(); iIndex++)
+	{
+		Upper += static_cast<char>(toupper(static_cast<unsigned char>(Sql[iIndex])));
+	}
+
+	const auto StartsWithWord = [&Upper](const char* Word)
+	{
+		const size_t Len = strlen(Word);
+		return Upper.compare(0, Len, Word) == 0 && (Upper.size() == Len || !isalnum(static_cast<unsigned char>(Upper[Len])));
+	};
+
+	if (StartsWithWord("SHOW") || StartsWithWord("DESCRIBE") || StartsWithWord("DESC") || StartsWithWord("EXPLAIN"))
+	{
+		return true;
+	}
+
+	if (!StartsWithWord("SELECT"))
 	{
 		return false;
 	}
+
+	// INTO is reserved, so outside of quoted text it can only be SELECT ... INTO; a quoted one just costs the retry
+	for (size_t Found = Upper.find("INTO"); Found != string::npos; Found = Upper.find("INTO", Found + 1))
+	{
+		const bool bWordStart = Found == 0 || !(isalnum(static_cast<unsigned char>(Upper[Found - 1])) || Upper[Found - 1] == '_');
+		const bool bWordEnd = Found + 4 == Upper.size() || !(isalnum(static_cast<unsigned char>(Upper[Found + 4])) || Upper[Found + 4] == '_');
+		if (bWordStart && bWordEnd)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+MYSQL* MySQLConnection::RunQuery(int ConnectionID, const char* Query, string& ErrorMessage)
+{
+	MYSQL* CurrentDBConnection = GetDBConnection(ConnectionID);
+	if (!CurrentDBConnection)
+	{
+		ErrorMessage = "Connection Not Found";
+		return nullptr;
+	}
+
+	if (mysql_query(CurrentDBConnection, Query) == 0)
+	{
+		MarkActive(ConnectionID);
+		return CurrentDBConnection;
+	}
+
+	// Re-running after a dropped connection is only safe for reads, or when the server never got the query
+	const unsigned int ErrorCode = mysql_errno(CurrentDBConnection);
+	ErrorMessage = mysql_error(CurrentDBConnection);
+	string ReconnectError;
+	if (!IsConnectionLostError(ErrorCode) || !Reconnect(ConnectionID, ReconnectError)
+		|| (ErrorCode != CR_SERVER_GONE_ERROR && !IsReadOnlyQuery(Query)))
+	{
+		return nullptr;
+	}
+
+	CurrentDBConnection = DBConnections[ConnectionID];
+	if (mysql_query(CurrentDBConnection, Query))
+	{
+		ErrorMessage = mysql_error(CurrentDBConnection);
+		return nullptr;
+	}
+
+	MarkActive(ConnectionID);
+	return CurrentDBConnection;
 }
 
 unsigned int get_mysql_option(const std::string& key)
@@ -147,209 +374,1057 @@ void MySQLConnection::SetMySQLBulkOptions(MYSQL* MySQLHandle, const TArray<FMySQ
 }
 
 
+// Answers every LOAD DATA LOCAL INFILE request with an error. Installed on each handle outside BulkInsert, so a
+// hostile server cannot use the negotiated capability to request files from disk.
+struct FMySQLInfileRefusal
+{
+	static int Init(void** Ptr, const char* FileName, void* UserData)
+	{
+		return 1;
+	}
+
+	static int Read(void* Ptr, char* Buffer, unsigned int BufferLength)
+	{
+		return -1;
+	}
+
+	static void End(void* Ptr)
+	{
+	}
+
+	static int Error(void* Ptr, char* Message, unsigned int MessageLength)
+	{
+		snprintf(Message, MessageLength, "LOAD DATA LOCAL INFILE is only allowed from BulkInsert");
+		return CR_UNKNOWN_ERROR;
+	}
+
+	static void Install(MYSQL* Handle)
+	{
+		mysql_set_local_infile_handler(Handle, &Init, &Read, &End, &Error, nullptr);
+	}
+};
+
+MYSQL* MySQLConnection::ConnectHandle(const FMySQLConnectSettings& Settings, string& ErrorMessage)
+{
+	MYSQL* CurrentDBConnection = mysql_init(nullptr);
+	if (!CurrentDBConnection)
+	{
+		ErrorMessage = "Failed to initialize MySQL connection.";
+		return nullptr;
+	}
+
+	SetMySQLBulkOptions(CurrentDBConnection, Settings.Options);
+
+	// CLIENT_LOCAL_FILES is only negotiated by mysql_real_connect, BulkInsert's LOAD DATA needs it
+	unsigned int bLocalInfile = 1;
+	mysql_options(CurrentDBConnection, MYSQL_OPT_LOCAL_INFILE, &bLocalInfile);
+	FMySQLInfileRefusal::Install(CurrentDBConnection);
+
+	mysql_ssl_set(CurrentDBConnection, NULL, NULL, NULL, NULL, NULL);
+
+	if (!mysql_real_connect(CurrentDBConnection, Settings.Server.c_str(), Settings.UserID.c_str(), Settings.Password.c_str(),
+		Settings.DBName.c_str(), Settings.Port, NULL, 0))
+	{
+		ErrorMessage = mysql_error(CurrentDBConnection);
+		mysql_close(CurrentDBConnection);
+		return nullptr;
+	}
+
+	// Once per handle rather than before every select
+	mysql_set_character_set(CurrentDBConnection, "utf8mb4");
+	return CurrentDBConnection;
+}
+
 bool MySQLConnection::CreateConnection(int ConnectionID, char* Server, char* DBName, char* UserID, char* Password, int Port,  TArray<FMySQLOptionPair> Options, const char*& ErrorMessage)
 {
     try
     {
-        if (MYSQL* CurrentDBConnection = GetDBConnection(ConnectionID))
-    	{
-    		CloseConnection(ConnectionID);
-    	}
-
-    	MYSQL* CurrentDBConnection = mysql_init(nullptr);
-    	if (!CurrentDBConnection)
-    	{
-    		ErrorMessage = "Failed to initialize MySQL connection.";
-    		return false;
-    	}
+    	CloseConnection(ConnectionID);
 
-   
-      	SetMySQLBulkOptions(CurrentDBConnection, Options);
+    	FMySQLConnectSettings Settings;
+    	Settings.Server = Server;
+    	Settings.DBName = DBName;
+    	Settings.UserID = UserID;
+    	Settings.Password = Password;
+    	Settings.Port = Port;
+    	Settings.Options = MoveTemp(Options);
 
-      	mysql_ssl_set(CurrentDBConnection, NULL, NULL, NULL, NULL, NULL);
-
-		if (!mysql_real_connect(CurrentDBConnection, Server, UserID, Password, DBName, Port, NULL, 0))
+    	MYSQL* CurrentDBConnection = Pool ? Pool->Acquire(LastConnectError) : ConnectHandle(Settings, LastConnectError);
+    	if (!CurrentDBConnection)
     	{
-    		ErrorMessage = mysql_error(CurrentDBConnection);
-    		mysql_close(CurrentDBConnection);
+    		ErrorMessage = LastConnectError.c_str();
     		return false;
     	}
     	
+    	// Index by ConnectionID so handles for different connections never alias
     	if (DBConnections.size() <= ConnectionID)
     	{
-    		DBConnections.push_back(CurrentDBConnection);
-    	}
-    	else
-    	{
-    		DBConnections[ConnectionID] = CurrentDBConnection;
+    		DBConnections.resize(ConnectionID + 1, nullptr);
+    		StatementCaches.resize(ConnectionID + 1);
+    		ConnectSettings.resize(ConnectionID + 1);
+    		LastActivity.resize(ConnectionID + 1);
     	}
+    	DBConnections[ConnectionID] = CurrentDBConnection;
+    	ConnectSettings[ConnectionID] = MoveTemp(Settings);
+    	MarkActive(ConnectionID);
 
     	return true;
     }
     catch (const std::exception& ex)
     {
-        ErrorMessage = ex.what();
+        LastConnectError = ex.what();
+        ErrorMessage = LastConnectError.c_str();
         CloseConnection(ConnectionID);
         return false;
     }
 }
 
-bool MySQLConnection::UpdateDataFromQuery(int ConnectionID, char* Query, const char*& ErrorMessage)
+MYSQL_STMT* MySQLConnection::GetPreparedStatement(int ConnectionID, MYSQL* Handle, const string& Sql, string& ErrorMessage, unsigned int& ErrorCode)
 {
-	if (MYSQL* CurrentDBConnection = GetDBConnection(ConnectionID))
-	{
-		try
-		{
-			MYSQL_STMT* stmt = mysql_stmt_init(CurrentDBConnection);
-			if (!stmt)
-			{
-				ErrorMessage = "Failed to initialize statement";
-				return false;
-			}
+	ErrorCode = 0;
 
-			if (mysql_stmt_prepare(stmt, Query, strlen(Query)))
-			{
-				ErrorMessage = mysql_stmt_error(stmt);
-				mysql_stmt_close(stmt);
-				return false;
-			}
+	if (StatementCaches.size() <= ConnectionID)
+	{
+		StatementCaches.resize(ConnectionID + 1);
+	}
 
-			if (mysql_stmt_execute(stmt))
-			{
-				ErrorMessage = mysql_stmt_error(stmt);
-				mysql_stmt_close(stmt);
-				return false;
-			}
+	FMySQLStatementCache& Cache = StatementCaches[ConnectionID];
+	if (MYSQL_STMT* Cached = Cache.Find(Sql))
+	{
+		return Cached;
+	}
 
-			mysql_stmt_close(stmt);
-			return true;
-		}
-		catch (const std::exception& ex)
-		{
-			ErrorMessage = ex.what();
-		}
+	MYSQL_STMT* stmt = mysql_stmt_init(Handle);
+	if (!stmt)
+	{
+		ErrorMessage = "Failed to initialize statement";
+		return nullptr;
 	}
-	else
+
+	if (mysql_stmt_prepare(stmt, Sql.c_str(), Sql.size()))
 	{
-		ErrorMessage = "Connection Not Found";
+		ErrorCode = mysql_stmt_errno(stmt);
+		ErrorMessage = mysql_stmt_error(stmt);
+		mysql_stmt_close(stmt);
+		return nullptr;
 	}
-	return false;
+
+	Cache.Add(Sql, stmt, StatementCacheCapacity);
+	return stmt;
 }
 
-bool MySQLConnection::SelectDataFromQuery(int ConnectionID, const char* Query, std::vector<std::string>& ColumnNames,
-	std::vector<std::vector<std::string>>& ColumnData, std::string& ErrorMessage)
+// Errors after which a cached statement handle is unusable but a fresh prepare may succeed
+static bool IsStaleStatementError(unsigned int ErrorCode)
 {
-	bool bStatus = false;
+	return ErrorCode == CR_SERVER_GONE_ERROR
+		|| ErrorCode == CR_SERVER_LOST
+		|| ErrorCode == ER_UNKNOWN_STMT_HANDLER
+		|| ErrorCode == ER_NEED_REPREPARE;
+}
+
+bool MySQLConnection::UpdateDataFromQuery(int ConnectionID, const char* Query, string& ErrorMessage)
+{
+	// One-off query text goes over the text protocol; only ExecuteParams and SelectTyped statements, which are
+	// prepared on purpose, take a slot in the statement cache
 	MYSQL* CurrentDBConnection = GetDBConnection(ConnectionID);
 	if (!CurrentDBConnection)
 	{
 		ErrorMessage = "Connection Not Found";
-		return bStatus;
+		return false;
 	}
 
-	// Set character set to utf8mb4 before executing query
-	mysql_set_character_set(CurrentDBConnection, "utf8mb4");
-
-	if (mysql_query(CurrentDBConnection, Query))
+	for (int Attempt = 0; mysql_query(CurrentDBConnection, Query); Attempt++)
 	{
+		const unsigned int ErrorCode = mysql_errno(CurrentDBConnection);
 		ErrorMessage = mysql_error(CurrentDBConnection);
-		return bStatus;
-	}
+		if (Attempt > 0 || !IsConnectionLostError(ErrorCode))
+		{
+			return false;
+		}
 
-	MYSQL_RES* result = mysql_store_result(CurrentDBConnection);
-	if (!result)
-	{
-		ErrorMessage = "No result set returned from query.";
-		return bStatus;
+		// The write may already have run unless the request never left (CR_SERVER_GONE_ERROR)
+		string ReconnectError;
+		if (!Reconnect(ConnectionID, ReconnectError) || ErrorCode != CR_SERVER_GONE_ERROR)
+		{
+			return false;
+		}
+		CurrentDBConnection = DBConnections[ConnectionID];
 	}
 
-	int num_fields = mysql_num_fields(result);
-	MYSQL_FIELD* fields = mysql_fetch_fields(result);
-
-	if (ColumnNames.empty())
+	// Drain whatever the statement returned so the handle is ready for the next query
+	do
 	{
-		for (int i = 0; i < num_fields; i++)
+		if (MYSQL_RES* Result = mysql_store_result(CurrentDBConnection))
 		{
-			ColumnNames.push_back(fields[i].name);
+			mysql_free_result(Result);
 		}
 	}
+	while (mysql_next_result(CurrentDBConnection) == 0);
 
-	MYSQL_ROW row = mysql_fetch_row(result);
-	unsigned long* lengths;
-    
-	while (row != nullptr)
+	MarkActive(ConnectionID);
+	return true;
+}
+
+// Input binds for a parameter array. The storage must outlive mysql_stmt_execute.
+struct FMySQLParamBinds
+{
+	vector<MYSQL_BIND> Binds;
+	vector<long long> IntValues;
+	vector<double> FloatValues;
+	vector<string> StringValues;
+	vector<unsigned long> Lengths;
+
+	explicit FMySQLParamBinds(const TArray<FMySQLParam>& Params)
+		: Binds(Params.Num()), IntValues(Params.Num()), FloatValues(Params.Num()), StringValues(Params.Num()), Lengths(Params.Num())
 	{
-		std::vector<std::string> RowData;
-		lengths = mysql_fetch_lengths(result);
-        
-		for (int i = 0; i < num_fields; i++)
+		memset(Binds.data(), 0, sizeof(MYSQL_BIND) * Binds.size());
+
+		for (int iIndex = 0; iIndex < Params.Num(); iIndex++)
 		{
-			if (row[i])
-			{
-				RowData.push_back(std::string(row[i], lengths[i]));
-			}
-			else
+			const FMySQLParam& Param = Params[iIndex];
+			MYSQL_BIND& Bind = Binds[iIndex];
+
+			switch (Param.Type)
 			{
-				RowData.push_back("NULL");
+			case EMySQLParamType::Int:
+			case EMySQLParamType::Bool:
+				IntValues[iIndex] = Param.IntValue;
+				Bind.buffer_type = MYSQL_TYPE_LONGLONG;
+				Bind.buffer = &IntValues[iIndex];
+				break;
+			case EMySQLParamType::Float:
+				FloatValues[iIndex] = Param.FloatValue;
+				Bind.buffer_type = MYSQL_TYPE_DOUBLE;
+				Bind.buffer = &FloatValues[iIndex];
+				break;
+			case EMySQLParamType::String:
+				StringValues[iIndex] = TCHAR_TO_UTF8(*Param.StringValue);
+				Lengths[iIndex] = static_cast<unsigned long>(StringValues[iIndex].size());
+				Bind.buffer_type = MYSQL_TYPE_STRING;
+				Bind.buffer = const_cast<char*>(StringValues[iIndex].data());
+				Bind.buffer_length = Lengths[iIndex];
+				Bind.length = &Lengths[iIndex];
+				break;
+			case EMySQLParamType::Blob:
+				Lengths[iIndex] = static_cast<unsigned long>(Param.BlobValue.Num());
+				Bind.buffer_type = MYSQL_TYPE_BLOB;
+				Bind.buffer = const_cast<uint8*>(Param.BlobValue.GetData());
+				Bind.buffer_length = Lengths[iIndex];
+				Bind.length = &Lengths[iIndex];
+				break;
+			case EMySQLParamType::Null:
+			default:
+				Bind.buffer_type = MYSQL_TYPE_NULL;
+				break;
 			}
 		}
-		ColumnData.push_back(RowData);
-		row = mysql_fetch_row(result);
 	}
+};
 
-	mysql_free_result(result);
-	bStatus = true;
-	return bStatus;
-}
-
-bool MySQLConnection::UpdateImageFromPath(int ConnectionID, const char* Query, const char* ImageChar, const char*& ErrorMessage)
+MYSQL_STMT* MySQLConnection::ExecutePrepared(int ConnectionID, const string& Sql, FMySQLParamBinds& ParamBinds, bool bIsReadOnly, string& ErrorMessage)
 {
 	MYSQL* CurrentDBConnection = GetDBConnection(ConnectionID);
 	if (!CurrentDBConnection)
 	{
 		ErrorMessage = "Connection Not Found";
-		return false;
+		return nullptr;
 	}
 
-	MYSQL_STMT* stmt = mysql_stmt_init(CurrentDBConnection);
-	if (!stmt)
-	{
-		ErrorMessage = "Failed to initialize statement.";
-		return false;
-	}
+	const unsigned long NumParams = static_cast<unsigned long>(ParamBinds.Binds.size());
 
-	if (mysql_stmt_prepare(stmt, Query, strlen(Query)))
+	// A cached handle can go stale (dropped connection, schema change); re-prepare once in that case
+	for (int Attempt = 0; Attempt < 2; Attempt++)
 	{
-		ErrorMessage = mysql_stmt_error(stmt);
-		mysql_stmt_close(stmt);
-		return false;
-	}
+		if (Attempt > 0 && !(CurrentDBConnection = GetDBConnection(ConnectionID)))
+		{
+			ErrorMessage = "Connection Not Found";
+			return nullptr;
+		}
 
-	MYSQL_BIND bind;
-	memset(&bind, 0, sizeof(bind));
-	bind.buffer_type = MYSQL_TYPE_BLOB;
-	bind.buffer = (void*)ImageChar;
-	bind.buffer_length = strlen(ImageChar);
+		unsigned int PrepareError = 0;
+		MYSQL_STMT* stmt = GetPreparedStatement(ConnectionID, CurrentDBConnection, Sql, ErrorMessage, PrepareError);
+		if (!stmt)
+		{
+			// Nothing was executed yet, so a dropped connection can always be retried here
+			if (Attempt == 0 && IsConnectionLostError(PrepareError) && Reconnect(ConnectionID, ErrorMessage))
+			{
+				continue;
+			}
+			return nullptr;
+		}
 
-	if (mysql_stmt_bind_param(stmt, &bind))
-	{
+		if (mysql_stmt_param_count(stmt) != NumParams)
+		{
+			ErrorMessage = "Parameter count does not match the number of placeholders in the query";
+			return nullptr;
+		}
+
+		if (NumParams > 0 && mysql_stmt_bind_param(stmt, ParamBinds.Binds.data()))
+		{
+			ErrorMessage = mysql_stmt_error(stmt);
+			StatementCaches[ConnectionID].Remove(Sql);
+			return nullptr;
+		}
+
+		if (mysql_stmt_execute(stmt) == 0)
+		{
+			MarkActive(ConnectionID);
+			return stmt;
+		}
+
+		const unsigned int ErrorCode = mysql_stmt_errno(stmt);
 		ErrorMessage = mysql_stmt_error(stmt);
-		mysql_stmt_close(stmt);
-		return false;
-	}
+		StatementCaches[ConnectionID].Remove(Sql);
 
-	if (mysql_stmt_execute(stmt))
+		if (IsConnectionLostError(ErrorCode))
+		{
+			// CR_SERVER_LOST may arrive after the server already ran a write, so writes are only
+			// re-executed when the request never left (CR_SERVER_GONE_ERROR)
+			string ReconnectError;
+			const bool bReconnected = Reconnect(ConnectionID, ReconnectError);
+			if (!bReconnected || (!bIsReadOnly && ErrorCode != CR_SERVER_GONE_ERROR))
+			{
+				return nullptr;
+			}
+		}
+		else if (!IsStaleStatementError(ErrorCode))
+		{
+			return nullptr;
+		}
+	}
+	return nullptr;
+}
+
+bool MySQLConnection::ExecuteParams(int ConnectionID, const char* Query, const TArray<FMySQLParam>& Params, string& ErrorMessage)
+{
+	FMySQLParamBinds ParamBinds(Params);
+	MYSQL_STMT* stmt = ExecutePrepared(ConnectionID, Query, ParamBinds, false, ErrorMessage);
+	if (!stmt)
 	{
-		ErrorMessage = mysql_stmt_error(stmt);
-		mysql_stmt_close(stmt);
 		return false;
 	}
 
-	mysql_stmt_close(stmt);
+	// Drain any result set so the cached statement can be executed again
+	if (mysql_stmt_field_count(stmt) > 0)
+	{
+		mysql_stmt_store_result(stmt);
+		mysql_stmt_free_result(stmt);
+	}
 	return true;
 }
 
-bool MySQLConnection::SelectImageFromQuery(int ConnectionID, const char* Query, char*& ImageChar, const char*& ErrorMessage)
+bool MySQLConnection::ExecuteBatch(int ConnectionID, const vector<string>& Queries, bool bUseTransaction,
+	TArray<FMySQLStatementResult>& Results, string& ErrorMessage)
+{
+	Results.Reset();
+	Results.SetNum(static_cast<int32>(Queries.size()));
+	if (Queries.empty())
+	{
+		return true;
+	}
+
+	// The transaction bracket rides along as extra statements, so the whole batch is a single round trip
+	const int Offset = bUseTransaction ? 1 : 0;
+	string Batch = bUseTransaction ? "START TRANSACTION;\n" : "";
+	for (size_t iIndex = 0; iIndex < Queries.size(); iIndex++)
+	{
+		// A trailing delimiter would end the batch with an empty statement
+		string Query = Queries[iIndex];
+		while (!Query.empty() && (Query.back() == ';' || isspace(static_cast<unsigned char>(Query.back()))))
+		{
+			Query.pop_back();
+		}
+		Batch += Query;
+		if (iIndex + 1 < Queries.size())
+		{
+			Batch += ";\n";
+		}
+	}
+	if (bUseTransaction)
+	{
+		Batch += ";\nCOMMIT";
+	}
+	const bool bIsMultiStatement = Queries.size() + 2 * Offset > 1;
+
+	MYSQL* CurrentDBConnection = nullptr;
+	bool bFailed = true;
+	for (int Attempt = 0; Attempt < 2; Attempt++)
+	{
+		if (!(CurrentDBConnection = GetDBConnection(ConnectionID)))
+		{
+			ErrorMessage = "Connection Not Found";
+			return false;
+		}
+
+		// Multi-statements stay off outside batches so an injected ';' elsewhere cannot stack a second statement
+		bFailed = (bIsMultiStatement && mysql_set_server_option(CurrentDBConnection, MYSQL_OPTION_MULTI_STATEMENTS_ON))
+			|| mysql_real_query(CurrentDBConnection, Batch.c_str(), static_cast<unsigned long>(Batch.size()));
+		if (!bFailed)
+		{
+			break;
+		}
+
+		// Nothing ran unless the request reached the server, so only CR_SERVER_GONE_ERROR is retried
+		string ReconnectError;
+		if (Attempt > 0 || mysql_errno(CurrentDBConnection) != CR_SERVER_GONE_ERROR || !Reconnect(ConnectionID, ReconnectError))
+		{
+			break;
+		}
+	}
+
+	// Every statement produces one result (or the error that ends the batch), in order
+	int StatementIndex = 0;
+	while (!bFailed)
+	{
+		if (MYSQL_RES* ResultSet = mysql_store_result(CurrentDBConnection))
+		{
+			mysql_free_result(ResultSet);
+		}
+		else if (mysql_field_count(CurrentDBConnection) != 0)
+		{
+			bFailed = true;
+			break;
+		}
+
+		const int QueryIndex = StatementIndex - Offset;
+		if (QueryIndex >= 0 && QueryIndex < Results.Num())
+		{
+			Results[QueryIndex].IsSuccessful = true;
+			Results[QueryIndex].AffectedRows = static_cast<int64>(mysql_affected_rows(CurrentDBConnection));
+		}
+		StatementIndex++;
+
+		const int NextStatus = mysql_next_result(CurrentDBConnection);
+		if (NextStatus < 0)
+		{
+			break;
+		}
+		bFailed = NextStatus > 0;
+	}
+
+	const unsigned int ErrorCode = bFailed ? mysql_errno(CurrentDBConnection) : 0;
+	if (bFailed)
+	{
+		ErrorMessage = mysql_error(CurrentDBConnection);
+
+		const int FailedIndex = FMath::Clamp(StatementIndex - Offset, 0, Results.Num());
+		if (FailedIndex < Results.Num())
+		{
+			Results[FailedIndex].ErrorMessage = UTF8_TO_TCHAR(ErrorMessage.c_str());
+		}
+		for (int iIndex = FailedIndex + 1; iIndex < Results.Num(); iIndex++)
+		{
+			Results[iIndex].ErrorMessage = TEXT("Not executed because an earlier statement failed");
+		}
+
+		if (bUseTransaction)
+		{
+			// A lost connection rolls the transaction back on the server as well
+			if (!IsConnectionLostError(ErrorCode))
+			{
+				mysql_query(CurrentDBConnection, "ROLLBACK");
+			}
+
+			// Statements that ran before the failure were undone with it
+			for (int iIndex = 0; iIndex < FailedIndex; iIndex++)
+			{
+				Results[iIndex].IsSuccessful = false;
+				Results[iIndex].AffectedRows = 0;
+				Results[iIndex].ErrorMessage = TEXT("Rolled back because a later statement failed");
+			}
+		}
+	}
+
+	if (!IsConnectionLostError(ErrorCode))
+	{
+		if (bIsMultiStatement)
+		{
+			mysql_set_server_option(CurrentDBConnection, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+		}
+		MarkActive(ConnectionID);
+	}
+	return !bFailed;
+}
+
+// Backtick-quotes an identifier; "db.table" is quoted per part
+static string QuoteMySQLIdentifier(const string& Name)
+{
+	string Quoted = "`";
+	for (char Ch : Name)
+	{
+		if (Ch == '.')
+		{
+			Quoted += "`.`";
+		}
+		else
+		{
+			Quoted += Ch;
+			if (Ch == '`')
+			{
+				Quoted += '`';
+			}
+		}
+	}
+	Quoted += '`';
+	return Quoted;
+}
+
+// Bulk rows spell SQL NULL the way selects report it
+static bool IsBulkNullValue(const FString& Value)
+{
+	return Value.Equals(TEXT("NULL"), ESearchCase::CaseSensitive);
+}
+
+// Serves rows to LOAD DATA LOCAL INFILE as tab-separated text, a row at a time, so the
+// whole file never has to exist in memory. The file name the server asks for is ignored.
+struct FMySQLInfileStream
+{
+	const TArray<FMySQLDataRow>* Rows = nullptr;
+	int NextRow = 0;
+	string Pending;
+	size_t PendingOffset = 0;
+
+	void SerializeRow(const FMySQLDataRow& Row)
+	{
+		Pending.clear();
+		PendingOffset = 0;
+		for (int iIndex = 0; iIndex < Row.RowData.Num(); iIndex++)
+		{
+			if (iIndex > 0)
+			{
+				Pending += '\t';
+			}
+			if (IsBulkNullValue(Row.RowData[iIndex]))
+			{
+				Pending += "\\N";
+				continue;
+			}
+			const FTCHARToUTF8 Value(*Row.RowData[iIndex]);
+			for (int32 iChar = 0; iChar < Value.Length(); iChar++)
+			{
+				const char Ch = Value.Get()[iChar];
+				switch (Ch)
+				{
+				case '\\': Pending += "\\\\"; break;
+				case '\t': Pending += "\\t"; break;
+				case '\n': Pending += "\\n"; break;
+				case '\r': Pending += "\\r"; break;
+				case '\0': Pending += "\\0"; break;
+				default: Pending += Ch; break;
+				}
+			}
+		}
+		Pending += '\n';
+	}
+
+	static int Init(void** Ptr, const char* FileName, void* UserData)
+	{
+		*Ptr = UserData;
+		return 0;
+	}
+
+	static int Read(void* Ptr, char* Buffer, unsigned int BufferLength)
+	{
+		FMySQLInfileStream& Stream = *static_cast<FMySQLInfileStream*>(Ptr);
+		unsigned int Written = 0;
+		while (Written < BufferLength)
+		{
+			if (Stream.PendingOffset >= Stream.Pending.size())
+			{
+				if (Stream.NextRow >= Stream.Rows->Num())
+				{
+					break;
+				}
+				Stream.SerializeRow((*Stream.Rows)[Stream.NextRow++]);
+			}
+
+			const size_t Count = min<size_t>(BufferLength - Written, Stream.Pending.size() - Stream.PendingOffset);
+			memcpy(Buffer + Written, Stream.Pending.data() + Stream.PendingOffset, Count);
+			Stream.PendingOffset += Count;
+			Written += static_cast<unsigned int>(Count);
+		}
+		return static_cast<int>(Written);
+	}
+
+	static void End(void* Ptr)
+	{
+	}
+
+	static int Error(void* Ptr, char* Message, unsigned int MessageLength)
+	{
+		snprintf(Message, MessageLength, "Failed to stream rows for LOAD DATA LOCAL INFILE");
+		return CR_UNKNOWN_ERROR;
+	}
+};
+
+static bool LoadDataFromMemory(MYSQL* Handle, const string& QuotedTable, const string& ColumnList, const TArray<FMySQLDataRow>& Rows,
+	int64& AffectedRows, string& ErrorMessage)
+{
+	const string Query = "LOAD DATA LOCAL INFILE 'memory' INTO TABLE " + QuotedTable
+		+ " CHARACTER SET utf8mb4 FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' " + ColumnList;
+
+	FMySQLInfileStream Stream;
+	Stream.Rows = &Rows;
+
+	// The handler only ever reads from Stream and is swapped back to the refusing one afterwards, so a
+	// hostile server cannot use it to request files from disk
+	mysql_set_local_infile_handler(Handle, &FMySQLInfileStream::Init, &FMySQLInfileStream::Read, &FMySQLInfileStream::End,
+		&FMySQLInfileStream::Error, &Stream);
+
+	const bool bLoaded = mysql_real_query(Handle, Query.c_str(), static_cast<unsigned long>(Query.size())) == 0;
+	if (bLoaded)
+	{
+		AffectedRows = static_cast<int64>(mysql_affected_rows(Handle));
+	}
+	else
+	{
+		ErrorMessage = mysql_error(Handle);
+	}
+
+	FMySQLInfileRefusal::Install(Handle);
+	return bLoaded;
+}
+
+static bool InsertMultiRow(MYSQL* Handle, const string& QuotedTable, const string& ColumnList, const TArray<FMySQLDataRow>& Rows,
+	int64& AffectedRows, string& ErrorMessage)
+{
+	size_t MaxAllowedPacket = 1024 * 1024;
+	if (mysql_query(Handle, "SELECT @@max_allowed_packet") == 0)
+	{
+		if (MYSQL_RES* Result = mysql_store_result(Handle))
+		{
+			MYSQL_ROW Row = mysql_fetch_row(Result);
+			if (Row && Row[0])
+			{
+				MaxAllowedPacket = static_cast<size_t>(strtoull(Row[0], nullptr, 10));
+			}
+			mysql_free_result(Result);
+		}
+	}
+	// Leave room for the packet header and the server's own accounting
+	const size_t ChunkLimit = max<size_t>(MaxAllowedPacket - FMath::Min<size_t>(MaxAllowedPacket / 2, 1024), 4096);
+
+	const string Prefix = "INSERT INTO " + QuotedTable + " " + ColumnList + " VALUES ";
+	string Statement;
+	Statement.reserve(min<size_t>(ChunkLimit, 16 * 1024 * 1024));
+	string Tuple;
+	string Escaped;
+
+	const auto Flush = [&]() -> bool
+	{
+		if (mysql_real_query(Handle, Statement.c_str(), static_cast<unsigned long>(Statement.size())))
+		{
+			ErrorMessage = mysql_error(Handle);
+			return false;
+		}
+		AffectedRows += static_cast<int64>(mysql_affected_rows(Handle));
+		Statement.clear();
+		return true;
+	};
+
+	for (const FMySQLDataRow& Row : Rows)
+	{
+		Tuple = "(";
+		for (int iIndex = 0; iIndex < Row.RowData.Num(); iIndex++)
+		{
+			if (IsBulkNullValue(Row.RowData[iIndex]))
+			{
+				Tuple += iIndex > 0 ? ", NULL" : "NULL";
+				continue;
+			}
+			const FTCHARToUTF8 Value(*Row.RowData[iIndex]);
+			Escaped.resize(static_cast<size_t>(Value.Length()) * 2 + 1);
+			const unsigned long EscapedLength = mysql_real_escape_string(Handle, &Escaped[0], Value.Get(), static_cast<unsigned long>(Value.Length()));
+
+			Tuple += iIndex > 0 ? ", '" : "'";
+			Tuple.append(Escaped.data(), EscapedLength);
+			Tuple += '\'';
+		}
+		Tuple += ')';
+
+		// A single row larger than the limit still goes out on its own and is reported by the server
+		if (!Statement.empty() && Statement.size() + 2 + Tuple.size() > ChunkLimit && !Flush())
+		{
+			return false;
+		}
+
+		Statement += Statement.empty() ? Prefix : ", ";
+		Statement += Tuple;
+	}
+
+	return Statement.empty() || Flush();
+}
+
+bool MySQLConnection::BulkInsert(int ConnectionID, const string& Table, const vector<string>& Columns, const TArray<FMySQLDataRow>& Rows,
+	int LoadDataRowThreshold, int64& AffectedRows, string& ErrorMessage)
+{
+	AffectedRows = 0;
+
+	if (Columns.empty())
+	{
+		ErrorMessage = "BulkInsert needs at least one column";
+		return false;
+	}
+	for (int iIndex = 0; iIndex < Rows.Num(); iIndex++)
+	{
+		if (Rows[iIndex].RowData.Num() != static_cast<int32>(Columns.size()))
+		{
+			ErrorMessage = "Row " + to_string(iIndex) + " has " + to_string(Rows[iIndex].RowData.Num()) + " values but "
+				+ to_string(Columns.size()) + " columns were given";
+			return false;
+		}
+	}
+	if (Rows.Num() == 0)
+	{
+		return true;
+	}
+
+	const string QuotedTable = QuoteMySQLIdentifier(Table);
+	string ColumnList = "(";
+	for (size_t iIndex = 0; iIndex < Columns.size(); iIndex++)
+	{
+		ColumnList += (iIndex > 0 ? ", " : "") + QuoteMySQLIdentifier(Columns[iIndex]);
+	}
+	ColumnList += ')';
+
+	// Nothing has been written yet, so RunQuery may safely retry this on a dropped connection
+	MYSQL* CurrentDBConnection = RunQuery(ConnectionID, "START TRANSACTION", ErrorMessage);
+	if (!CurrentDBConnection)
+	{
+		return false;
+	}
+
+	bool bInserted = false;
+	bool bTriedLoadData = false;
+	if (LoadDataRowThreshold > 0 && Rows.Num() >= LoadDataRowThreshold)
+	{
+		bTriedLoadData = true;
+		bInserted = LoadDataFromMemory(CurrentDBConnection, QuotedTable, ColumnList, Rows, AffectedRows, ErrorMessage);
+	}
+
+	// Servers often run with local_infile disabled; a failed LOAD DATA leaves the transaction usable
+	if (!bInserted && !IsConnectionLostError(mysql_errno(CurrentDBConnection)))
+	{
+		if (bTriedLoadData)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("LOAD DATA LOCAL INFILE failed (%s), falling back to multi-row INSERT"), UTF8_TO_TCHAR(ErrorMessage.c_str()));
+			AffectedRows = 0;
+		}
+		bInserted = InsertMultiRow(CurrentDBConnection, QuotedTable, ColumnList, Rows, AffectedRows, ErrorMessage);
+	}
+
+	if (bInserted && mysql_query(CurrentDBConnection, "COMMIT"))
+	{
+		ErrorMessage = mysql_error(CurrentDBConnection);
+		bInserted = false;
+	}
+
+	if (!bInserted)
+	{
+		AffectedRows = 0;
+		if (!IsConnectionLostError(mysql_errno(CurrentDBConnection)))
+		{
+			mysql_query(CurrentDBConnection, "ROLLBACK");
+		}
+	}
+
+	MarkActive(ConnectionID);
+	return bInserted;
+}
+
+static EMySQLColumnType GetTypedColumnType(const MYSQL_FIELD& Field)
+{
+	switch (Field.type)
+	{
+	case MYSQL_TYPE_TINY:
+	case MYSQL_TYPE_SHORT:
+	case MYSQL_TYPE_INT24:
+	case MYSQL_TYPE_LONG:
+	case MYSQL_TYPE_LONGLONG:
+	case MYSQL_TYPE_YEAR:
+		return EMySQLColumnType::Int;
+	case MYSQL_TYPE_FLOAT:
+	case MYSQL_TYPE_DOUBLE:
+		return EMySQLColumnType::Float;
+	case MYSQL_TYPE_DATE:
+	case MYSQL_TYPE_DATETIME:
+	case MYSQL_TYPE_TIMESTAMP:
+		return EMySQLColumnType::DateTime;
+	case MYSQL_TYPE_TINY_BLOB:
+	case MYSQL_TYPE_MEDIUM_BLOB:
+	case MYSQL_TYPE_LONG_BLOB:
+	case MYSQL_TYPE_BLOB:
+	case MYSQL_TYPE_STRING:
+	case MYSQL_TYPE_VAR_STRING:
+	case MYSQL_TYPE_BIT:
+		// Character set 63 is "binary": BLOB/BINARY/VARBINARY rather than text
+		return Field.charsetnr == 63 ? EMySQLColumnType::Blob : EMySQLColumnType::String;
+	default:
+		// DECIMAL keeps its exact digits as text; TIME, ENUM, SET and JSON are text as well
+		return EMySQLColumnType::String;
+	}
+}
+
+static FDateTime ToDateTime(const MYSQL_TIME& Time)
+{
+	const int32 Millisecond = static_cast<int32>(Time.second_part / 1000);
+	if (!FDateTime::Validate(Time.year, Time.month, Time.day, Time.hour, Time.minute, Time.second, Millisecond))
+	{
+		// Zero dates ('0000-00-00') and other values FDateTime cannot hold
+		return FDateTime();
+	}
+	return FDateTime(Time.year, Time.month, Time.day, Time.hour, Time.minute, Time.second, Millisecond);
+}
+
+bool MySQLConnection::SelectTyped(int ConnectionID, const char* Query, const TArray<FMySQLParam>& Params, FMySQLTypedResult& Result, string& ErrorMessage)
+{
+	Result = FMySQLTypedResult();
+
+	// Anything that isn't verifiably a read is only retried when the server never received it
+	FMySQLParamBinds ParamBinds(Params);
+	MYSQL_STMT* stmt = ExecutePrepared(ConnectionID, Query, ParamBinds, IsReadOnlyQuery(Query), ErrorMessage);
+	if (!stmt)
+	{
+		return false;
+	}
+
+	MYSQL_RES* Metadata = mysql_stmt_result_metadata(stmt);
+	if (!Metadata)
+	{
+		ErrorMessage = "No result set returned from query.";
+		return false;
+	}
+
+	// Let store_result compute max_length so every variable-length buffer is sized once
+	my_bool bUpdateMaxLength = 1;
+	mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &bUpdateMaxLength);
+
+	if (mysql_stmt_store_result(stmt))
+	{
+		ErrorMessage = mysql_stmt_error(stmt);
+		mysql_free_result(Metadata);
+		return false;
+	}
+
+	const unsigned int NumFields = mysql_num_fields(Metadata);
+	const MYSQL_FIELD* Fields = mysql_fetch_fields(Metadata);
+	const int32 NumRows = static_cast<int32>(mysql_stmt_num_rows(stmt));
+
+	vector<MYSQL_BIND> Binds(NumFields);
+	vector<long long> IntValues(NumFields);
+	vector<double> FloatValues(NumFields);
+	vector<MYSQL_TIME> TimeValues(NumFields);
+	vector<vector<char>> Buffers(NumFields);
+	vector<unsigned long> Lengths(NumFields);
+	vector<my_bool> Nulls(NumFields);
+	vector<my_bool> Truncated(NumFields);
+	memset(Binds.data(), 0, sizeof(MYSQL_BIND) * NumFields);
+
+	Result.NumRows = NumRows;
+	Result.Columns.SetNum(NumFields);
+
+	for (unsigned int iIndex = 0; iIndex < NumFields; iIndex++)
+	{
+		const MYSQL_FIELD& Field = Fields[iIndex];
+		FMySQLTypedColumn& Column = Result.Columns[iIndex];
+		MYSQL_BIND& Bind = Binds[iIndex];
+
+		Column.Name = UTF8_TO_TCHAR(Field.name);
+		Column.Type = GetTypedColumnType(Field);
+		Column.NullBitmap.SetNumZeroed((NumRows + 7) / 8);
+
+		Bind.is_null = &Nulls[iIndex];
+		Bind.length = &Lengths[iIndex];
+		Bind.error = &Truncated[iIndex];
+
+		switch (Column.Type)
+		{
+		case EMySQLColumnType::Int:
+			// BIGINT UNSIGNED values above INT64_MAX wrap
+			Bind.buffer_type = MYSQL_TYPE_LONGLONG;
+			Bind.buffer = &IntValues[iIndex];
+			Bind.is_unsigned = (Field.flags & UNSIGNED_FLAG) != 0;
+			Column.IntValues.Reserve(NumRows);
+			break;
+		case EMySQLColumnType::Float:
+			Bind.buffer_type = MYSQL_TYPE_DOUBLE;
+			Bind.buffer = &FloatValues[iIndex];
+			Column.FloatValues.Reserve(NumRows);
+			break;
+		case EMySQLColumnType::DateTime:
+			Bind.buffer_type = Field.type;
+			Bind.buffer = &TimeValues[iIndex];
+			Column.DateTimeValues.Reserve(NumRows);
+			break;
+		case EMySQLColumnType::Blob:
+		case EMySQLColumnType::String:
+			Buffers[iIndex].resize(FMath::Max<unsigned long>(Field.max_length, 1));
+			Bind.buffer_type = Column.Type == EMySQLColumnType::Blob ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+			Bind.buffer = Buffers[iIndex].data();
+			Bind.buffer_length = static_cast<unsigned long>(Buffers[iIndex].size());
+			if (Column.Type == EMySQLColumnType::Blob)
+			{
+				Column.BlobOffsets.Reserve(NumRows + 1);
+				Column.BlobOffsets.Add(0);
+			}
+			else
+			{
+				Column.StringValues.Reserve(NumRows);
+			}
+			break;
+		}
+	}
+
+	bool bStatus = mysql_stmt_bind_result(stmt, Binds.data()) == 0;
+	if (!bStatus)
+	{
+		ErrorMessage = mysql_stmt_error(stmt);
+	}
+
+	for (int32 Row = 0; bStatus && Row < NumRows; Row++)
+	{
+		const int FetchStatus = mysql_stmt_fetch(stmt);
+		if (FetchStatus == MYSQL_NO_DATA)
+		{
+			Result.NumRows = Row;
+			break;
+		}
+		if (FetchStatus == 1)
+		{
+			ErrorMessage = mysql_stmt_error(stmt);
+			bStatus = false;
+			break;
+		}
+		if (FetchStatus == MYSQL_DATA_TRUNCATED)
+		{
+			// max_length can undershoot (e.g. multi-byte conversions), grow the buffer and read the column again
+			bool bRebind = false;
+			for (unsigned int iIndex = 0; bStatus && iIndex < NumFields; iIndex++)
+			{
+				if (!Truncated[iIndex])
+				{
+					continue;
+				}
+
+				const EMySQLColumnType Type = Result.Columns[iIndex].Type;
+				if (Type != EMySQLColumnType::String && Type != EMySQLColumnType::Blob)
+				{
+					ErrorMessage = "Value of column " + string(Fields[iIndex].name) + " does not fit its type.";
+					bStatus = false;
+					break;
+				}
+
+				Buffers[iIndex].resize(Lengths[iIndex]);
+				Binds[iIndex].buffer = Buffers[iIndex].data();
+				Binds[iIndex].buffer_length = Lengths[iIndex];
+				bRebind = true;
+
+				if (mysql_stmt_fetch_column(stmt, &Binds[iIndex], iIndex, 0))
+				{
+					ErrorMessage = mysql_stmt_error(stmt);
+					bStatus = false;
+				}
+			}
+
+			// Later rows write into the grown buffers
+			if (bStatus && bRebind && mysql_stmt_bind_result(stmt, Binds.data()))
+			{
+				ErrorMessage = mysql_stmt_error(stmt);
+				bStatus = false;
+			}
+			if (!bStatus)
+			{
+				break;
+			}
+		}
+
+		for (unsigned int iIndex = 0; iIndex < NumFields; iIndex++)
+		{
+			FMySQLTypedColumn& Column = Result.Columns[iIndex];
+			const bool bIsNull = Nulls[iIndex] != 0;
+			if (bIsNull)
+			{
+				Column.NullBitmap[Row / 8] |= 1 << (Row % 8);
+			}
+
+			switch (Column.Type)
+			{
+			case EMySQLColumnType::Int:
+				Column.IntValues.Add(bIsNull ? 0 : IntValues[iIndex]);
+				break;
+			case EMySQLColumnType::Float:
+				Column.FloatValues.Add(bIsNull ? 0.0 : FloatValues[iIndex]);
+				break;
+			case EMySQLColumnType::DateTime:
+				Column.DateTimeValues.Add(bIsNull ? FDateTime() : ToDateTime(TimeValues[iIndex]));
+				break;
+			case EMySQLColumnType::String:
+				if (bIsNull)
+				{
+					Column.StringValues.AddDefaulted();
+				}
+				else
+				{
+					const FUTF8ToTCHAR Converted(Buffers[iIndex].data(), static_cast<int32>(FMath::Min<size_t>(Lengths[iIndex], Buffers[iIndex].size())));
+					Column.StringValues.Emplace(Converted.Length(), Converted.Get());
+				}
+				break;
+			case EMySQLColumnType::Blob:
+				if (!bIsNull)
+				{
+					Column.BlobData.Append(reinterpret_cast<const uint8*>(Buffers[iIndex].data()),
+						static_cast<int32>(FMath::Min<size_t>(Lengths[iIndex], Buffers[iIndex].size())));
+				}
+				Column.BlobOffsets.Add(Column.BlobData.Num());
+				break;
+			}
+		}
+	}
+
+	mysql_stmt_free_result(stmt);
+	mysql_free_result(Metadata);
+	return bStatus;
+}
+
+bool MySQLConnection::SelectDataStreaming(int ConnectionID, const char* Query,
+	const function<void(const MYSQL_FIELD* Fields, unsigned int NumFields)>& OnColumns,
+	const function<void(MYSQL_ROW Row, const unsigned long* Lengths, unsigned int NumFields)>& OnRow,
+	string& ErrorMessage)
+{
+	MYSQL* CurrentDBConnection = RunQuery(ConnectionID, Query, ErrorMessage);
+	if (!CurrentDBConnection)
+	{
+		return false;
+	}
+
+	// Rows are read from the socket on demand instead of being buffered client-side first
+	MYSQL_RES* result = mysql_use_result(CurrentDBConnection);
+	if (!result)
+	{
+		ErrorMessage = mysql_errno(CurrentDBConnection) ? mysql_error(CurrentDBConnection) : "No result set returned from query.";
+		return false;
+	}
+
+	const unsigned int num_fields = mysql_num_fields(result);
+	OnColumns(mysql_fetch_fields(result), num_fields);
+
+	while (MYSQL_ROW row = mysql_fetch_row(result))
+	{
+		OnRow(row, mysql_fetch_lengths(result), num_fields);
+	}
+
+	// mysql_fetch_row also returns null when the stream breaks off
+	const bool bStatus = mysql_errno(CurrentDBConnection) == 0;
+	if (!bStatus)
+	{
+		ErrorMessage = mysql_error(CurrentDBConnection);
+	}
+
+	mysql_free_result(result);
+	return bStatus;
+}
+
+bool MySQLConnection::UpdateImageFromData(int ConnectionID, const char* Query, const TArray<uint8>& ImageData, string& ErrorMessage)
 {
 	MYSQL* CurrentDBConnection = GetDBConnection(ConnectionID);
 	if (!CurrentDBConnection)
@@ -358,9 +1433,78 @@ bool MySQLConnection::SelectImageFromQuery(int ConnectionID, const char* Query,
 		return false;
 	}
 
-	if (mysql_query(CurrentDBConnection, Query))
+	MYSQL_STMT* stmt = mysql_stmt_init(CurrentDBConnection);
+	if (!stmt)
+	{
+		ErrorMessage = "Failed to initialize statement.";
+		return false;
+	}
+
+	if (mysql_stmt_prepare(stmt, Query, strlen(Query)))
+	{
+		ErrorMessage = mysql_stmt_error(stmt);
+		mysql_stmt_close(stmt);
+		return false;
+	}
+
+	if (mysql_stmt_param_count(stmt) != 1)
+	{
+		ErrorMessage = "Image queries need exactly one '?' placeholder for the image";
+		mysql_stmt_close(stmt);
+		return false;
+	}
+
+	const bool bSendLongData = ImageData.Num() > LongDataChunkSize;
+	unsigned long ImageLength = static_cast<unsigned long>(ImageData.Num());
+
+	MYSQL_BIND bind;
+	memset(&bind, 0, sizeof(bind));
+	bind.buffer_type = MYSQL_TYPE_LONG_BLOB;
+	if (!bSendLongData)
+	{
+		bind.buffer = const_cast<uint8*>(ImageData.GetData());
+		bind.buffer_length = ImageLength;
+		bind.length = &ImageLength;
+	}
+
+	if (mysql_stmt_bind_param(stmt, &bind))
+	{
+		ErrorMessage = mysql_stmt_error(stmt);
+		mysql_stmt_close(stmt);
+		return false;
+	}
+
+	if (bSendLongData)
+	{
+		for (int32 Offset = 0; Offset < ImageData.Num(); Offset += LongDataChunkSize)
+		{
+			const int32 ChunkLength = FMath::Min(LongDataChunkSize, ImageData.Num() - Offset);
+			if (mysql_stmt_send_long_data(stmt, 0, reinterpret_cast<const char*>(ImageData.GetData() + Offset), ChunkLength))
+			{
+				ErrorMessage = mysql_stmt_error(stmt);
+				mysql_stmt_close(stmt);
+				return false;
+			}
+		}
+	}
+
+	if (mysql_stmt_execute(stmt))
+	{
+		ErrorMessage = mysql_stmt_error(stmt);
+		mysql_stmt_close(stmt);
+		return false;
+	}
+
+	mysql_stmt_close(stmt);
+	MarkActive(ConnectionID);
+	return true;
+}
+
+bool MySQLConnection::SelectImageFromQuery(int ConnectionID, const char* Query, TArray<uint8>& ImageData, string& ErrorMessage)
+{
+	MYSQL* CurrentDBConnection = RunQuery(ConnectionID, Query, ErrorMessage);
+	if (!CurrentDBConnection)
 	{
-		ErrorMessage = mysql_error(CurrentDBConnection);
 		return false;
 	}
 
@@ -372,20 +1516,240 @@ bool MySQLConnection::SelectImageFromQuery(int ConnectionID, const char* Query,
 	}
 
 	MYSQL_ROW row = mysql_fetch_row(res);
-	if (row)
+	if (!row || mysql_num_fields(res) == 0)
 	{
-		unsigned long* lengths = mysql_fetch_lengths(res);
-		ImageChar = new char[lengths[0] + 1];
-		memcpy(ImageChar, row[0], lengths[0]);
-		ImageChar[lengths[0]] = 0;
+		ErrorMessage = "No data returned.";
+		mysql_free_result(res);
+		return false;
 	}
-	else
+	if (!row[0])
 	{
-		ErrorMessage = "No data returned.";
+		ErrorMessage = "Image column is NULL.";
 		mysql_free_result(res);
 		return false;
 	}
 
+	unsigned long* lengths = mysql_fetch_lengths(res);
+	ImageData.SetNumUninitialized(static_cast<int32>(lengths[0]));
+	FMemory::Memcpy(ImageData.GetData(), row[0], lengths[0]);
+
 	mysql_free_result(res);
 	return true;
 }
+
+FMySQLConnectionPool::FMySQLConnectionPool(const FMySQLConnectSettings& InSettings)
+	: Settings(InSettings)
+{
+}
+
+FMySQLConnectionPool::~FMySQLConnectionPool()
+{
+	Shutdown();
+}
+
+void FMySQLConnectionPool::SetLimits(int InMinSize, int InMaxSize, double InIdleTimeoutSeconds)
+{
+	lock_guard<mutex> Lock(Mutex);
+	MaxSize = max(InMaxSize, 1);
+	MinSize = FMath::Clamp(InMinSize, 0, MaxSize);
+	IdleTimeoutSeconds = InIdleTimeoutSeconds;
+}
+
+MYSQL* FMySQLConnectionPool::Acquire(string& ErrorMessage)
+{
+	unique_lock<mutex> Lock(Mutex);
+	if (bShutdown)
+	{
+		ErrorMessage = "Connection pool is shut down.";
+		return nullptr;
+	}
+
+	while (!Idle.empty())
+	{
+		MYSQL* Candidate = Idle.back().Handle;
+		Idle.pop_back();
+		NumLeased++;
+
+		// The reset round trip doubles as the liveness check and clears the previous lessee's session
+		Lock.unlock();
+		if (mysql_reset_connection(Candidate) == 0)
+		{
+			mysql_set_character_set(Candidate, "utf8mb4");
+			return Candidate;
+		}
+		mysql_close(Candidate);
+		Lock.lock();
+		NumLeased--;
+	}
+
+	// Leases last as long as the connection that holds them, so waiting for a release could stall a worker
+	// indefinitely; fail straight away instead
+	if (NumLeased + NumOpening >= MaxSize)
+	{
+		ErrorMessage = "All " + to_string(MaxSize) + " pooled MySQL connections for this server and database are in use. "
+			"Close a connection or raise MaxConnectionsPerDSN.";
+		return nullptr;
+	}
+
+	NumOpening++;
+	Lock.unlock();
+
+	// Connect outside the lock so a slow handshake doesn't block releases
+	MYSQL* Handle = MySQLConnection::ConnectHandle(Settings, ErrorMessage);
+
+	Lock.lock();
+	NumOpening--;
+	if (Handle)
+	{
+		NumLeased++;
+	}
+	return Handle;
+}
+
+void FMySQLConnectionPool::Release(MYSQL* Handle)
+{
+	if (!Handle)
+	{
+		return;
+	}
+
+	{
+		lock_guard<mutex> Lock(Mutex);
+		NumLeased--;
+		if (!bShutdown)
+		{
+			Idle.push_back({ Handle, chrono::steady_clock::now() });
+			return;
+		}
+	}
+	mysql_close(Handle);
+}
+
+void FMySQLConnectionPool::Discard(MYSQL* Handle)
+{
+	if (!Handle)
+	{
+		return;
+	}
+
+	mysql_close(Handle);
+
+	lock_guard<mutex> Lock(Mutex);
+	NumLeased--;
+}
+
+void FMySQLConnectionPool::Maintain()
+{
+	vector<MYSQL*> Expired;
+	vector<MYSQL*> Retained;
+	int NumToOpen = 0;
+	{
+		lock_guard<mutex> Lock(Mutex);
+		if (bShutdown || bMaintaining)
+		{
+			return;
+		}
+		bMaintaining = true;
+
+		const chrono::steady_clock::time_point Now = chrono::steady_clock::now();
+		const auto IsExpired = [this, Now](const FIdleHandle& Entry)
+		{
+			return chrono::duration<double>(Now - Entry.ReleasedAt).count() >= IdleTimeoutSeconds;
+		};
+
+		// Oldest first; keep enough handles open to satisfy MinSize
+		int NumOpen = NumLeased + NumOpening + static_cast<int>(Idle.size());
+		vector<FIdleHandle> Kept;
+		for (const FIdleHandle& Entry : Idle)
+		{
+			if (!IsExpired(Entry))
+			{
+				Kept.push_back(Entry);
+			}
+			else if (NumOpen > MinSize)
+			{
+				Expired.push_back(Entry.Handle);
+				NumOpen--;
+			}
+			else
+			{
+				// Kept only for MinSize; ping it so the server's wait_timeout never closes it
+				Retained.push_back(Entry.Handle);
+				NumLeased++;
+			}
+		}
+		Idle.swap(Kept);
+		NumToOpen = FMath::Max(0, MinSize - NumOpen);
+		NumOpening += NumToOpen;
+	}
+
+	for (MYSQL* Handle : Expired)
+	{
+		mysql_close(Handle);
+	}
+
+	for (MYSQL* Handle : Retained)
+	{
+		if (mysql_ping(Handle) == 0)
+		{
+			Release(Handle);
+		}
+		else
+		{
+			Discard(Handle);
+			lock_guard<mutex> Lock(Mutex);
+			NumOpening++;
+			NumToOpen++;
+		}
+	}
+
+	for (int iIndex = 0; iIndex < NumToOpen; iIndex++)
+	{
+		string ErrorMessage;
+		MYSQL* Handle = MySQLConnection::ConnectHandle(Settings, ErrorMessage);
+
+		lock_guard<mutex> Lock(Mutex);
+		NumOpening--;
+		if (!Handle)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MySQL pool could not open a connection: %s"), UTF8_TO_TCHAR(ErrorMessage.c_str()));
+			continue;
+		}
+		if (bShutdown)
+		{
+			mysql_close(Handle);
+			continue;
+		}
+		Idle.insert(Idle.begin(), { Handle, chrono::steady_clock::now() });
+	}
+
+	lock_guard<mutex> Lock(Mutex);
+	bMaintaining = false;
+}
+
+void FMySQLConnectionPool::Shutdown()
+{
+	vector<FIdleHandle> ToClose;
+	{
+		lock_guard<mutex> Lock(Mutex);
+		bShutdown = true;
+		ToClose.swap(Idle);
+	}
+
+	for (const FIdleHandle& Entry : ToClose)
+	{
+		mysql_close(Entry.Handle);
+	}
+}
+
+int FMySQLConnectionPool::GetNumIdle() const
+{
+	lock_guard<mutex> Lock(Mutex);
+	return static_cast<int>(Idle.size());
+}
+
+int FMySQLConnectionPool::GetNumLeased() const
+{
+	lock_guard<mutex> Lock(Mutex);
+	return NumLeased;
+}
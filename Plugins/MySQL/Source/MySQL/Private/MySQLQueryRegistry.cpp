@@ -0,0 +1,95 @@
+// Copyright Athian Games. All Rights Reserved.
+
+#include "MySQLQueryRegistry.h"
+
+#include <atomic>
+
+
+FMySQLQueryRegistry::FMySQLQueryRegistry(int32 CompletedHistorySize)
+	: CompletedHistory(FMath::Max(CompletedHistorySize, 1))
+{
+}
+
+int64 FMySQLQueryRegistry::AllocateHandle()
+{
+	static std::atomic<int64> NextHandle{ 1 };
+	return NextHandle.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FMySQLQueryRegistry::Register(int64 QueryID)
+{
+	check(IsInGameThread());
+	Pending.Add(QueryID);
+}
+
+void FMySQLQueryRegistry::Complete(int64 QueryID, bool bIsSuccessful)
+{
+	check(IsInGameThread());
+	if (Pending.Remove(QueryID) == 0)
+	{
+		return;
+	}
+	CompletedHistory.Add(QueryID, bIsSuccessful);
+
+	// Detach first; callbacks may queue and await new queries
+	TArray<TSharedPtr<FWaiter>> QueryWaiters;
+	Waiters.MultiFind(QueryID, QueryWaiters);
+	Waiters.Remove(QueryID);
+
+	for (const TSharedPtr<FWaiter>& Waiter : QueryWaiters)
+	{
+		Waiter->bAllSuccessful &= bIsSuccessful;
+		if (--Waiter->Remaining == 0 && Waiter->OnCompleted)
+		{
+			Waiter->OnCompleted(Waiter->bAllSuccessful);
+		}
+	}
+}
+
+bool FMySQLQueryRegistry::IsPending(int64 QueryID) const
+{
+	return Pending.Contains(QueryID);
+}
+
+void FMySQLQueryRegistry::WhenAll(TConstArrayView<int64> QueryIDs, FOnQueriesCompleted OnCompleted)
+{
+	check(IsInGameThread());
+
+	TSharedPtr<FWaiter> Waiter = MakeShared<FWaiter>();
+	Waiter->OnCompleted = MoveTemp(OnCompleted);
+
+	TSet<int64> Awaited;
+	for (int64 QueryID : QueryIDs)
+	{
+		bool bAlreadyInSet = false;
+		Awaited.Add(QueryID, &bAlreadyInSet);
+		if (bAlreadyInSet)
+		{
+			continue;
+		}
+
+		if (Pending.Contains(QueryID))
+		{
+			Waiter->Remaining++;
+			Waiters.Add(QueryID, Waiter);
+		}
+		else
+		{
+			const bool* Outcome = CompletedHistory.Find(QueryID);
+			Waiter->bAllSuccessful &= Outcome != nullptr && *Outcome;
+		}
+	}
+
+	if (Waiter->Remaining == 0 && Waiter->OnCompleted)
+	{
+		Waiter->OnCompleted(Waiter->bAllSuccessful);
+	}
+}
+
+void FMySQLQueryRegistry::FailAll()
+{
+	for (int64 QueryID : Pending.Array())
+	{
+		Complete(QueryID, false);
+	}
+}
@@ -9,6 +9,7 @@
 
 
 #include "MySQLDBConnector.h"
+#include "MySQLImageCache.h"
 
 /**
  * 
@@ -16,7 +17,28 @@
 
 class AMySQLDBConnectionActor;
 
-class MYSQL_API OpenMySQLConnectionTask : public FNonAbandonableTask
+/**
+ * Base for tasks started through AMySQLDBConnectionActor::StartAsyncTask. The task's game-thread
+ * completion callback deletes the FAsyncTask wrapper that owns it, so finished tasks never have
+ * to be polled for.
+ */
+class MYSQL_API FMySQLSelfReleasingTask : public FNonAbandonableTask
+{
+public:
+
+	// Set by StartAsyncTask before the task is queued
+	FAsyncTaskBase* OwningTask = nullptr;
+
+protected:
+
+	// Must be the last thing the game-thread completion callback does; deletes this task.
+	void ReleaseOnGameThread(const TWeakObjectPtr<AMySQLDBConnectionActor>& DBConnectionActor);
+
+	// False once the actor is gone or its play has ended; completion callbacks then only release the task.
+	static bool CanDeliverResults(const TWeakObjectPtr<AMySQLDBConnectionActor>& DBConnectionActor);
+};
+
+class MYSQL_API OpenMySQLConnectionTask : public FMySQLSelfReleasingTask
 {
 
 	FString Server;
@@ -47,20 +69,24 @@ public:
 };
 
 
-class MYSQL_API UpdateMySQLQueryAsyncTask : public FNonAbandonableTask
+class MYSQL_API UpdateMySQLQueryAsyncTask : public FMySQLSelfReleasingTask
 {
 
 	TArray<FString> Queries;
+	TArray<FMySQLParam> Params;
+	bool bUseTransaction;
 	TWeakObjectPtr<AMySQLDBConnectionActor> CurrentDBConnectionActor;
 	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
 	int32 ConnectionID;
-	int32 QueryID;
+	int64 QueryID;
 	
 public:
 
 
-	UpdateMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int32 queryID,
-		TArray<FString> queries);
+	// When params is non-empty, queries holds a single statement with '?' placeholders. Several queries
+	// (or useTransaction) are sent as one batch and also reported through OnQueryBatchStatusChanged.
+	UpdateMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID,
+		TArray<FString> queries, TArray<FMySQLParam> params = TArray<FMySQLParam>(), bool useTransaction = false);
 
 	virtual ~UpdateMySQLQueryAsyncTask();
 	virtual void DoWork();
@@ -73,20 +99,24 @@ public:
 };
 
 
-class MYSQL_API SelectMySQLQueryAsyncTask : public FNonAbandonableTask
+class MYSQL_API SelectMySQLQueryAsyncTask : public FMySQLSelfReleasingTask
 {
 
 	FString Query;
 	TWeakObjectPtr<AMySQLDBConnectionActor> CurrentDBConnectionActor;
 	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
 	int32 ConnectionID;
-	int32 QueryID;
+	int64 QueryID;
+	EMySQLResultLayout ResultLayout;
+	int32 BatchSize;
 	
 public:
 
 
 
-	SelectMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int32 queryID, FString query);
+	// A BatchSize above zero streams rows to OnQuerySelectBatchReceived instead of returning them all at once
+	SelectMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID, FString query,
+		EMySQLResultLayout resultLayout = EMySQLResultLayout::Both, int32 batchSize = 0);
 	virtual ~SelectMySQLQueryAsyncTask();
 	virtual void DoWork();
 
@@ -98,7 +128,60 @@ public:
 };
 
 
-class MYSQL_API UpdateMySQLImageAsyncTask : public FNonAbandonableTask
+class MYSQL_API SelectTypedMySQLQueryAsyncTask : public FMySQLSelfReleasingTask
+{
+
+	FString Query;
+	TArray<FMySQLParam> Params;
+	TWeakObjectPtr<AMySQLDBConnectionActor> CurrentDBConnectionActor;
+	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
+	int32 ConnectionID;
+	int64 QueryID;
+
+public:
+
+
+	SelectTypedMySQLQueryAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID,
+		FString query, TArray<FMySQLParam> params);
+	virtual ~SelectTypedMySQLQueryAsyncTask();
+	virtual void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(SelectTypedQueryAsyncTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+};
+
+
+class MYSQL_API BulkInsertMySQLAsyncTask : public FMySQLSelfReleasingTask
+{
+
+	FString Table;
+	TArray<FString> Columns;
+	TArray<FMySQLDataRow> Rows;
+	TWeakObjectPtr<AMySQLDBConnectionActor> CurrentDBConnectionActor;
+	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
+	int32 ConnectionID;
+	int64 QueryID;
+
+public:
+
+
+	BulkInsertMySQLAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID,
+		FString table, TArray<FString> columns, TArray<FMySQLDataRow> rows);
+	virtual ~BulkInsertMySQLAsyncTask();
+	virtual void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(BulkInsertAsyncTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+};
+
+
+class MYSQL_API UpdateMySQLImageAsyncTask : public FMySQLSelfReleasingTask
 {
 
 private:
@@ -108,15 +191,19 @@ private:
 	FString UpdateParameter;
 	int ParameterID;
 	FString ImagePath;
+	EMySQLImageEncoding Encoding;
+	TArray<uint8> ImageData;
 	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
 	
 	int32 ConnectionID;
-	int32 QueryID;
+	int64 QueryID;
 
 public:
 
 
-	UpdateMySQLImageAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int32 queryID, FString query, FString updateParameter, int parameterID, FString imagePath);
+	// Uploads imageData as-is when imagePath is empty; otherwise the file is read (and re-encoded) on the worker
+	UpdateMySQLImageAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID, int64 queryID, FString query, FString updateParameter, int parameterID, FString imagePath,
+		EMySQLImageEncoding encoding = EMySQLImageEncoding::Original, TArray<uint8> imageData = TArray<uint8>());
 
 	virtual ~UpdateMySQLImageAsyncTask();
 	virtual void DoWork();
@@ -129,7 +216,7 @@ public:
 };
 
 
-class MYSQL_API SelectMySQLImageAsyncTask : public FNonAbandonableTask
+class MYSQL_API SelectMySQLImageAsyncTask : public FMySQLSelfReleasingTask
 {
 
 private:
@@ -137,15 +224,18 @@ private:
 	FString Query;
 	TWeakObjectPtr<AMySQLDBConnectionActor> CurrentDBConnectionActor;
 	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
+	TSharedPtr<FMySQLImageCache, ESPMode::ThreadSafe> ImageCache;
 
 	int32 ConnectionID;
-	int32 QueryID;
+	int64 QueryID;
 
 public:
 
 
+	// Only the blob fetch holds the connection; decoding runs as a separate worker job and the
+	// texture is created on the game thread. imageCache may be null.
 	SelectMySQLImageAsyncTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID,
-		int32 queryID, FString query);
+		int64 queryID, FString query, TSharedPtr<FMySQLImageCache, ESPMode::ThreadSafe> imageCache = nullptr);
 
 	virtual ~SelectMySQLImageAsyncTask();
 	virtual void DoWork();
@@ -158,5 +248,28 @@ public:
 };
 
 
+// Pings an idle connection from the worker pool; queued like a query so it never overlaps one
+class MYSQL_API KeepAliveMySQLConnectionTask : public FMySQLSelfReleasingTask
+{
+
+private:
+
+	TWeakObjectPtr<AMySQLDBConnectionActor> CurrentDBConnectionActor;
+	TWeakObjectPtr<UMySQLDBConnector> MySQLDBConnector;
+
+	int32 ConnectionID;
+
+public:
+
+
+	KeepAliveMySQLConnectionTask(TWeakObjectPtr<AMySQLDBConnectionActor> dbConnectionActor, TWeakObjectPtr<UMySQLDBConnector> dbConnector, int32 connectionID);
+
+	virtual ~KeepAliveMySQLConnectionTask();
+	virtual void DoWork();
 
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(KeepAliveConnectionTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
 
+};
@@ -32,6 +32,147 @@ struct FMySQLDataRow
 };
 
 
+// Which shapes of a select result to build. Picking one halves the memory of large results.
+UENUM(BlueprintType)
+enum class EMySQLResultLayout : uint8
+{
+	Both,
+	ColumnsOnly,
+	RowsOnly
+};
+
+UENUM(BlueprintType)
+enum class EMySQLParamType : uint8
+{
+	Null,
+	Int,
+	Float,
+	String,
+	Bool,
+	Blob
+};
+
+/**
+* A single value bound to a '?' placeholder of a parameterized query.
+* Values are sent in the binary protocol, so they never need quoting or escaping.
+*/
+USTRUCT(BlueprintType, Category = "MySql|Tables")
+struct FMySQLParam
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLParam")
+		EMySQLParamType Type = EMySQLParamType::Null;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLParam")
+		int64 IntValue = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLParam")
+		double FloatValue = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLParam")
+		FString StringValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLParam")
+		TArray<uint8> BlobValue;
+};
+
+
+UENUM(BlueprintType)
+enum class EMySQLColumnType : uint8
+{
+	Int,
+	Float,
+	String,
+	Blob,
+	DateTime
+};
+
+/**
+* One column of a typed result. Values live in the array matching Type, one entry per row
+* (null rows hold a default value); NullBitmap has bit (Row % 8) of byte (Row / 8) set for nulls.
+* Blob rows are stored back to back in BlobData, row N spanning [BlobOffsets[N], BlobOffsets[N + 1]).
+*/
+USTRUCT(BlueprintType, Category = "MySql|Tables")
+struct FMySQLTypedColumn
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		FString Name;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		EMySQLColumnType Type = EMySQLColumnType::String;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<uint8> NullBitmap;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<int64> IntValues;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<double> FloatValues;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<FString> StringValues;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<FDateTime> DateTimeValues;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<uint8> BlobData;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedColumn")
+		TArray<int32> BlobOffsets;
+
+	bool IsNull(int32 Row) const
+	{
+		return NullBitmap.IsValidIndex(Row / 8) && (NullBitmap[Row / 8] & (1 << (Row % 8))) != 0;
+	}
+};
+
+// Result of a select run over the binary prepared-statement protocol
+USTRUCT(BlueprintType, Category = "MySql|Tables")
+struct FMySQLTypedResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedResult")
+		TArray<FMySQLTypedColumn> Columns;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLTypedResult")
+		int32 NumRows = 0;
+};
+
+// How image files are stored by the image update functions
+UENUM(BlueprintType)
+enum class EMySQLImageEncoding : uint8
+{
+	// The file's own bytes (PNG, JPEG or BMP), unchanged
+	Original,
+	PNG,
+	JPEG
+};
+
+// Outcome of one statement of a batch sent with ExecuteBatch
+USTRUCT(BlueprintType, Category = "MySql|Tables")
+struct FMySQLStatementResult
+{
+	GENERATED_BODY()
+
+	// False for the statement that failed and every statement after it (those were never run). In a transaction
+	// that was rolled back, false for every statement.
+	UPROPERTY(BlueprintReadOnly, Category = "SQLStatementResult")
+		bool IsSuccessful = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLStatementResult")
+		int64 AffectedRows = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLStatementResult")
+		FString ErrorMessage;
+};
+
+
 /**
 * Contains all the methods that are used to connect to the C# dll 
 * which takes care of connecting to the MySQL server and executing
@@ -48,10 +189,19 @@ class MYSQL_API UMySQLBPLibrary : public UBlueprintFunctionLibrary
 public:
 
 	static char* GetCharFromTextureData(UTexture2D *Texture, FString Path);
-	static UTexture2D* LoadTexturefromCharData(char* ImageChar);
+
+	// Decodes PNG, JPEG or BMP bytes to BGRA8. Thread-safe; the module is loaded by CreateImageWrapperModule at startup.
+	static bool DecodeImageData(const TArray<uint8>& ImageData, TArray<uint8>& OutBGRA, int32& OutWidth, int32& OutHeight);
+
+	// Game thread only. The pixels are uploaded when the render thread initializes the resource; nothing waits for it.
+	static UTexture2D* CreateTextureFromBGRA(const TArray<uint8>& BGRA, int32 Width, int32 Height);
 	
+	// Loads the ImageWrapper module once. Game thread only; FMySQLModule::StartupModule calls it.
 	static void CreateImageWrapperModule();
-	static char* GetRawImageFromPath(FString ImagePath);
+
+	// Loads an image file for upload, either as-is or re-encoded. Fails for files that are not PNG, JPEG or BMP.
+	// Thread-safe like DecodeImageData.
+	static bool GetImageBytesFromPath(const FString& ImagePath, EMySQLImageEncoding Encoding, TArray<uint8>& OutBytes, FString& ErrorMessage);
 
 	static bool SaveTextureToPath(UTexture2D* Texture, const FString Path);
 
@@ -61,6 +211,49 @@ public:
 	static char* GetCharfromFString(FString Query);
 	static TArray<FString> GetSplitStringArray(FString Input, FString Pattern);
 
+	UFUNCTION(BlueprintPure, Category = "MySql|Params")
+	static FMySQLParam MakeMySQLParamNull();
+
+	UFUNCTION(BlueprintPure, Category = "MySql|Params")
+	static FMySQLParam MakeMySQLParamInt(int64 Value);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|Params")
+	static FMySQLParam MakeMySQLParamFloat(double Value);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|Params")
+	static FMySQLParam MakeMySQLParamString(const FString& Value);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|Params")
+	static FMySQLParam MakeMySQLParamBool(bool Value);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|Params")
+	static FMySQLParam MakeMySQLParamBlob(const TArray<uint8>& Value);
+
+	// Index of the column called Name, or -1
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static int32 FindTypedColumn(const FMySQLTypedResult& Result, const FString& Name);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static bool IsTypedValueNull(const FMySQLTypedResult& Result, int32 Column, int32 Row);
+
+	// Float and DateTime (Unix seconds) columns are converted; anything else returns 0
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static int64 GetTypedInt(const FMySQLTypedResult& Result, int32 Column, int32 Row);
+
+	// Int columns are converted; anything else returns 0
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static double GetTypedFloat(const FMySQLTypedResult& Result, int32 Column, int32 Row);
+
+	// Any column type, formatted as text; nulls return an empty string
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static FString GetTypedString(const FMySQLTypedResult& Result, int32 Column, int32 Row);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static FDateTime GetTypedDateTime(const FMySQLTypedResult& Result, int32 Column, int32 Row);
+
+	UFUNCTION(BlueprintPure, Category = "MySql|TypedResult")
+	static TArray<uint8> GetTypedBlob(const FMySQLTypedResult& Result, int32 Column, int32 Row);
+
 
 
 
@@ -0,0 +1,79 @@
+// Copyright Athian Games. All Rights Reserved. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "MySQLMain.h"
+#include "MySQLConnectionPoolSubsystem.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FMySQLPoolStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "MySQL Pool")
+	FString DSN;
+
+	UPROPERTY(BlueprintReadOnly, Category = "MySQL Pool")
+	int32 IdleConnections = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "MySQL Pool")
+	int32 LeasedConnections = 0;
+};
+
+/**
+* Owns MySQL connection pools for the lifetime of the game instance, so open connections survive
+* level travel instead of being re-handshaken on every map load. A pool is only shared by connections whose
+* settings match exactly, password and options included; stats name it by DSN (user, server, port, database),
+* which never contains secrets. AMySQLDBConnectionActor leases its handles from here when bUseConnectionPool is set.
+*/
+UCLASS(Config=Game)
+class MYSQL_API UMySQLConnectionPoolSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Connections kept open per DSN even when idle
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "MySQL Pool", meta=(ClampMin="0"))
+	int32 MinConnectionsPerDSN = 0;
+
+	// Upper bound on open connections per DSN. Connecting once all of them are in use fails with an error rather than
+	// waiting, since a connection holds its lease until it is closed.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "MySQL Pool", meta=(ClampMin="1"))
+	int32 MaxConnectionsPerDSN = 8;
+
+	// Idle connections above the minimum are closed after this long
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "MySQL Pool", meta=(ClampMin="1"))
+	float IdleTimeoutSeconds = 300.f;
+
+	// How often idle connections are reaped and the minimum is topped up
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "MySQL Pool", meta=(ClampMin="1"))
+	float MaintenanceIntervalSeconds = 30.f;
+
+	// Returns the pool for these connect settings, creating it with the current limits. Game thread only.
+	shared_ptr<FMySQLConnectionPool> GetOrCreatePool(const FString& Server, const FString& DBName, const FString& UserID, const FString& Password,
+	                                                 int32 Port, const TArray<FMySQLOptionPair>& Options);
+
+	// Changes the limits for new pools and every existing one
+	UFUNCTION(BlueprintCallable, Category = "MySQL Pool")
+	void SetPoolLimits(int32 MinConnections, int32 MaxConnections, float IdleTimeout);
+
+	UFUNCTION(BlueprintPure, Category = "MySQL Pool")
+	TArray<FMySQLPoolStats> GetPoolStats() const;
+
+private:
+
+	bool RunMaintenance(float DeltaTime);
+	void ApplyLimits(FMySQLConnectionPool& Pool) const;
+
+	// Keyed by DSN; pools under one DSN differ in password or options
+	TMap<FString, TArray<shared_ptr<FMySQLConnectionPool>>> Pools;
+	FTSTicker::FDelegateHandle MaintenanceHandle;
+};
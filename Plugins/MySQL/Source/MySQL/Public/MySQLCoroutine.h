@@ -0,0 +1,265 @@
+// Copyright Athian Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "MySQLBPLibrary.h"
+
+#include <coroutine>
+#include <type_traits>
+
+class AMySQLDBConnectionActor;
+class UMySQLDBConnector;
+
+
+/**
+* Return type of coroutines that use the awaitable query API. The coroutine starts running as soon as it is
+* called and continues on whichever thread finished the last thing it awaited, so a chain of queries stays on
+* the worker that ran them. Use Then() to get the result back on the game thread, or co_await the task from
+* another coroutine (one of the two, once).
+*/
+template <typename T = void>
+class TMySQLTask
+{
+	typedef std::conditional_t<std::is_void_v<T>, bool, T> FStoredType;
+
+	struct FState
+	{
+		FCriticalSection Mutex;
+		TOptional<FStoredType> Value;
+		bool bIsDone = false;
+		TUniqueFunction<void()> Continuation;
+
+		void Finish()
+		{
+			TUniqueFunction<void()> ToRun;
+			{
+				FScopeLock Lock(&Mutex);
+				bIsDone = true;
+				ToRun = MoveTemp(Continuation);
+			}
+			if (ToRun)
+			{
+				ToRun();
+			}
+		}
+
+		// False if the coroutine already finished; OnDone is dropped and the caller continues itself
+		bool SetContinuation(TUniqueFunction<void()>&& OnDone)
+		{
+			FScopeLock Lock(&Mutex);
+			if (bIsDone)
+			{
+				return false;
+			}
+			Continuation = MoveTemp(OnDone);
+			return true;
+		}
+	};
+
+	typedef TSharedRef<FState, ESPMode::ThreadSafe> FStateRef;
+
+	struct FPromiseBase
+	{
+		FStateRef State = MakeShared<FState, ESPMode::ThreadSafe>();
+
+		TMySQLTask get_return_object() { return TMySQLTask(State); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { State->Finish(); return {}; }
+		void unhandled_exception() { checkf(false, TEXT("Unhandled exception in a MySQL coroutine")); }
+	};
+
+	struct FValuePromise : FPromiseBase
+	{
+		void return_value(FStoredType InValue) { this->State->Value.Emplace(MoveTemp(InValue)); }
+	};
+
+	struct FVoidPromise : FPromiseBase
+	{
+		void return_void() {}
+	};
+
+	FStateRef State;
+
+	explicit TMySQLTask(const FStateRef& InState) : State(InState) {}
+
+public:
+
+	typedef std::conditional_t<std::is_void_v<T>, FVoidPromise, FValuePromise> promise_type;
+
+	bool IsDone() const
+	{
+		FScopeLock Lock(&State->Mutex);
+		return State->bIsDone;
+	}
+
+	// Runs OnCompleted on the game thread once the coroutine has finished, passing the co_returned value if there is one
+	template <typename FunctorType>
+	void Then(FunctorType&& OnCompleted)
+	{
+		TUniqueFunction<void()> Deliver = [Captured = State, OnCompleted = Forward<FunctorType>(OnCompleted)]() mutable
+		{
+			AsyncTask(ENamedThreads::GameThread, [Captured, OnCompleted = MoveTemp(OnCompleted)]() mutable
+			{
+				if constexpr (std::is_void_v<T>)
+				{
+					OnCompleted();
+				}
+				else
+				{
+					OnCompleted(MoveTemp(Captured->Value.GetValue()));
+				}
+			});
+		};
+
+		// Only consumed when stored
+		if (!State->SetContinuation(MoveTemp(Deliver)))
+		{
+			Deliver();
+		}
+	}
+
+	bool await_ready() const { return IsDone(); }
+
+	bool await_suspend(std::coroutine_handle<> Awaiting)
+	{
+		return State->SetContinuation([Awaiting]() { Awaiting.resume(); });
+	}
+
+	T await_resume()
+	{
+		if constexpr (!std::is_void_v<T>)
+		{
+			return MoveTemp(State->Value.GetValue());
+		}
+	}
+};
+
+
+// co_await FMySQLResumeOnGameThread() to continue on the game thread, e.g. to touch actors with the results
+struct FMySQLResumeOnGameThread
+{
+	bool await_ready() const { return IsInGameThread(); }
+	void await_suspend(std::coroutine_handle<> Awaiting) const { AsyncTask(ENamedThreads::GameThread, [Awaiting]() { Awaiting.resume(); }); }
+	void await_resume() const {}
+};
+
+
+// What co_await on a session query produces. Result is only filled by FMySQLSession::Query.
+struct FMySQLQueryOutcome
+{
+	bool IsSuccessful = false;
+	FString ErrorMessage;
+	FMySQLTypedResult Result;
+};
+
+
+class FMySQLSession;
+
+// The connection a granted session runs on, shared with its actor. Mutex is held for the whole of every session
+// query, so Revoke() waits for a running one and no query starts after it; the actor revokes before closing handles.
+struct FMySQLSessionLease
+{
+	FCriticalSection Mutex;
+
+	// Resolved on the game thread when the session is granted, null once revoked
+	UMySQLDBConnector* Connector = nullptr;
+
+	explicit FMySQLSessionLease(UMySQLDBConnector* InConnector) : Connector(InConnector) {}
+
+	void Revoke()
+	{
+		FScopeLock Lock(&Mutex);
+		Connector = nullptr;
+	}
+};
+
+typedef TSharedPtr<FMySQLSessionLease, ESPMode::ThreadSafe> FMySQLSessionLeasePtr;
+
+// Awaitable returned by FMySQLSession::Query and Execute. Runs inline when awaited off the game thread,
+// otherwise on a worker where the coroutine then continues.
+class MYSQL_API FMySQLSessionQuery
+{
+	FMySQLSession* Session;
+	FString Sql;
+	TArray<FMySQLParam> Params;
+	bool bIsSelect;
+	FMySQLQueryOutcome Outcome;
+
+public:
+
+	FMySQLSessionQuery(FMySQLSession* InSession, const FString& InSql, const TArray<FMySQLParam>& InParams, bool bInIsSelect);
+
+	bool await_ready() const { return false; }
+	bool await_suspend(std::coroutine_handle<> Awaiting);
+	FMySQLQueryOutcome await_resume() { return MoveTemp(Outcome); }
+};
+
+
+/**
+* Exclusive use of one connection, obtained with co_await Actor->OpenSession(ConnectionID). The connection's
+* query queue waits until the session is released (or destroyed), so the queries in between run back to back
+* with nothing interleaved and no game-thread round trip between them. The session counts as one query handle
+* for WhenAll, successful if every query on it was.
+*/
+class MYSQL_API FMySQLSession
+{
+public:
+
+	FMySQLSession() = default;
+	FMySQLSession(TWeakObjectPtr<AMySQLDBConnectionActor> InActor, const FMySQLSessionLeasePtr& InLease, int32 InConnectionID, int64 InQueryID);
+	FMySQLSession(FMySQLSession&& Other);
+	FMySQLSession& operator=(FMySQLSession&& Other);
+	FMySQLSession(const FMySQLSession&) = delete;
+	FMySQLSession& operator=(const FMySQLSession&) = delete;
+	~FMySQLSession();
+
+	// False when the connection is gone or could not be used from here; every query on it then fails. A session
+	// is also revoked when its actor ends play, its queries fail from then on.
+	bool IsValid() const { return bIsHeld; }
+
+	int32 GetConnectionID() const { return ConnectionID; }
+	int64 GetQueryID() const { return QueryID; }
+
+	// Select over the binary protocol; Params bind to '?' placeholders
+	FMySQLSessionQuery Query(const FString& Sql, const TArray<FMySQLParam>& Params = TArray<FMySQLParam>()) { return FMySQLSessionQuery(this, Sql, Params, true); }
+
+	// Statement without a result set
+	FMySQLSessionQuery Execute(const FString& Sql, const TArray<FMySQLParam>& Params = TArray<FMySQLParam>()) { return FMySQLSessionQuery(this, Sql, Params, false); }
+
+	// Lets the connection's next queued query run; the session is invalid afterwards
+	void Release();
+
+private:
+
+	friend class FMySQLSessionQuery;
+
+	// Blocking; called on a worker
+	FMySQLQueryOutcome Run(const FString& Sql, const TArray<FMySQLParam>& Params, bool bIsSelect);
+
+	TWeakObjectPtr<AMySQLDBConnectionActor> Actor;
+	FMySQLSessionLeasePtr Lease;
+	int32 ConnectionID = -1;
+	int64 QueryID = -1;
+	bool bIsHeld = false;
+	bool bAllSuccessful = true;
+};
+
+
+// Awaitable returned by AMySQLDBConnectionActor::OpenSession; produces the session on a worker thread
+class MYSQL_API FMySQLSessionAwaitable
+{
+	TWeakObjectPtr<AMySQLDBConnectionActor> Actor;
+	int32 ConnectionID;
+	FMySQLSession Session;
+
+public:
+
+	FMySQLSessionAwaitable(TWeakObjectPtr<AMySQLDBConnectionActor> InActor, int32 InConnectionID);
+
+	bool await_ready() const { return false; }
+	void await_suspend(std::coroutine_handle<> Awaiting);
+	FMySQLSession await_resume() { return MoveTemp(Session); }
+};
@@ -7,6 +7,8 @@
 #include "MySQLBPLibrary.h"
 #include "MySQLAsyncTasks.h"
 #include "MySQLDBConnector.h"
+#include "MySQLQueryRegistry.h"
+#include "MySQLCoroutine.h"
 
 #include "MySQLDBConnectionActor.generated.h"
 
@@ -16,7 +18,13 @@ enum EQueryType
     Update,
     Select,
     Close,
-    Endplay
+    Endplay,
+    ImageUpdate,
+    ImageSelect,
+    KeepAlive,
+    TypedSelect,
+    BulkInsert,
+    Session
 };
 
 UENUM(BlueprintType)
@@ -41,11 +49,34 @@ struct FQueryTaskData
     GENERATED_BODY()
     
     int32 ConnectionID;
-    int32 QueryID;
+    int64 QueryID;
     TArray<FString> Queries;
         
     EQueryType QueryType; // Define an enumeration EQueryType with values like Select, Update, etc.
-    // Add any other required parameters for the query
+
+    // Bound to '?' placeholders of Queries[0] (Update and TypedSelect)
+    TArray<FMySQLParam> Params;
+
+    // Only used by Update; wraps a batch of Queries in one transaction
+    bool bUseTransaction = false;
+
+    // Only used by BulkInsert (the table name is Queries[0])
+    TArray<FString> Columns;
+    TArray<FMySQLDataRow> Rows;
+
+    // Only used by Select
+    EMySQLResultLayout ResultLayout = EMySQLResultLayout::Both;
+    int32 BatchSize = 0;
+
+    // Only used by ImageUpdate; ImageData is uploaded when ImagePath is empty
+    FString UpdateParameter;
+    int32 ParameterID = 0;
+    FString ImagePath;
+    EMySQLImageEncoding ImageEncoding = EMySQLImageEncoding::Original;
+    TArray<uint8> ImageData;
+
+    // Only used by Session; called on the game thread with the session, or an invalid one if the task is dropped
+    TFunction<void(FMySQLSession&&)> OnSessionGranted;
 
     friend bool operator==(const FQueryTaskData& lhs, const FQueryTaskData& rhs)
     {
@@ -53,6 +84,65 @@ struct FQueryTaskData
     }
 };
 
+// Pending work for a single connection. Queries run in submission order and at most one
+// query per MySQL handle is in flight; different connections run in parallel.
+struct FMySQLConnectionQueue
+{
+    TArray<FQueryTaskData> Pending;
+    bool bInFlight = false;
+    int32 PeakPending = 0;
+    int32 Completed = 0;
+
+    // FPlatformTime::Seconds() when the last task on this connection finished
+    double LastActivityTime = 0.0;
+};
+
+// Server side of a select result being paged to the owning client
+struct FMySQLOutgoingResult
+{
+    // Column layout only, compressed when that makes it smaller
+    TArray<uint8> Payload;
+    int32 ChunkSize = 0;
+    int32 NumChunks = 0;
+    int32 NextChunk = 0;
+    int32 NumAcked = 0;
+};
+
+// Client side reassembly of a paged select result
+struct FMySQLIncomingResult
+{
+    int32 ConnectionID = -1;
+    bool IsSuccessful = false;
+    FString ErrorMessage;
+    int32 UncompressedSize = 0;
+    int32 PayloadSize = 0;
+    bool bIsCompressed = false;
+    TArray<uint8> Payload;
+};
+
+USTRUCT(BlueprintType)
+struct FMySQLQueueMetrics
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "MySql Server")
+    int32 ConnectionID = -1;
+
+    // Queries waiting behind the in-flight one
+    UPROPERTY(BlueprintReadOnly, Category = "MySql Server")
+    int32 PendingQueries = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "MySql Server")
+    bool bQueryInFlight = false;
+
+    // Highest PendingQueries seen since the connection was opened
+    UPROPERTY(BlueprintReadOnly, Category = "MySql Server")
+    int32 PeakPendingQueries = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "MySql Server")
+    int32 CompletedQueries = 0;
+};
+
 // Query request structure for client->server communication
 USTRUCT()
 struct FQueryRequest
@@ -67,6 +157,17 @@ struct FQueryRequest
     
     UPROPERTY()
     bool bIsSelectQuery;
+
+    // Values for '?' placeholders in QueryString
+    UPROPERTY()
+    TArray<FMySQLParam> Params;
+
+    // Sent instead of QueryString for UpdateDataFromMultipleQueries, so the server runs them as one batch
+    UPROPERTY()
+    TArray<FString> BatchQueries;
+
+    UPROPERTY()
+    bool bUseTransaction = false;
     
     // For image queries
     UPROPERTY()
@@ -77,6 +178,9 @@ struct FQueryRequest
     
     UPROPERTY()
     FString ImagePath;
+
+    UPROPERTY()
+    EMySQLImageEncoding ImageEncoding = EMySQLImageEncoding::Original;
     
     UPROPERTY()
     bool bIsImageQuery;
@@ -89,51 +193,66 @@ struct FClientRequest
     GENERATED_BODY()
     
     UPROPERTY()
-    int32 QueryID;
+    int64 QueryID;
     
     UPROPERTY()
     AActor* RequestingClient;
 };
 
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FMySQLQueriesCompleted, const TArray<int64>&, QueryIDs, bool, AllSuccessful);
+
 UCLASS()
 class MYSQL_API AMySQLDBConnectionActor : public AActor
 {
     GENERATED_BODY()
     
-    TMap<int32, int32> ConnectionToNextQueryIDMap;
+    // Handle of the most recent query queued on each connection
+    TMap<int32, int64> ConnectionToLastQueryIDMap;
+
+    FMySQLQueryRegistry QueryRegistry;
     
    
+    // Started tasks that have not yet run their game-thread completion callback
+    TSet<FAsyncTaskBase*> ActiveTasks;
+
+    // Connections handed to sessions; revoked by CloseAllConnections (and so EndPlay) before the handles are closed
+    TArray<TWeakPtr<FMySQLSessionLease, ESPMode::ThreadSafe>> SessionLeases;
+
 template<typename TaskType, typename... Args>
 FAsyncTask<TaskType>* StartAsyncTask(Args&&... args)
 {
     TaskType Task(std::forward<Args>(args)...);
     FAsyncTask<TaskType>* AsyncTask = new FAsyncTask<TaskType>(std::move(Task));
+    AsyncTask->GetTask().OwningTask = AsyncTask;
+    ActiveTasks.Add(AsyncTask);
+    bIsConnectionBusy = true;
     AsyncTask->StartBackgroundTask();
     return AsyncTask;
 }
-
-template<class T>
-void CleanUpFinishedTasks(TArray<FAsyncTask<T>*> &TaskArray)
-{
-    for (int32 Index = 0; Index < TaskArray.Num(); ++Index)
-    {
-        FAsyncTask<T>* Task = TaskArray[Index];
-        if (Task->IsDone())
-        {
-            delete Task;
-            TaskArray.RemoveAt(Index--);
-        }
-    }
-}
     
 public:
 
     
     // Map to track which queries were requested by which clients
-    TMap<int32, FClientRequest> ClientRequestMap;
+    TMap<int64, FClientRequest> ClientRequestMap;
 
-    
-    int32 GenerateQueryID(int32 ConnectionID);
+    // Connections opened on behalf of a client, keyed by ConnectionID
+    TMap<int32, FClientRequest> ClientConnectionRequestMap;
+
+    // Returns a process-wide unique handle and remembers it as the connection's last query
+    int64 GenerateQueryID(int32 ConnectionID);
+
+    // Waiting on query handles from C++; see WhenAll for Blueprints
+    FMySQLQueryRegistry& GetQueryRegistry() { return QueryRegistry; }
+
+    /**
+    * C++ coroutines: FMySQLSession Db = co_await Actor->OpenSession(ConnectionID); then co_await Db.Query(...)
+    * and Db.Execute(...). The session takes its turn in the connection's queue like any query and holds it until released.
+    */
+    FMySQLSessionAwaitable OpenSession(int32 ConnectionID);
+
+    // Used by FMySQLSessionAwaitable; queues a session task on ConnectionID
+    void EnqueueSession(int32 ConnectionID, TFunction<void(FMySQLSession&&)> OnGranted);
 
     AMySQLDBConnectionActor();
 
@@ -144,30 +263,73 @@ protected:
 
     UMySQLDBConnector* GetConnector(int32 ConnectionID);
 
-    TArray<FAsyncTask<OpenMySQLConnectionTask>*> OpenConnectionTasks;
-    TArray<FAsyncTask<UpdateMySQLQueryAsyncTask>*> UpdateQueryTasks;
-    TArray<FAsyncTask<SelectMySQLQueryAsyncTask>*> SelectQueryTasks;
-    TArray<FAsyncTask<UpdateMySQLImageAsyncTask>*> UpdateImageQueryTasks;
-    TArray<FAsyncTask<SelectMySQLImageAsyncTask>*> SelectImageQueryTasks;
     
 private:
     
-    // Declare a queue to store the pending query tasks
-    TArray<FQueryTaskData> QueryTaskQueue;
+    // Per-connection FIFO queues of pending query tasks
+    TMap<int32, FMySQLConnectionQueue> ConnectionQueues;
+
+    bool bHasEndedPlay = false;
 
-    // Declare a boolean to indicate whether a query task is currently running
-    bool bIsQueryTaskRunning;
     void CreateTaskData(int32 ConnectionID, TArray<FString> Queries, EQueryType QueryType);
+    void EnqueueQueryTask(FQueryTaskData&& TaskData);
+
+    // Starts the oldest pending task for ConnectionID if nothing is in flight on it
+    void DispatchQueryTask(int32 ConnectionID);
+
+    // Fails a task that will never run, so its waiters and session coroutine are not left hanging
+    void AbandonQueryTask(FQueryTaskData& TaskData);
+
+    FTimerHandle KeepAliveTimer;
+
+    // Queues a ping on every connection that has been idle for KeepAliveIntervalSeconds
+    void SendKeepAlives();
 
     UMySQLDBConnector* CreateDBConnector(int32& ConnectionID);
 
+    // Points the connector at the game instance's shared pool for these settings when bUseConnectionPool is set
+    void AttachConnectionPool(UMySQLDBConnector* Connector, const FString& Server, const FString& DBName, const FString& UserID,
+                              const FString& Password, int32 Port, const TArray<FMySQLOptionPair>& Options);
+
+    // Created on the first image select; shared with the tasks that fill it
+    TSharedPtr<FMySQLImageCache, ESPMode::ThreadSafe> ImageCache;
+
+    // Keyed by QueryID
+    TMap<int64, FMySQLOutgoingResult> OutgoingResults;
+    TMap<int64, FMySQLIncomingResult> IncomingResults;
+
+    void StartOutgoingResult(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage, int32 UncompressedSize,
+                             bool bIsCompressed, TArray<uint8>&& Payload);
+
+    // Sends pages of QueryID until the window is full; forgets the result once every page was acknowledged
+    void PumpOutgoingResult(int64 QueryID);
+
+    void FinishIncomingResult(int64 QueryID);
+
     static void CopyDLL(FString DLLName);
 
 public:    
 
-    // Method to initiate execution of next query in the queue
-    void ExecuteNextQueryTask();
-    void ResetLastConnection();
+    // Called on the game thread when a query task finishes; starts the next one on that connection
+    void OnQueryTaskCompleted(int32 ConnectionID);
+
+    // Called on the game thread once a query's results have been delivered; resolves its WhenAll waiters
+    void OnQueryResultDelivered(int64 QueryID, bool IsSuccessful);
+
+    // Called on the game thread when an open-connection task finishes. A failed open drops the connector for
+    // ConnectionID and fails the queries queued on it.
+    void OnConnectionOpened(int32 ConnectionID, bool ConnectionStatus);
+
+    // Called on the game thread when a keepalive ping finishes
+    void OnKeepAliveCompleted(int32 ConnectionID, bool bIsAlive, const FString& ErrorMessage);
+
+    // Set by EndPlay; results that arrive afterwards are dropped instead of broadcast
+    bool HasEndedPlay() const { return bHasEndedPlay; }
+
+    // Called by a finished task right before it deletes itself
+    void OnAsyncTaskReleased(FAsyncTaskBase* Task);
+    // Destroys the connector for ConnectionID, freeing the ID for the next connection
+    void ResetConnection(int32 ConnectionID);
 
     UPROPERTY()
         bool bIsConnectionBusy;
@@ -203,27 +365,43 @@ public:
     UFUNCTION(Server, Reliable, WithValidation)
     void ServerExecuteImageQuery(const FQueryRequest& QueryRequest);
 
+    // Select results for the owning client are encoded (one layout, compressed) off the game thread and sent as
+    // ResultChunkSize pages, at most ResultChunkWindow of them unacknowledged at a time
+    void SendQueryResultsToClient(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+                                  const TArray<FMySQLDataTable>& ResultByColumn, const TArray<FMySQLDataRow>& ResultByRow);
+
     // Client-side callback functions (for receiving results from server)
     UFUNCTION(Client, Reliable)
-    void ClientReceiveQueryResults(int32 ConnectionID, int32 QueryID, bool IsSuccessful, 
-                                  const FString& ErrorMessage, const TArray<FMySQLDataTable>& ResultByColumn, 
-                                  const TArray<FMySQLDataRow>& ResultByRow);
+    void ClientBeginQueryResults(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+                                 int32 UncompressedSize, int32 PayloadSize, bool bIsCompressed);
+
+    UFUNCTION(Client, Reliable)
+    void ClientReceiveQueryResultChunk(int64 QueryID, const TArray<uint8>& Chunk);
+
+    UFUNCTION(Server, Reliable, WithValidation)
+    void ServerAckQueryResultChunk(int64 QueryID);
+
+    // Bytes per result page sent to clients; keep well under the RPC size limit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replication", meta=(ClampMin="1024", ClampMax="60000"))
+    int32 ResultChunkSize = 16 * 1024;
+
+    // Result pages a client may have unacknowledged before the server waits, so one large select
+    // cannot flood the reliable channel
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replication", meta=(ClampMin="1"))
+    int32 ResultChunkWindow = 4;
 
     UFUNCTION(Client, Reliable)
-    void ClientReceiveUpdateStatus(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage);
+    void ClientReceiveUpdateStatus(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage);
 
     UFUNCTION(Client, Reliable)
-    void ClientReceiveImageSelectStatus(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage, 
+    void ClientReceiveImageSelectStatus(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage, 
                                        UTexture2D* SelectedTexture);
 
     UFUNCTION(Client, Reliable)
-    void ClientReceiveImageUpdateStatus(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage);
+    void ClientReceiveImageUpdateStatus(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage);
 
     FTimerHandle SelectDataTaskTimer;
     
-    // Called every frame
-    virtual void Tick(float DeltaTime) override;
-    
     /**
     * Creates a New Database Connection
     */
@@ -233,6 +411,35 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions")
     UMySQLConnectionOptions* MySQLOptionsAsset;
 
+    // Prepared statements of ExecuteParams and SelectTypedFromQuery cached per connection (least recently used are
+    // closed first). Plain query strings run over the text protocol and never take a slot.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions", meta=(ClampMin="1"))
+    int32 PreparedStatementCacheSize = 32;
+
+    // Connections used within this many seconds run queries without a mysql_ping round trip first (0 = ping every query)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions", meta=(ClampMin="0"))
+    float ConnectionIdleCheckSeconds = 30.f;
+
+    // Idle connections are pinged at this interval so the server's wait_timeout never closes them (0 = disabled)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions", meta=(ClampMin="0"))
+    float KeepAliveIntervalSeconds = 60.f;
+
+    // BulkInsert switches from multi-row INSERTs to LOAD DATA LOCAL INFILE at this many rows (0 = never). The server
+    // needs local_infile enabled; otherwise it falls back to INSERTs.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions", meta=(ClampMin="0"))
+    int32 BulkInsertLoadDataThreshold = 10000;
+
+    // Megabytes of decoded images kept per connection and query, so repeated SelectImageFromQuery calls skip the fetch
+    // and decode (0 = disabled). Successful image updates through this actor clear it; call ClearImageCache after
+    // changing images any other way.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions", meta=(ClampMin="0"))
+    int32 ImageCacheSizeMB = 0;
+
+    // Lease connections from UMySQLConnectionPoolSubsystem, so they are reused across actors and survive level travel.
+    // CloseConnection then returns the handle to the pool instead of closing it.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MySQLOptions")
+    bool bUseConnectionPool = false;
+
     UFUNCTION(BlueprintCallable, Category = "MySql Server")
         void CloseAllConnections();
 
@@ -242,18 +449,35 @@ public:
     UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
         void OnConnectionStateChanged(bool ConnectionStatus, int32 ConnectionID, const FString& ErrorMessage);
 
+    // Handle of the most recent query queued on ConnectionID, or -1
     UFUNCTION(BlueprintPure, Category = "MySql Server")
-    int32 GetLastQueryID(int32 ConnectionID);
+    int64 GetLastQueryID(int32 ConnectionID);
 
     UFUNCTION(BlueprintPure, Category = "MySql Server")
-    bool CheckIsQueryRunning()
-    {
-        return bIsQueryTaskRunning;
-    }
+    bool IsQueryPending(int64 QueryID) const;
+
+    /**
+    * Calls OnCompleted once every query in QueryIDs has delivered its results, right away if they all already have.
+    * AllSuccessful is false if any of them failed, was dropped, or is not a query of this actor.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MySql Server")
+    void WhenAll(const TArray<int64>& QueryIDs, const FMySQLQueriesCompleted& OnCompleted);
+
+    UFUNCTION(BlueprintPure, Category = "MySql Server")
+    bool CheckIsQueryRunning();
+
+    // Number of queries waiting (not yet started) on ConnectionID
+    UFUNCTION(BlueprintPure, Category = "MySql Server")
+    int32 GetPendingQueryCount(int32 ConnectionID) const;
+
+    // Queue depth and throughput for every open connection
+    UFUNCTION(BlueprintPure, Category = "MySql Server")
+    TArray<FMySQLQueueMetrics> GetQueueMetrics() const;
 
     bool HandleQueryExecutionContext(int32 ConnectionID, EQueryExecutionContext ExecutionContext, 
                                 bool bIsSelectQuery, const FString& Query, 
-                                FString& OutErrorMessage);
+                                FString& OutErrorMessage,
+                                const TArray<FMySQLParam>& Params = TArray<FMySQLParam>());
 
 
 
@@ -264,41 +488,110 @@ public:
     void UpdateDataFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
 
 
+    /**
+    * Executes a parameterized query. Use '?' placeholders in Query; Params are bound in order.
+    * Prepared statements are cached per connection, so repeating the same Query skips the parse step.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext"))
+    void ExecuteParams(int32 ConnectionID, FString Query, TArray<FMySQLParam> Params, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
+
     UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
-        void OnQueryUpdateStatusChanged(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage);
+        void OnQueryUpdateStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage);
 
 
     /**
     * Selects data from the database
+    * ResultLayout can skip building ResultByColumn or ResultByRow for large results.
    */
-    UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext"))
-    void SelectDataFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
+    UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext,ResultLayout"))
+    void SelectDataFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default,
+        EMySQLResultLayout ResultLayout = EMySQLResultLayout::Both);
+
+    /**
+    * Selects data without buffering the whole result. Rows are read off the connection as they arrive and
+    * delivered to OnQuerySelectBatchReceived in batches of BatchSize; OnQuerySelectStatusChanged then reports
+    * completion with empty result arrays. Runs locally only; the connection is busy until every row is read.
+   */
+    UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ResultLayout"))
+    void SelectDataStreaming(int32 ConnectionID, FString Query, int32 BatchSize = 500, EMySQLResultLayout ResultLayout = EMySQLResultLayout::Both);
+
+    /**
+    * Selects data over the binary protocol. Numbers, dates and blobs arrive in typed column buffers with a
+    * null bitmap instead of as text; read them with the GetTyped* functions. Use '?' placeholders for Params.
+    * Runs locally only.
+   */
+    UFUNCTION(BlueprintCallable, Category = "MySql Server")
+    void SelectTypedFromQuery(int32 ConnectionID, FString Query, TArray<FMySQLParam> Params);
+
+    /**
+    * Inserts Rows (one value per column, in Columns order) into Table within a single transaction. Rows are packed
+    * into multi-row INSERTs sized to the server's max_allowed_packet, or streamed with LOAD DATA LOCAL INFILE for
+    * loads of at least BulkInsertLoadDataThreshold rows. A value of exactly "NULL" inserts SQL NULL, as selects report
+    * it. Runs locally only.
+   */
+    UFUNCTION(BlueprintCallable, Category = "MySql Server")
+    void BulkInsert(int32 ConnectionID, FString Table, TArray<FString> Columns, TArray<FMySQLDataRow> Rows);
+
+    UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
+        void OnBulkInsertStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage, int64 InsertedRows);
+
+    UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
+        void OnQueryTypedSelectStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+            const FMySQLTypedResult& Result);
+
+    UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
+        void OnQuerySelectBatchReceived(int32 ConnectionID, int64 QueryID, int32 BatchIndex, const TArray<FMySQLDataTable>& ResultByColumn,
+            const TArray<FMySQLDataRow>& ResultByRow);
     
 
     UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
-        void OnQuerySelectStatusChanged(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage, const TArray<FMySQLDataTable>& ResultByColumn, 
+        void OnQuerySelectStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage, const TArray<FMySQLDataTable>& ResultByColumn, 
             const TArray<FMySQLDataRow>& ResultByRow);
 
 
+    /**
+    * Sends all Queries to the server in a single round trip; execution stops at the first failing statement.
+    * With UseTransaction the batch is committed as a whole or rolled back. OnQueryUpdateStatusChanged reports the
+    * overall status and OnQueryBatchStatusChanged the status and affected rows of each query.
+    * Results are matched to queries by statement, so each query string must contain exactly one statement.
+    */
     UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext"))
-    void UpdateDataFromMultipleQueries(int32 ConnectionID, TArray<FString> Queries, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
+    void UpdateDataFromMultipleQueries(int32 ConnectionID, TArray<FString> Queries, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default,
+        bool UseTransaction = false);
+
+    UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
+        void OnQueryBatchStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage,
+            const TArray<FMySQLStatementResult>& StatementResults);
 
     UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext"))
     void SelectImageFromQuery(int32 ConnectionID, FString Query, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
 
-    UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext"))
-    void UpdateImageFromPath(int32 ConnectionID, FString Query, FString UpdateParameter, int ParameterID, FString ImagePath, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
+    /**
+    * Stores the image file through the query's single '?' placeholder. Original keeps the file's compressed bytes;
+    * PNG or JPEG re-encode it first.
+    */
+    UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext,Encoding"))
+    void UpdateImageFromPath(int32 ConnectionID, FString Query, FString UpdateParameter, int ParameterID, FString ImagePath, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default,
+        EMySQLImageEncoding Encoding = EMySQLImageEncoding::Original);
+
+    // Stores already-encoded image bytes through the query's single '?' placeholder. Runs locally only.
+    UFUNCTION(BlueprintCallable, Category = "MySql Server")
+    void UpdateImageFromBytes(int32 ConnectionID, FString Query, TArray<uint8> ImageData);
 
     UFUNCTION(BlueprintCallable, Category = "MySql Server", meta=(AdvancedDisplay="ExecutionContext"))
     bool UpdateImageFromTexture(int32 ConnectionID, FString Query, FString UpdateParameter, int ParameterID, UTexture2D* Texture, EQueryExecutionContext ExecutionContext = EQueryExecutionContext::Default);
 
     
     UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
-        void OnImageUpdateStatusChanged(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage);
+        void OnImageUpdateStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage);
 
  
+    // Drops every decoded image, e.g. after the images behind cached queries were changed by other means
+    UFUNCTION(BlueprintCallable, Category = "MySql Server")
+    void ClearImageCache();
+
     UFUNCTION(BlueprintImplementableEvent, Category = "MySql Server")
-        void OnImageSelectStatusChanged(int32 ConnectionID, int32 QueryID, bool IsSuccessful, const FString& ErrorMessage, UTexture2D* SelectedTexture);
+        void OnImageSelectStatusChanged(int32 ConnectionID, int64 QueryID, bool IsSuccessful, const FString& ErrorMessage, UTexture2D* SelectedTexture);
 
     
 };
\ No newline at end of file
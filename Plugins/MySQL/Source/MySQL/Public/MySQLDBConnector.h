@@ -15,12 +15,24 @@ class MYSQL_API UMySQLDBConnector : public UObject
 
 	UMySQLDBConnector();
 
-	TMap<int, int> QueryToConnectionMap;
+	TMap<int64, int32> QueryToConnectionMap;
 	
 	
 public:
 
 	MySQLConnection* mysqlConnection;
+
+	// Prepared statements kept per connection (LRU)
+	int32 StatementCacheSize = 32;
+
+	// Connections used more recently than this skip the mysql_ping liveness check
+	float IdlePingThresholdSeconds = 30.f;
+
+	// BulkInsert streams rows with LOAD DATA LOCAL INFILE from this many rows on (0 = always multi-row INSERT)
+	int32 LoadDataRowThreshold = 10000;
+
+	// Shared pool to lease connections from (see UMySQLConnectionPoolSubsystem); null opens dedicated connections
+	shared_ptr<FMySQLConnectionPool> ConnectionPool;
 	
 	bool CreateNewConnection(int32 ConnectionID, FString Server, FString DBName, FString UserID, FString Password, int32 Port, TArray<FMySQLOptionPair> Options, 
 	                         FString& ErrorMessage);
@@ -28,15 +40,45 @@ public:
 	
 	void  CloseConnection(int32 ConnectionID);
 
-	void UpdateDataFromQuery(int32 ConnectionID, int32 QueryID, FString Query, bool& IsSuccessful, FString& ErrorMessage);
+	// Pings ConnectionID (reconnecting if the server dropped it) so it does not hit the server's idle timeout
+	bool KeepAlive(int32 ConnectionID, FString& ErrorMessage);
+
+	void UpdateDataFromQuery(int32 ConnectionID, int64 QueryID, FString Query, bool& IsSuccessful, FString& ErrorMessage);
+
+	void ExecuteParams(int32 ConnectionID, int64 QueryID, const FString& Query, const TArray<FMySQLParam>& Params, bool& IsSuccessful, FString& ErrorMessage);
+
+	// Runs Queries in one round trip; StatementResults holds one entry per query
+	void ExecuteBatch(int32 ConnectionID, int64 QueryID, const TArray<FString>& Queries, bool bUseTransaction,
+	                  TArray<FMySQLStatementResult>& StatementResults, bool& IsSuccessful, FString& ErrorMessage);
 
 	void SelectDataFromQuery(int32 ConnectionID, FString Query, bool& IsSuccessful, FString& ErrorMessage,
-	                         TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow);
+	                         TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow,
+	                         EMySQLResultLayout Layout = EMySQLResultLayout::Both);
+
+	// Converts each row once and passes it on in batches of BatchSize rows (0 = one batch with everything).
+	// OnBatch may move out of the arrays; only the ones selected by Layout are filled.
+	void SelectDataStreaming(int32 ConnectionID, const FString& Query, int32 BatchSize, EMySQLResultLayout Layout,
+	                         TFunctionRef<void(TArray<FMySQLDataTable>& ResultByColumn, TArray<FMySQLDataRow>& ResultByRow)> OnBatch,
+	                         bool& IsSuccessful, FString& ErrorMessage);
 
 
-	void UpdateImageFromPath(int32 ConnectionID, int32 QueryID, FString Query, FString UpdateParameter, int ParameterID, FString ImagePath, bool&
-	                         IsSuccessful, FString& ErrorMessage);
-	UTexture2D* SelectImageFromQuery(int32 ConnectionID, int32 QueryID, FString Query, bool& IsSuccessful, FString& ErrorMessage);
+	void BulkInsert(int32 ConnectionID, int64 QueryID, const FString& Table, const TArray<FString>& Columns, const TArray<FMySQLDataRow>& Rows,
+	                int64& InsertedRows, bool& IsSuccessful, FString& ErrorMessage);
+
+
+	void SelectTyped(int32 ConnectionID, const FString& Query, const TArray<FMySQLParam>& Params, FMySQLTypedResult& Result,
+	                 bool& IsSuccessful, FString& ErrorMessage);
+
+
+	void UpdateImageFromPath(int32 ConnectionID, int64 QueryID, FString Query, FString UpdateParameter, int ParameterID, FString ImagePath, bool&
+	                         IsSuccessful, FString& ErrorMessage, EMySQLImageEncoding Encoding = EMySQLImageEncoding::Original);
+
+	// Stores ImageData (already encoded) through the query's single '?' placeholder
+	void UpdateImageFromData(int32 ConnectionID, int64 QueryID, const FString& Query, const TArray<uint8>& ImageData, bool& IsSuccessful,
+	                         FString& ErrorMessage);
+
+	// Fetches the still-encoded image bytes; decoding is left to the caller so it can run on another worker
+	void SelectImageFromQuery(int32 ConnectionID, int64 QueryID, FString Query, TArray<uint8>& ImageData, bool& IsSuccessful, FString& ErrorMessage);
 
 
 	virtual void BeginDestroy() override;
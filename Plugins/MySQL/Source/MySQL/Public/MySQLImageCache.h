@@ -0,0 +1,94 @@
+// Copyright Athian Games. All Rights Reserved. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "Misc/ScopeLock.h"
+
+
+// BGRA8 pixels of an image decoded off the game thread
+struct FMySQLDecodedImage
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<uint8> BGRA;
+};
+
+typedef TSharedPtr<const FMySQLDecodedImage, ESPMode::ThreadSafe> FMySQLDecodedImagePtr;
+
+// Thread-safe LRU of decoded images keyed by the connection and select query that produced them, so repeated
+// image selects skip both the blob fetch and the decode. Bounded by decoded bytes; Empty() also discards images
+// still being decoded from blobs fetched before it, so an update is never undone by a select that raced it.
+class FMySQLImageCache
+{
+	// Also bounds the number of entries, so tiny images can't grow the lookup set without limit
+	static constexpr int32 MaxEntries = 1024;
+
+	FCriticalSection Mutex;
+	TLruCache<FString, FMySQLDecodedImagePtr> Entries;
+	const int64 MaxBytes;
+	int64 UsedBytes = 0;
+	uint64 Generation = 0;
+
+	static FString MakeKey(int32 ConnectionID, const FString& Query)
+	{
+		return FString::Printf(TEXT("%d:%s"), ConnectionID, *Query);
+	}
+
+	static int64 GetImageBytes(const FMySQLDecodedImagePtr& Image)
+	{
+		return Image.IsValid() ? Image->BGRA.Num() : 0;
+	}
+
+public:
+
+	explicit FMySQLImageCache(int64 InMaxBytes)
+		: Entries(MaxEntries)
+		, MaxBytes(InMaxBytes)
+	{
+	}
+
+	// OutGeneration has to be passed back to Add for an image decoded after this lookup missed
+	FMySQLDecodedImagePtr Find(int32 ConnectionID, const FString& Query, uint64& OutGeneration)
+	{
+		FScopeLock Lock(&Mutex);
+		OutGeneration = Generation;
+		const FMySQLDecodedImagePtr* Found = Entries.FindAndTouch(MakeKey(ConnectionID, Query));
+		return Found ? *Found : FMySQLDecodedImagePtr();
+	}
+
+	void Add(int32 ConnectionID, const FString& Query, const FMySQLDecodedImagePtr& Image, uint64 LookupGeneration)
+	{
+		const int64 Bytes = GetImageBytes(Image);
+
+		FScopeLock Lock(&Mutex);
+		if (LookupGeneration != Generation || Bytes > MaxBytes)
+		{
+			return;
+		}
+
+		const FString Key = MakeKey(ConnectionID, Query);
+		if (const FMySQLDecodedImagePtr* Existing = Entries.Find(Key))
+		{
+			UsedBytes -= GetImageBytes(*Existing);
+			Entries.Remove(Key);
+		}
+
+		while (Entries.Num() > 0 && (UsedBytes + Bytes > MaxBytes || Entries.Num() >= Entries.Max()))
+		{
+			UsedBytes -= GetImageBytes(Entries.RemoveLeastRecent());
+		}
+
+		Entries.Add(Key, Image);
+		UsedBytes += Bytes;
+	}
+
+	void Empty()
+	{
+		FScopeLock Lock(&Mutex);
+		Entries.Empty(Entries.Max());
+		UsedBytes = 0;
+		Generation++;
+	}
+};
@@ -5,29 +5,136 @@
 #include <vector>
 #include <vector>
 #include <xstring>
+#include <list>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <mysql/mysql.h>
 
 #include "MySQLConnectionOptions.h"
+#include "MySQLBPLibrary.h"
 
 using namespace std;
 
 
+// LRU cache of prepared statements for one MySQL handle, keyed by the SQL text.
+// Evicted statements are closed.
+class FMySQLStatementCache
+{
+	list<pair<string, MYSQL_STMT*>> Entries;
+	unordered_map<string, list<pair<string, MYSQL_STMT*>>::iterator> Index;
+
+public:
+
+	MYSQL_STMT* Find(const string& Sql);
+	void Add(const string& Sql, MYSQL_STMT* Stmt, size_t Capacity);
+	void Remove(const string& Sql);
+	void Clear();
+};
+
+
+// Input binds for one parameterized execution (defined in MySQLMain.cpp)
+struct FMySQLParamBinds;
+
+// Arguments of the last successful connect, kept so a dropped handle can be re-established
+struct FMySQLConnectSettings
+{
+	string Server;
+	string DBName;
+	string UserID;
+	string Password;
+	int Port = 0;
+	TArray<FMySQLOptionPair> Options;
+
+	// Exact, case-sensitive comparison of every field, password and options included
+	bool operator==(const FMySQLConnectSettings& Other) const
+	{
+		if (Server != Other.Server || DBName != Other.DBName || UserID != Other.UserID || Password != Other.Password
+			|| Port != Other.Port || Options.Num() != Other.Options.Num())
+		{
+			return false;
+		}
+		for (int32 iIndex = 0; iIndex < Options.Num(); iIndex++)
+		{
+			if (Options[iIndex].Option != Other.Options[iIndex].Option
+				|| !Options[iIndex].Value.Equals(Other.Options[iIndex].Value, ESearchCase::CaseSensitive))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+
+class FMySQLConnectionPool;
+
+
 class MySQLConnection
 {
 
+	// Runs a text query, reconnecting if the server had dropped the handle. It is re-sent only when it is a plain read
+	// or never reached the server.
+	MYSQL* RunQuery(int ConnectionID, const char* Query, string& ErrorMessage);
+
+	// Closes the handle and its statements but keeps the settings for Reconnect.
+	// Pooled handles go back to the pool unless bIsBroken.
+	void ReleaseHandle(int ConnectionID, bool bIsBroken = false);
+
+	// Prepares (or reuses) Sql and executes it with ParamBinds. Lost connections are retried;
+	// statements that are not read-only only when the server never received them.
+	MYSQL_STMT* ExecutePrepared(int ConnectionID, const string& Sql, FMySQLParamBinds& ParamBinds, bool bIsReadOnly, string& ErrorMessage);
+
+	// Backs the const char* error returned by CreateConnection
+	string LastConnectError;
+
 
-	void SetMySQLBulkOptions(MYSQL* MySQLHandle, const TArray<FMySQLOptionPair>& OptionsArray);
+	static void SetMySQLBulkOptions(MYSQL* MySQLHandle, const TArray<FMySQLOptionPair>& OptionsArray);
 	template <typename T>
-void SetMySQLOption(MYSQL* MySQLHandle, EMySQLOptions Option, const T& Value)
+static void SetMySQLOption(MYSQL* MySQLHandle, EMySQLOptions Option, const T& Value)
 	{
 		mysql_options(MySQLHandle, static_cast<enum mysql_option>(Option), &Value);
 	}
 
 public:
 
+	// Opens and configures a new handle; returns nullptr and fills ErrorMessage on failure
+	static MYSQL* ConnectHandle(const FMySQLConnectSettings& Settings, string& ErrorMessage);
+
+	// When set, handles are leased from this pool instead of being opened and closed here
+	shared_ptr<FMySQLConnectionPool> Pool;
+
 	vector<MYSQL*> DBConnections;
 	MYSQL* GetDBConnection(int ConnectionID);
 
+	// Prepared statements per connection, indexed like DBConnections
+	vector<FMySQLStatementCache> StatementCaches;
+	size_t StatementCacheCapacity = 32;
+
+	// Returns a cached prepared statement for Sql, preparing it on a miss
+	MYSQL_STMT* GetPreparedStatement(int ConnectionID, MYSQL* Handle, const string& Sql, string& ErrorMessage, unsigned int& ErrorCode);
+
+	// Indexed like DBConnections
+	vector<FMySQLConnectSettings> ConnectSettings;
+	vector<chrono::steady_clock::time_point> LastActivity;
+
+	// A handle used within this many seconds is trusted without a mysql_ping round trip (<= 0 pings every time)
+	double IdlePingThresholdSeconds = 30.0;
+
+	void MarkActive(int ConnectionID);
+	bool IsIdle(int ConnectionID) const;
+
+	// Closes the handle for ConnectionID and connects again with the stored settings
+	bool Reconnect(int ConnectionID, string& ErrorMessage);
+
+	// Pings the handle regardless of recent activity, reconnecting if it is gone
+	bool KeepAlive(int ConnectionID, string& ErrorMessage);
+
+	static bool IsConnectionLostError(unsigned int ErrorCode);
+
 	MySQLConnection() = default;
 	~MySQLConnection() = default;
     
@@ -36,15 +143,100 @@ public:
 	void CloseConnection(int ConnectionID);
 
 	bool CreateConnection(int ConnectionID, char* Server, char* DBName, char* UserID, char* Password, int Port, TArray<FMySQLOptionPair> Options, const char*& ErrorMessage);
-	bool UpdateDataFromQuery(int ConnectionID, char* Query, const char*& ErrorMessage);
-	bool SelectDataFromQuery(int ConnectionID, const char* Query, std::vector<std::string>& ColumnNames, std::vector<std::vector<std::string>>&
-	                         ColumnData, std::string& ErrorMessage);
-
-	bool UpdateImageFromPath(int ConnectionID, const char* Query, const char* ImageChar, const char*& ErrorMessage);
-	bool SelectImageFromQuery(int ConnectionID, const char* Query, char*& ImageChar, const char*& ErrorMessage);
+	bool UpdateDataFromQuery(int ConnectionID, const char* Query, string& ErrorMessage);
+	bool ExecuteParams(int ConnectionID, const char* Query, const TArray<FMySQLParam>& Params, string& ErrorMessage);
+
+	// Sends Queries as one multi-statement round trip, optionally inside START TRANSACTION/COMMIT, and fills
+	// Results per query. Execution stops at the first failing statement; a failed transaction is rolled back and
+	// then no result is marked successful. Results are split by statement, so each entry of Queries must hold
+	// exactly one statement or the results shift onto the wrong queries.
+	bool ExecuteBatch(int ConnectionID, const vector<string>& Queries, bool bUseTransaction, TArray<FMySQLStatementResult>& Results,
+	                  string& ErrorMessage);
+
+	// Inserts Rows into Table inside one transaction: multi-row INSERTs sized to max_allowed_packet, or
+	// LOAD DATA LOCAL INFILE streamed from Rows once there are at least LoadDataRowThreshold of them (0 = never).
+	// Every value is sent as a string and converted by the server; the exact string "NULL" is sent as SQL NULL.
+	bool BulkInsert(int ConnectionID, const string& Table, const vector<string>& Columns, const TArray<FMySQLDataRow>& Rows,
+	                int LoadDataRowThreshold, int64& AffectedRows, string& ErrorMessage);
+
+	// Runs a select over the binary protocol into typed column buffers (no string round trip for numbers).
+	// A dropped connection is only retried for plain SELECT/SHOW/DESCRIBE/EXPLAIN text, since a stored procedure
+	// or other write sent through here could otherwise run twice.
+	bool SelectTyped(int ConnectionID, const char* Query, const TArray<FMySQLParam>& Params, FMySQLTypedResult& Result, string& ErrorMessage);
+	// Runs Query with mysql_use_result and hands each row to OnRow as it arrives off the wire. Row
+	// pointers are only valid during the callback, and no other query may run on the connection until this returns.
+	bool SelectDataStreaming(int ConnectionID, const char* Query,
+	                         const function<void(const MYSQL_FIELD* Fields, unsigned int NumFields)>& OnColumns,
+	                         const function<void(MYSQL_ROW Row, const unsigned long* Lengths, unsigned int NumFields)>& OnRow,
+	                         string& ErrorMessage);
+
+	// Binds ImageData to the query's single '?' placeholder. Blobs above LongDataChunkSize are streamed
+	// in chunks with mysql_stmt_send_long_data instead of being copied into one packet.
+	bool UpdateImageFromData(int ConnectionID, const char* Query, const TArray<uint8>& ImageData, string& ErrorMessage);
+	static constexpr int32 LongDataChunkSize = 256 * 1024;
+	// Copies the first column of the first row (the image blob) into ImageData
+	bool SelectImageFromQuery(int ConnectionID, const char* Query, TArray<uint8>& ImageData, string& ErrorMessage);
 
 	bool IsValidConnection(int ConnectionID);
 
 
 
-};
\ No newline at end of file
+};
+
+
+// Thread-safe set of open handles for one DSN, shared by every MySQLConnection that leases from it.
+// Handles returned with Release are kept open so the next Acquire skips the connect/TLS handshake.
+class FMySQLConnectionPool
+{
+	struct FIdleHandle
+	{
+		MYSQL* Handle;
+		chrono::steady_clock::time_point ReleasedAt;
+	};
+
+	const FMySQLConnectSettings Settings;
+
+	mutable mutex Mutex;
+
+	// Most recently released last, so hot handles are reused and cold ones age out
+	vector<FIdleHandle> Idle;
+	int NumLeased = 0;
+	int NumOpening = 0;
+	bool bShutdown = false;
+	bool bMaintaining = false;
+
+	// Guarded by Mutex like the counters; see SetLimits
+	int MinSize = 0;
+	int MaxSize = 8;
+	double IdleTimeoutSeconds = 300.0;
+
+public:
+
+	explicit FMySQLConnectionPool(const FMySQLConnectSettings& InSettings);
+	~FMySQLConnectionPool();
+
+	const FMySQLConnectSettings& GetSettings() const { return Settings; }
+
+	// Idle handles beyond MinSize are closed after IdleTimeoutSeconds; at most MaxSize are open at once.
+	// Safe to call while workers are leasing.
+	void SetLimits(int InMinSize, int InMaxSize, double InIdleTimeoutSeconds);
+
+	// Blocking while a new handle connects; never call on the game thread. Reused handles have their session state
+	// reset. Fails at once, without waiting for a release, when MaxSize handles are already leased.
+	MYSQL* Acquire(string& ErrorMessage);
+
+	// Returns a leased handle. Its session (variables, temporary tables, open transaction) is reset on the next Acquire.
+	void Release(MYSQL* Handle);
+
+	// Closes a leased handle that is known to be dead
+	void Discard(MYSQL* Handle);
+
+	// Closes handles idle past IdleTimeoutSeconds (keeping MinSize) and opens handles up to MinSize. Blocking.
+	void Maintain();
+
+	// Closes idle handles; handles released afterwards are closed too
+	void Shutdown();
+
+	int GetNumIdle() const;
+	int GetNumLeased() const;
+};
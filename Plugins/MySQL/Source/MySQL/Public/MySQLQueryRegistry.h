@@ -0,0 +1,53 @@
+// Copyright Athian Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+
+
+/**
+* Tracks queries by handle from the moment they are queued until their results have been delivered,
+* so callers can wait on several of them at once without polling. Handles come from one process-wide
+* atomic counter and are never reused. Everything except AllocateHandle is game thread only.
+*/
+class MYSQL_API FMySQLQueryRegistry
+{
+public:
+
+	// bAllSuccessful is false if any of the awaited queries failed or was unknown
+	typedef TFunction<void(bool bAllSuccessful)> FOnQueriesCompleted;
+
+	// CompletedHistorySize bounds how many finished queries can still be awaited after the fact
+	explicit FMySQLQueryRegistry(int32 CompletedHistorySize = 1024);
+
+	// Thread-safe; never returns the same handle twice in a process
+	static int64 AllocateHandle();
+
+	void Register(int64 QueryID);
+
+	// Records the outcome and fires every WhenAll that was only waiting on this query
+	void Complete(int64 QueryID, bool bIsSuccessful);
+
+	bool IsPending(int64 QueryID) const;
+
+	// Already completed queries count with their recorded outcome, unknown ones as failed.
+	// OnCompleted runs before this returns when nothing is left to wait for.
+	void WhenAll(TConstArrayView<int64> QueryIDs, FOnQueriesCompleted OnCompleted);
+
+	// Completes every pending query as failed
+	void FailAll();
+
+private:
+
+	struct FWaiter
+	{
+		int32 Remaining = 0;
+		bool bAllSuccessful = true;
+		FOnQueriesCompleted OnCompleted;
+	};
+
+	TSet<int64> Pending;
+	TLruCache<int64, bool> CompletedHistory;
+	TMultiMap<int64, TSharedPtr<FWaiter>> Waiters;
+};
@@ -9,6 +9,9 @@ public class Postgres : ModuleRules
         // Keep it simple (avoids Live Coding LNK2011 quirks for tiny modules)
         PCHUsage = PCHUsageMode.NoPCHs;
 
+        // The awaitable query API (PostgresCoroutine.h) uses C++20 coroutines
+        CppStandard = CppStandardVersion.Cpp20;
+
         PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "Projects" });
         PrivateDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "Projects" });
 
@@ -3,6 +3,9 @@
 #include "Misc/ScopeLock.h"
 #include "Logging/LogMacros.h"
 #include "PostgresClient.h"
+#include "PostgresTransaction.h"
+#include "PostgresConnectionPool.h"
+#include "PostgresCoroutine.h"
 #include "Async/Async.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
@@ -308,6 +311,11 @@ void UPostgresClient::ExecAsync(const FString& Sql, const TArray<FString>& Param
 	});
 }
 
+FPostgresQueryAwaitable UPostgresClient::Query(const FString& Sql, const TArray<FString>& Params)
+{
+	return FPostgresQueryAwaitable(this, Sql, Params);
+}
+
 FPostgresQueryResult UPostgresClient::ExecInternal(const FString& Sql, const TArray<FString>* ParamsOpt)
 {
 	// Ensure we have a live connection (connect will also log errors)
@@ -317,95 +325,45 @@ FPostgresQueryResult UPostgresClient::ExecInternal(const FString& Sql, const TAr
 	}
 
 	FScopeLock Lock(&ConnMutex);
+	return PostgresExecOnConnection(Conn, Sql, ParamsOpt);
+}
 
-	FTCHARToUTF8 SqlUtf8(*Sql);
-	PGresult* PgRes; // note: no initializer
-
-	if (ParamsOpt && ParamsOpt->Num() > 0)
-	{
-		const int32 N = ParamsOpt->Num();
-		TArray<FTCHARToUTF8> ParamUtf8;   ParamUtf8.Reserve(N);
-		TArray<const char*> Values;       Values.Reserve(N);
-		TArray<int> Lengths;              Lengths.Init(0, N);
-		TArray<int> Formats;              Formats.Init(0, N); // 0 = text
-
-		for (const FString& P : *ParamsOpt)
-		{
-			ParamUtf8.Emplace(*P);
-			Values.Add(ParamUtf8.Last().Get());   // lifetime tied to ParamUtf8 element
-		}
-
-		PgRes = PQexecParams(Conn,
-							 SqlUtf8.Get(),
-							 N,
-							 nullptr,                // infer types
-							 Values.GetData(),
-							 Lengths.GetData(),
-							 Formats.GetData(),
-							 0);                    // 0 = text results
-	}
-	else
+UPostgresTransaction* UPostgresClient::BeginTransaction(const FPostgresQueryResultDelegate& OnBegun)
+{
+	// Pooled connections use the same connection string, so a client that never connected can't lease one either
+	if (!IsConnected())
 	{
-		PgRes = PQexec(Conn, SqlUtf8.Get());
+		UE_LOG(LogPostgres, Error, TEXT("BeginTransaction: not connected."));
+		OnBegun.ExecuteIfBound(::MakePgError(TEXT("Not connected to PostgresQL.")));
+		return nullptr;
 	}
 
-	if (!PgRes)
+	if (!TransactionPool.IsValid())
 	{
-		return ::MakePgError(TEXT("exec returned null."));
+		TransactionPool = MakeShared<FPostgresConnectionPool, ESPMode::ThreadSafe>();
 	}
+	TransactionPool->SetConnectionString(ConnStr);
+	TransactionPool->SetMaxIdleConnections(MaxPooledConnections);
 
-	ExecStatusType Status = PQresultStatus(PgRes);
-
-	FPostgresQueryResult Out;
-
-	if (Status == PGRES_TUPLES_OK)
-	{
-		const int32 Cols = PQnfields(PgRes);
-		const int32 Rows = PQntuples(PgRes);
-
-		Out.Columns.Reserve(Cols);
-		for (int32 c = 0; c < Cols; ++c)
-		{
-			Out.Columns.Add(UTF8_TO_TCHAR(PQfname(PgRes, c)));
-		}
-
-		Out.Rows.Reserve(Rows);
-		for (int32 r = 0; r < Rows; ++r)
-		{
-			FPostgresQueryResultRow Row;
-			for (int32 c = 0; c < Cols; ++c)
-			{
-				const FString& Key = Out.Columns[c];
-				FString Val;
-				if (!PQgetisnull(PgRes, r, c))
-				{
-					Val = UTF8_TO_TCHAR(PQgetvalue(PgRes, r, c));
-				}
-				Row.Values.Add(Key, MoveTemp(Val));
-			}
-			Out.Rows.Add(MoveTemp(Row));
-		}
-
-		Out.bSuccess = true;
-	}
-	else if (Status == PGRES_COMMAND_OK)
-	{
-		const char* Affected = PQcmdTuples(PgRes); // may be ""
-		Out.RowsAffected = (Affected && *Affected) ? FCStringAnsi::Atoi(Affected) : 0;
-		Out.bSuccess = true;
-	}
-	else
-	{
-		Out.bSuccess = false;
-		Out.Error = UTF8_TO_TCHAR(PQresultErrorMessage(PgRes));
-	}
+	UPostgresTransaction* Transaction = NewObject<UPostgresTransaction>(this);
+	OpenTransactions.Add(Transaction);
+	Transaction->Start(TransactionPool.ToSharedRef(), TEXT("BEGIN"), OnBegun);
+	return Transaction;
+}
 
-	PQclear(PgRes);
-	return Out;
+void UPostgresClient::OnTransactionEnded(UPostgresTransaction* Transaction)
+{
+	OpenTransactions.RemoveSingleSwap(Transaction);
 }
 
 void UPostgresClient::BeginDestroy()
 {
 	Disconnect();
+	if (TransactionPool.IsValid())
+	{
+		// Open transactions keep the pool alive and close their connection on release.
+		TransactionPool->Shutdown();
+		TransactionPool.Reset();
+	}
 	Super::BeginDestroy();
 }
@@ -0,0 +1,214 @@
+// Must be first for explicit PCH
+#include "Postgres.h"
+#include "PostgresConnectionPool.h"
+#include "Misc/ScopeLock.h"
+#include "Containers/StringConv.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "libpq-fe.h"
+THIRD_PARTY_INCLUDES_END
+
+DEFINE_LOG_CATEGORY_STATIC(LogPostgresPool, Log, All);
+
+FPostgresQueryResult PostgresExecOnConnection(PGconn* Conn, const FString& Sql, const TArray<FString>* ParamsOpt, FString* OutCommandTag)
+{
+	FPostgresQueryResult Out;
+
+	if (!Conn)
+	{
+		Out.Error = TEXT("Not connected to PostgresQL.");
+		return Out;
+	}
+
+	FTCHARToUTF8 SqlUtf8(*Sql);
+	PGresult* PgRes; // note: no initializer
+
+	if (ParamsOpt && ParamsOpt->Num() > 0)
+	{
+		const int32 N = ParamsOpt->Num();
+		TArray<FTCHARToUTF8> ParamUtf8;   ParamUtf8.Reserve(N);
+		TArray<const char*> Values;       Values.Reserve(N);
+		TArray<int> Lengths;              Lengths.Init(0, N);
+		TArray<int> Formats;              Formats.Init(0, N); // 0 = text
+
+		for (const FString& P : *ParamsOpt)
+		{
+			ParamUtf8.Emplace(*P);
+			Values.Add(ParamUtf8.Last().Get());   // lifetime tied to ParamUtf8 element
+		}
+
+		PgRes = PQexecParams(Conn,
+							 SqlUtf8.Get(),
+							 N,
+							 nullptr,                // infer types
+							 Values.GetData(),
+							 Lengths.GetData(),
+							 Formats.GetData(),
+							 0);                    // 0 = text results
+	}
+	else
+	{
+		PgRes = PQexec(Conn, SqlUtf8.Get());
+	}
+
+	if (!PgRes)
+	{
+		Out.Error = TEXT("exec returned null.");
+		return Out;
+	}
+
+	ExecStatusType Status = PQresultStatus(PgRes);
+
+	if (Status == PGRES_TUPLES_OK)
+	{
+		const int32 Cols = PQnfields(PgRes);
+		const int32 Rows = PQntuples(PgRes);
+
+		Out.Columns.Reserve(Cols);
+		for (int32 c = 0; c < Cols; ++c)
+		{
+			Out.Columns.Add(UTF8_TO_TCHAR(PQfname(PgRes, c)));
+		}
+
+		Out.Rows.Reserve(Rows);
+		for (int32 r = 0; r < Rows; ++r)
+		{
+			FPostgresQueryResultRow Row;
+			for (int32 c = 0; c < Cols; ++c)
+			{
+				const FString& Key = Out.Columns[c];
+				FString Val;
+				if (!PQgetisnull(PgRes, r, c))
+				{
+					Val = UTF8_TO_TCHAR(PQgetvalue(PgRes, r, c));
+				}
+				Row.Values.Add(Key, MoveTemp(Val));
+			}
+			Out.Rows.Add(MoveTemp(Row));
+		}
+
+		Out.bSuccess = true;
+	}
+	else if (Status == PGRES_COMMAND_OK)
+	{
+		const char* Affected = PQcmdTuples(PgRes); // may be ""
+		Out.RowsAffected = (Affected && *Affected) ? FCStringAnsi::Atoi(Affected) : 0;
+		Out.bSuccess = true;
+	}
+	else
+	{
+		Out.bSuccess = false;
+		Out.Error = UTF8_TO_TCHAR(PQresultErrorMessage(PgRes));
+	}
+
+	if (OutCommandTag)
+	{
+		*OutCommandTag = UTF8_TO_TCHAR(PQcmdStatus(PgRes));
+	}
+
+	PQclear(PgRes);
+	return Out;
+}
+
+FPostgresConnectionPool::~FPostgresConnectionPool()
+{
+	Shutdown();
+}
+
+void FPostgresConnectionPool::SetConnectionString(const FString& InConnStr)
+{
+	FScopeLock Lock(&Mutex);
+	ConnStr = InConnStr;
+}
+
+void FPostgresConnectionPool::SetMaxIdleConnections(int32 InMaxIdle)
+{
+	FScopeLock Lock(&Mutex);
+	MaxIdle = FMath::Max(0, InMaxIdle);
+	while (Idle.Num() > MaxIdle)
+	{
+		PQfinish(Idle.Pop(EAllowShrinking::No));
+	}
+}
+
+PGconn* FPostgresConnectionPool::Acquire(FString& OutError)
+{
+	FString ConnStrCopy;
+	{
+		FScopeLock Lock(&Mutex);
+		if (bShutdown)
+		{
+			OutError = TEXT("Connection pool is shut down.");
+			return nullptr;
+		}
+
+		while (Idle.Num() > 0)
+		{
+			PGconn* Candidate = Idle.Pop(EAllowShrinking::No);
+			if (PQstatus(Candidate) == CONNECTION_OK && PQtransactionStatus(Candidate) == PQTRANS_IDLE)
+			{
+				return Candidate;
+			}
+			PQfinish(Candidate);
+		}
+		ConnStrCopy = ConnStr;
+	}
+
+#if PLATFORM_WINDOWS
+	if (!Postgres_EnsureLibpqLoaded())
+	{
+		OutError = TEXT("lib preload failed. See earlier [Postgres] log for missing DLL(s).");
+		return nullptr;
+	}
+#endif
+
+	// Connect outside the lock so a slow handshake doesn't block releases.
+	FTCHARToUTF8 ConnUtf8(*ConnStrCopy);
+	PGconn* Conn = PQconnectdb(ConnUtf8.Get());
+	if (!Conn || PQstatus(Conn) != CONNECTION_OK)
+	{
+		OutError = Conn ? UTF8_TO_TCHAR(PQerrorMessage(Conn)) : TEXT("connect returned null.");
+		if (Conn) { PQfinish(Conn); }
+		UE_LOG(LogPostgresPool, Error, TEXT("Postgres pooled connect failed: %s"), *OutError);
+		return nullptr;
+	}
+	return Conn;
+}
+
+void FPostgresConnectionPool::Release(PGconn* Conn)
+{
+	if (!Conn)
+	{
+		return;
+	}
+
+	const bool bReusable = PQstatus(Conn) == CONNECTION_OK && PQtransactionStatus(Conn) == PQTRANS_IDLE;
+
+	{
+		FScopeLock Lock(&Mutex);
+		if (bReusable && !bShutdown && Idle.Num() < MaxIdle)
+		{
+			Idle.Add(Conn);
+			return;
+		}
+	}
+
+	PQfinish(Conn);
+}
+
+void FPostgresConnectionPool::Shutdown()
+{
+	FScopeLock Lock(&Mutex);
+	bShutdown = true;
+	for (PGconn* Conn : Idle)
+	{
+		PQfinish(Conn);
+	}
+	Idle.Empty();
+}
+
+int32 FPostgresConnectionPool::GetNumIdle() const
+{
+	FScopeLock Lock(&Mutex);
+	return Idle.Num();
+}
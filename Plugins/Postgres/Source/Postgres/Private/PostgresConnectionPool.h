@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PostgresClient.h"
+
+struct pg_conn;
+typedef pg_conn PGconn;
+
+/**
+ * Runs one statement on an already-connected handle and converts the libpq result.
+ * Caller owns any locking for Conn. OutCommandTag receives PQcmdStatus (e.g. "COMMIT" / "ROLLBACK").
+ */
+FPostgresQueryResult PostgresExecOnConnection(PGconn* Conn, const FString& Sql, const TArray<FString>* ParamsOpt, FString* OutCommandTag = nullptr);
+
+/**
+ * Thread-safe set of idle libpq connections. Leases hand out a dedicated PGconn that the
+ * caller uses exclusively until Release; used by transactions so their statements are never
+ * interleaved with the client's autocommit connection.
+ */
+class FPostgresConnectionPool : public TSharedFromThis<FPostgresConnectionPool, ESPMode::ThreadSafe>
+{
+public:
+	~FPostgresConnectionPool();
+
+	void SetConnectionString(const FString& InConnStr);
+	void SetMaxIdleConnections(int32 InMaxIdle);
+
+	/** Returns an idle connection or opens a new one (blocking). Never call on the game thread. */
+	PGconn* Acquire(FString& OutError);
+
+	/** Hands a leased connection back. Connections that are broken or mid-transaction are closed instead. */
+	void Release(PGconn* Conn);
+
+	/** Closes idle connections; connections released afterwards are closed too. */
+	void Shutdown();
+
+	int32 GetNumIdle() const;
+
+private:
+	mutable FCriticalSection Mutex;
+	FString ConnStr;
+	TArray<PGconn*> Idle;
+	int32 MaxIdle = 4;
+	bool bShutdown = false;
+};
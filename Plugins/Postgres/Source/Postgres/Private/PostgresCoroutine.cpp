@@ -0,0 +1,41 @@
+// Must be first for explicit PCH
+#include "Postgres.h"
+#include "PostgresCoroutine.h"
+#include "Tasks/Task.h"
+
+FPostgresQueryAwaitable::FPostgresQueryAwaitable(UPostgresClient* InClient, const FString& InSql, const TArray<FString>& InParams)
+	: Client(InClient)
+	, Sql(InSql)
+	, Params(InParams)
+{
+}
+
+bool FPostgresQueryAwaitable::await_suspend(std::coroutine_handle<> Awaiting)
+{
+	// Already on a worker: run right here and carry on without suspending
+	if (!IsInGameThread())
+	{
+		Run();
+		return false;
+	}
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Awaiting]()
+	{
+		Run();
+		Awaiting.resume();
+	});
+	return true;
+}
+
+void FPostgresQueryAwaitable::Run()
+{
+	if (UPostgresClient* CurrentClient = Client.Get())
+	{
+		Result = CurrentClient->ExecInternal(Sql, &Params);
+	}
+	else
+	{
+		Result.bSuccess = false;
+		Result.Error = TEXT("Postgres client was destroyed.");
+	}
+}
@@ -0,0 +1,286 @@
+// Must be first for explicit PCH
+#include "Postgres.h"
+#include "PostgresTransaction.h"
+#include "PostgresConnectionPool.h"
+#include "Misc/ScopeLock.h"
+#include "Async/Async.h"
+#include "Containers/StringConv.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "libpq-fe.h"
+THIRD_PARTY_INCLUDES_END
+
+DEFINE_LOG_CATEGORY_STATIC(LogPostgresTransaction, Log, All);
+
+struct FPostgresTransactionStep
+{
+	EPostgresTransactionStep Step = EPostgresTransactionStep::Statement;
+	FString Sql;
+	TArray<FString> Params;
+	FPostgresQueryResultDelegate Callback;
+};
+
+/** Shared with the worker so queued steps survive the UObject handle being collected. */
+struct FPostgresTransactionState
+{
+	TSharedPtr<FPostgresConnectionPool, ESPMode::ThreadSafe> Pool;
+
+	/** Pinned connection; only touched by the (single) draining worker. */
+	PGconn* Conn = nullptr;
+	bool bEnded = false;
+
+	/** Posted to the game thread once bEnded is set; lets the client stop keeping the handle alive. */
+	TFunction<void()> OnEnded;
+
+	FCriticalSection QueueMutex;
+	TArray<FPostgresTransactionStep> Pending;
+	int32 PendingHead = 0;
+	bool bDraining = false;
+};
+
+typedef TSharedPtr<FPostgresTransactionState, ESPMode::ThreadSafe> FPostgresTransactionStatePtr;
+
+static FPostgresQueryResult MakeTxError(const FString& Message)
+{
+	FPostgresQueryResult R;
+	R.bSuccess = false;
+	R.Error = Message;
+	return R;
+}
+
+static FString QuoteIdentifier(PGconn* Conn, const FString& Name)
+{
+	const FTCHARToUTF8 NameUtf8(*Name);
+	char* Escaped = PQescapeIdentifier(Conn, NameUtf8.Get(), NameUtf8.Length());
+	if (!Escaped)
+	{
+		return FString();
+	}
+	FString Out = UTF8_TO_TCHAR(Escaped);
+	PQfreemem(Escaped);
+	return Out;
+}
+
+static void ReleaseConnection(FPostgresTransactionState& S)
+{
+	if (S.Conn)
+	{
+		S.Pool->Release(S.Conn);
+		S.Conn = nullptr;
+	}
+	S.bEnded = true;
+}
+
+static FPostgresQueryResult RunStep(FPostgresTransactionState& S, FPostgresTransactionStep& Item)
+{
+	if (Item.Step == EPostgresTransactionStep::Begin)
+	{
+		FString Error;
+		S.Conn = S.Pool->Acquire(Error);
+		if (!S.Conn)
+		{
+			S.bEnded = true;
+			return MakeTxError(Error);
+		}
+
+		FPostgresQueryResult Result = PostgresExecOnConnection(S.Conn, Item.Sql, nullptr);
+		if (!Result.bSuccess)
+		{
+			ReleaseConnection(S);
+		}
+		return Result;
+	}
+
+	if (!S.Conn || S.bEnded)
+	{
+		return MakeTxError(TEXT("Transaction is not open."));
+	}
+
+	switch (Item.Step)
+	{
+	case EPostgresTransactionStep::Statement:
+		return PostgresExecOnConnection(S.Conn, Item.Sql, &Item.Params);
+
+	case EPostgresTransactionStep::Savepoint:
+	case EPostgresTransactionStep::RollbackToSavepoint:
+	case EPostgresTransactionStep::ReleaseSavepoint:
+		{
+			const FString Ident = QuoteIdentifier(S.Conn, Item.Sql);
+			if (Ident.IsEmpty())
+			{
+				return MakeTxError(FString::Printf(TEXT("Invalid savepoint name '%s'."), *Item.Sql));
+			}
+			const TCHAR* Verb =
+				Item.Step == EPostgresTransactionStep::Savepoint ? TEXT("SAVEPOINT") :
+				Item.Step == EPostgresTransactionStep::RollbackToSavepoint ? TEXT("ROLLBACK TO SAVEPOINT") :
+				TEXT("RELEASE SAVEPOINT");
+			return PostgresExecOnConnection(S.Conn, FString::Printf(TEXT("%s %s"), Verb, *Ident), nullptr);
+		}
+
+	case EPostgresTransactionStep::Commit:
+		{
+			FString Tag;
+			FPostgresQueryResult Result = PostgresExecOnConnection(S.Conn, TEXT("COMMIT"), nullptr, &Tag);
+			// COMMIT on an aborted transaction "succeeds" with a ROLLBACK tag.
+			if (Result.bSuccess && Tag.Equals(TEXT("ROLLBACK")))
+			{
+				Result.bSuccess = false;
+				Result.Error = TEXT("Transaction was rolled back because an earlier statement failed.");
+			}
+			ReleaseConnection(S);
+			return Result;
+		}
+
+	case EPostgresTransactionStep::Rollback:
+		{
+			FPostgresQueryResult Result = PostgresExecOnConnection(S.Conn, TEXT("ROLLBACK"), nullptr);
+			ReleaseConnection(S);
+			return Result;
+		}
+
+	default:
+		return MakeTxError(TEXT("Unknown transaction step."));
+	}
+}
+
+static void DrainTransaction(FPostgresTransactionStatePtr S)
+{
+	for (;;)
+	{
+		FPostgresTransactionStep Item;
+		{
+			FScopeLock Lock(&S->QueueMutex);
+			if (S->PendingHead >= S->Pending.Num())
+			{
+				S->Pending.Reset();
+				S->PendingHead = 0;
+				S->bDraining = false;
+				return;
+			}
+			Item = MoveTemp(S->Pending[S->PendingHead++]);
+		}
+
+		const bool bWasEnded = S->bEnded;
+		FPostgresQueryResult Result = RunStep(*S, Item);
+		if (!Result.bSuccess)
+		{
+			UE_LOG(LogPostgresTransaction, Warning, TEXT("Transaction step failed: %s"), *Result.Error);
+		}
+
+		if (Item.Callback.IsBound())
+		{
+			AsyncTask(ENamedThreads::GameThread, [Callback = MoveTemp(Item.Callback), Result = MoveTemp(Result)]()
+			{
+				Callback.ExecuteIfBound(Result);
+			});
+		}
+
+		// Queued after the step's own callback, so it still sees the handle
+		if (!bWasEnded && S->bEnded && S->OnEnded)
+		{
+			AsyncTask(ENamedThreads::GameThread, S->OnEnded);
+		}
+	}
+}
+
+void UPostgresTransaction::Start(const TSharedRef<FPostgresConnectionPool, ESPMode::ThreadSafe>& Pool, const FString& BeginSql, const FPostgresQueryResultDelegate& OnBegun)
+{
+	check(!State.IsValid());
+	State = MakeShared<FPostgresTransactionState, ESPMode::ThreadSafe>();
+	State->Pool = Pool;
+
+	TWeakObjectPtr<UPostgresTransaction> WeakThis(this);
+	State->OnEnded = [WeakThis]()
+	{
+		UPostgresTransaction* Transaction = WeakThis.Get();
+		if (UPostgresClient* Client = Transaction ? Cast<UPostgresClient>(Transaction->GetOuter()) : nullptr)
+		{
+			Client->OnTransactionEnded(Transaction);
+		}
+	};
+	Enqueue(EPostgresTransactionStep::Begin, BeginSql, TArray<FString>(), OnBegun);
+}
+
+void UPostgresTransaction::Enqueue(EPostgresTransactionStep Step, const FString& Sql, const TArray<FString>& Params, const FPostgresQueryResultDelegate& OnCompleted)
+{
+	if (!State.IsValid() || bFinished)
+	{
+		if (OnCompleted.IsBound())
+		{
+			OnCompleted.Execute(MakeTxError(TEXT("Transaction is not open.")));
+		}
+		return;
+	}
+
+	if (Step == EPostgresTransactionStep::Commit || Step == EPostgresTransactionStep::Rollback)
+	{
+		bFinished = true;
+	}
+
+	bool bStartWorker = false;
+	{
+		FScopeLock Lock(&State->QueueMutex);
+		FPostgresTransactionStep& Item = State->Pending.AddDefaulted_GetRef();
+		Item.Step = Step;
+		Item.Sql = Sql;
+		Item.Params = Params;
+		Item.Callback = OnCompleted;
+
+		if (!State->bDraining)
+		{
+			State->bDraining = true;
+			bStartWorker = true;
+		}
+	}
+
+	if (bStartWorker)
+	{
+		FPostgresTransactionStatePtr S = State;
+		Async(EAsyncExecution::ThreadPool, [S]()
+		{
+			DrainTransaction(S);
+		});
+	}
+}
+
+void UPostgresTransaction::ExecAsync(const FString& SqlDollarNumbered, const TArray<FString>& Params, const FPostgresQueryResultDelegate& OnCompleted)
+{
+	Enqueue(EPostgresTransactionStep::Statement, SqlDollarNumbered, Params, OnCompleted);
+}
+
+void UPostgresTransaction::Savepoint(const FString& Name, const FPostgresQueryResultDelegate& OnCompleted)
+{
+	Enqueue(EPostgresTransactionStep::Savepoint, Name, TArray<FString>(), OnCompleted);
+}
+
+void UPostgresTransaction::RollbackToSavepoint(const FString& Name, const FPostgresQueryResultDelegate& OnCompleted)
+{
+	Enqueue(EPostgresTransactionStep::RollbackToSavepoint, Name, TArray<FString>(), OnCompleted);
+}
+
+void UPostgresTransaction::ReleaseSavepoint(const FString& Name, const FPostgresQueryResultDelegate& OnCompleted)
+{
+	Enqueue(EPostgresTransactionStep::ReleaseSavepoint, Name, TArray<FString>(), OnCompleted);
+}
+
+void UPostgresTransaction::Commit(const FPostgresQueryResultDelegate& OnCompleted)
+{
+	Enqueue(EPostgresTransactionStep::Commit, FString(), TArray<FString>(), OnCompleted);
+}
+
+void UPostgresTransaction::Rollback(const FPostgresQueryResultDelegate& OnCompleted)
+{
+	Enqueue(EPostgresTransactionStep::Rollback, FString(), TArray<FString>(), OnCompleted);
+}
+
+void UPostgresTransaction::BeginDestroy()
+{
+	// Never leave a pinned connection mid-transaction.
+	if (State.IsValid() && !bFinished)
+	{
+		UE_LOG(LogPostgresTransaction, Warning, TEXT("Transaction handle destroyed while open; rolling back."));
+		Enqueue(EPostgresTransactionStep::Rollback, FString(), TArray<FString>(), FPostgresQueryResultDelegate());
+	}
+	State.Reset();
+	Super::BeginDestroy();
+}
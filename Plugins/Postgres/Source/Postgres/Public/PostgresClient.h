@@ -10,6 +10,10 @@
 struct pg_conn;
 typedef pg_conn PGconn;
 
+class FPostgresConnectionPool;
+class UPostgresTransaction;
+class FPostgresQueryAwaitable;
+
 USTRUCT(BlueprintType)
 struct FPostgresQueryResultRow
 {
@@ -77,6 +81,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Postgres", meta=(DisplayName="Exec Async"))
 	void ExecAsync(const FString& SqlDollarNumbered, const TArray<FString>& Params, const FPostgresQueryResultDelegate& OnCompleted);
 
+	/**
+	 * C++ coroutines (include PostgresCoroutine.h): FPostgresQueryResult Result = co_await Client->Query(Sql, Params);
+	 * The coroutine continues on the worker that ran the query, so dependent queries need no game-thread hop.
+	 */
+	FPostgresQueryAwaitable Query(const FString& SqlDollarNumbered, const TArray<FString>& Params = TArray<FString>());
+
+	/**
+	 * Starts a transaction on a dedicated pooled connection. Queue statements on the returned handle
+	 * and finish with Commit or Rollback; everything between BEGIN and COMMIT costs a single commit.
+	 * The client keeps the handle alive until it has ended. Returns null (and reports the error to
+	 * OnBegun) if the client is not connected.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction")
+	UPostgresTransaction* BeginTransaction(const FPostgresQueryResultDelegate& OnBegun);
+
+	/** Idle connections kept around for transactions. Extra connections are closed on release. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Postgres|Transaction", meta=(ClampMin="0"))
+	int32 MaxPooledConnections = 4;
+
 	UFUNCTION(BlueprintCallable, Category="Postgres|Entities")
 	bool AddEntity(
 		const FString& LevelName,
@@ -91,10 +114,23 @@ protected:
 	virtual void BeginDestroy() override;
 
 private:
+	friend class FPostgresQueryAwaitable;
+	friend class UPostgresTransaction;
+
+	/** Called on the game thread once a transaction has committed, rolled back or failed to begin. */
+	void OnTransactionEnded(UPostgresTransaction* Transaction);
+
 	FPostgresQueryResult ExecInternal(const FString& Sql, const TArray<FString>* ParamsOpt);
 
 	/** Connection handle and state */
 	PGconn* Conn = nullptr;
 	FString ConnStr;
 	mutable FCriticalSection ConnMutex;
+
+	/** Connections leased by transactions; created on first BeginTransaction. */
+	TSharedPtr<FPostgresConnectionPool, ESPMode::ThreadSafe> TransactionPool;
+
+	/** Transactions that have not ended yet, so handles Blueprints don't store are not collected mid-transaction. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UPostgresTransaction>> OpenTransactions;
 };
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "PostgresClient.h"
+
+#include <coroutine>
+#include <type_traits>
+
+/**
+ * Return type of coroutines that use the awaitable query API. The coroutine starts running as soon as it is
+ * called and continues on whichever thread finished the last thing it awaited, so a chain of queries stays on
+ * the worker that ran them. Use Then() to get the result back on the game thread, or co_await the task from
+ * another coroutine (one of the two, once).
+ *
+ * Mirrors TMySQLTask and FMySQLResumeOnGameThread in the MySQL plugin. The two plugins ship and load
+ * independently, so neither includes the other's headers; fixes to one usually apply to both.
+ */
+template <typename T = void>
+class TPostgresTask
+{
+	typedef std::conditional_t<std::is_void_v<T>, bool, T> FStoredType;
+
+	struct FState
+	{
+		FCriticalSection Mutex;
+		TOptional<FStoredType> Value;
+		bool bIsDone = false;
+		TUniqueFunction<void()> Continuation;
+
+		void Finish()
+		{
+			TUniqueFunction<void()> ToRun;
+			{
+				FScopeLock Lock(&Mutex);
+				bIsDone = true;
+				ToRun = MoveTemp(Continuation);
+			}
+			if (ToRun)
+			{
+				ToRun();
+			}
+		}
+
+		// False if the coroutine already finished; OnDone is dropped and the caller continues itself
+		bool SetContinuation(TUniqueFunction<void()>&& OnDone)
+		{
+			FScopeLock Lock(&Mutex);
+			if (bIsDone)
+			{
+				return false;
+			}
+			Continuation = MoveTemp(OnDone);
+			return true;
+		}
+	};
+
+	typedef TSharedRef<FState, ESPMode::ThreadSafe> FStateRef;
+
+	struct FPromiseBase
+	{
+		FStateRef State = MakeShared<FState, ESPMode::ThreadSafe>();
+
+		TPostgresTask get_return_object() { return TPostgresTask(State); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { State->Finish(); return {}; }
+		void unhandled_exception() { checkf(false, TEXT("Unhandled exception in a Postgres coroutine")); }
+	};
+
+	struct FValuePromise : FPromiseBase
+	{
+		void return_value(FStoredType InValue) { this->State->Value.Emplace(MoveTemp(InValue)); }
+	};
+
+	struct FVoidPromise : FPromiseBase
+	{
+		void return_void() {}
+	};
+
+	FStateRef State;
+
+	explicit TPostgresTask(const FStateRef& InState) : State(InState) {}
+
+public:
+
+	typedef std::conditional_t<std::is_void_v<T>, FVoidPromise, FValuePromise> promise_type;
+
+	bool IsDone() const
+	{
+		FScopeLock Lock(&State->Mutex);
+		return State->bIsDone;
+	}
+
+	// Runs OnCompleted on the game thread once the coroutine has finished, passing the co_returned value if there is one
+	template <typename FunctorType>
+	void Then(FunctorType&& OnCompleted)
+	{
+		TUniqueFunction<void()> Deliver = [Captured = State, OnCompleted = Forward<FunctorType>(OnCompleted)]() mutable
+		{
+			AsyncTask(ENamedThreads::GameThread, [Captured, OnCompleted = MoveTemp(OnCompleted)]() mutable
+			{
+				if constexpr (std::is_void_v<T>)
+				{
+					OnCompleted();
+				}
+				else
+				{
+					OnCompleted(MoveTemp(Captured->Value.GetValue()));
+				}
+			});
+		};
+
+		// Only consumed when stored
+		if (!State->SetContinuation(MoveTemp(Deliver)))
+		{
+			Deliver();
+		}
+	}
+
+	bool await_ready() const { return IsDone(); }
+
+	bool await_suspend(std::coroutine_handle<> Awaiting)
+	{
+		return State->SetContinuation([Awaiting]() { Awaiting.resume(); });
+	}
+
+	T await_resume()
+	{
+		if constexpr (!std::is_void_v<T>)
+		{
+			return MoveTemp(State->Value.GetValue());
+		}
+	}
+};
+
+
+/** co_await FPostgresResumeOnGameThread() to continue on the game thread, e.g. to touch actors with the results. */
+struct FPostgresResumeOnGameThread
+{
+	bool await_ready() const { return IsInGameThread(); }
+	void await_suspend(std::coroutine_handle<> Awaiting) const { AsyncTask(ENamedThreads::GameThread, [Awaiting]() { Awaiting.resume(); }); }
+	void await_resume() const {}
+};
+
+
+/**
+ * Awaitable returned by UPostgresClient::Query. Awaited on the game thread it runs the query on a worker and the
+ * coroutine continues there; awaited on a worker it runs right away without suspending, so the next dependent
+ * query goes out without a game-thread round trip.
+ */
+class POSTGRES_API FPostgresQueryAwaitable
+{
+public:
+	FPostgresQueryAwaitable(UPostgresClient* InClient, const FString& InSql, const TArray<FString>& InParams);
+
+	bool await_ready() const { return false; }
+	bool await_suspend(std::coroutine_handle<> Awaiting);
+	FPostgresQueryResult await_resume() { return MoveTemp(Result); }
+
+private:
+	/** Blocking. */
+	void Run();
+
+	TWeakObjectPtr<UPostgresClient> Client;
+	FString Sql;
+	TArray<FString> Params;
+	FPostgresQueryResult Result;
+};
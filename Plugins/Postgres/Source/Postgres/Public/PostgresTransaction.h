@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "PostgresClient.h"
+#include "PostgresTransaction.generated.h"
+
+class FPostgresConnectionPool;
+struct FPostgresTransactionState;
+
+/** Kind of work item queued on a transaction's pinned connection. */
+enum class EPostgresTransactionStep : uint8
+{
+	Begin,
+	Statement,
+	Savepoint,
+	RollbackToSavepoint,
+	ReleaseSavepoint,
+	Commit,
+	Rollback
+};
+
+/**
+ * Handle for one server-side transaction. BeginTransaction pins a pooled connection,
+ * statements queued here run strictly in order on that connection (off the game thread),
+ * and Commit/Rollback end the transaction and hand the connection back to the pool.
+ *
+ * Results are delivered on the game thread. If the handle is destroyed while still open
+ * the transaction is rolled back.
+ */
+UCLASS(BlueprintType)
+class POSTGRES_API UPostgresTransaction : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Queues a parameterized statement inside this transaction. Use $1, $2... in Sql. */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction", meta=(DisplayName="Exec Async"))
+	void ExecAsync(const FString& SqlDollarNumbered, const TArray<FString>& Params, const FPostgresQueryResultDelegate& OnCompleted);
+
+	/** SAVEPOINT <Name>. */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction")
+	void Savepoint(const FString& Name, const FPostgresQueryResultDelegate& OnCompleted);
+
+	/** ROLLBACK TO SAVEPOINT <Name>; also clears an aborted state caused by a later statement. */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction")
+	void RollbackToSavepoint(const FString& Name, const FPostgresQueryResultDelegate& OnCompleted);
+
+	/** RELEASE SAVEPOINT <Name>. */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction")
+	void ReleaseSavepoint(const FString& Name, const FPostgresQueryResultDelegate& OnCompleted);
+
+	/** Queues COMMIT. Reports failure if the server rolled back instead (an earlier statement failed). */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction")
+	void Commit(const FPostgresQueryResultDelegate& OnCompleted);
+
+	/** Queues ROLLBACK. */
+	UFUNCTION(BlueprintCallable, Category="Postgres|Transaction")
+	void Rollback(const FPostgresQueryResultDelegate& OnCompleted);
+
+	/** True until Commit or Rollback has been queued. */
+	UFUNCTION(BlueprintPure, Category="Postgres|Transaction")
+	bool IsOpen() const { return !bFinished; }
+
+	/** Called by UPostgresClient::BeginTransaction. Queues BEGIN. */
+	void Start(const TSharedRef<FPostgresConnectionPool, ESPMode::ThreadSafe>& Pool, const FString& BeginSql, const FPostgresQueryResultDelegate& OnBegun);
+
+protected:
+	virtual void BeginDestroy() override;
+
+private:
+	void Enqueue(EPostgresTransactionStep Step, const FString& Sql, const TArray<FString>& Params, const FPostgresQueryResultDelegate& OnCompleted);
+
+	TSharedPtr<FPostgresTransactionState, ESPMode::ThreadSafe> State;
+
+	/** Game-thread view: Commit or Rollback has already been queued. */
+	bool bFinished = false;
+};
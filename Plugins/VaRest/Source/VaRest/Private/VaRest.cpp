@@ -4,6 +4,7 @@
 
 #include "VaRestDefines.h"
 #include "VaRestLibrary.h"
+#include "VaRestObjectPool.h"
 #include "VaRestSettings.h"
 
 #include "Developer/Settings/Public/ISettingsModule.h"
@@ -16,6 +17,8 @@ void FVaRestModule::StartupModule()
 	ModuleSettings = NewObject<UVaRestSettings>(GetTransientPackage(), "VaRestSettings", RF_Standalone);
 	ModuleSettings->AddToRoot();
 
+	FVaRestObjectPool::Startup();
+
 	// Register settings
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
 	{
@@ -35,6 +38,8 @@ void FVaRestModule::ShutdownModule()
 		SettingsModule->UnregisterSettings("Project", "Plugins", "VaRest");
 	}
 
+	FVaRestObjectPool::Shutdown();
+
 	if (!GExitPurge)
 	{
 		ModuleSettings->RemoveFromRoot();
@@ -0,0 +1,524 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#include "VaRestJsonDocument.h"
+
+#include "VaRestJsonStructuralParser.h"
+
+#include "Dom/JsonObject.h"
+
+/** Turns the structural index into the node array, validating the grammar on the way */
+class FVaRestJsonDocumentBuilder
+{
+public:
+	FVaRestJsonDocumentBuilder(FVaRestJsonDocument& InDocument)
+		: Document(InDocument)
+		, Bytes(InDocument.Bytes)
+		, Size(InDocument.Size)
+	{
+	}
+
+	bool Build()
+	{
+		if (!FJSONStructuralReader::BuildStructuralIndex(Bytes, Size, Index) || Index.Num() == 0)
+		{
+			return false;
+		}
+
+		// Every value takes one or two index entries
+		Document.Nodes.Reset();
+		Document.Nodes.Reserve(Index.Num() / 2 + 1);
+
+		// Decoded text is never longer than its UTF-8 source
+		if (Document.bUseStringArena)
+		{
+			Document.StringArena.Reset();
+			Document.StringArena.Reserve(Size);
+		}
+
+		return BuildValue(0) && Cursor == Index.Num();
+	}
+
+private:
+	ANSICHAR Peek() const
+	{
+		return Cursor < Index.Num() ? Bytes[Index[Cursor]] : '\0';
+	}
+
+	bool BuildValue(int32 Depth)
+	{
+		switch (Peek())
+		{
+		case '{':
+		case '[': return Depth < FJSONStructuralReader::MaxDepth && BuildContainer(Depth + 1);
+		case '"': return BuildString();
+		case '\0':
+		case '}':
+		case ']':
+		case ':':
+		case ',': return false;
+		}
+
+		return BuildScalar();
+	}
+
+	bool BuildContainer(int32 Depth)
+	{
+		const bool bIsObject = Peek() == '{';
+		const ANSICHAR Close = bIsObject ? '}' : ']';
+
+		const int32 NodeIndex = Document.Nodes.AddDefaulted();
+		Document.Nodes[NodeIndex].Type = bIsObject ? EJson::Object : EJson::Array;
+		Document.Nodes[NodeIndex].Begin = Index[Cursor];
+
+		int32 Count = 0;
+		++Cursor;
+		if (Peek() != Close)
+		{
+			for (;;)
+			{
+				if (bIsObject)
+				{
+					if (Peek() != '"' || !BuildString() || Peek() != ':')
+					{
+						return false;
+					}
+					++Cursor;
+				}
+
+				if (!BuildValue(Depth))
+				{
+					return false;
+				}
+				++Count;
+
+				const ANSICHAR Next = Peek();
+				if (Next == Close)
+				{
+					break;
+				}
+				if (Next != ',')
+				{
+					return false;
+				}
+				++Cursor;
+			}
+		}
+
+		FVaRestJsonNode& Node = Document.Nodes[NodeIndex];
+		Node.End = Index[Cursor] + 1;
+		Node.Count = Count;
+		Node.Next = Document.Nodes.Num();
+		++Cursor;
+
+		return true;
+	}
+
+	bool BuildString()
+	{
+		// The closing quote is always the next entry
+		if (Cursor + 1 >= Index.Num())
+		{
+			return false;
+		}
+
+		FVaRestJsonNode& Node = Document.Nodes.AddDefaulted_GetRef();
+		Node.Type = EJson::String;
+		Node.Begin = Index[Cursor] + 1;
+		Node.End = Index[Cursor + 1];
+		Node.Next = Document.Nodes.Num();
+		Cursor += 2;
+
+		if (Document.bUseStringArena)
+		{
+			if (!FJSONStructuralReader::DecodeString(Bytes + Node.Begin, Bytes + Node.End, Scratch))
+			{
+				return false;
+			}
+
+			Node.Text = Document.StringArena.Num();
+			Node.Count = Scratch.Len();
+			Document.StringArena.Append(*Scratch, Scratch.Len());
+			return true;
+		}
+
+		for (uint32 i = Node.Begin; i < Node.End; ++i)
+		{
+			if (Bytes[i] == '\\')
+			{
+				Node.bHasEscapes = true;
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	bool BuildScalar()
+	{
+		const uint32 Begin = Index[Cursor];
+		uint32 End = Cursor + 1 < Index.Num() ? Index[Cursor + 1] : (uint32)Size;
+		++Cursor;
+
+		while (End > Begin && (Bytes[End - 1] == ' ' || Bytes[End - 1] == '\t' || Bytes[End - 1] == '\n' || Bytes[End - 1] == '\r'))
+		{
+			--End;
+		}
+
+		FVaRestJsonNode& Node = Document.Nodes.AddDefaulted_GetRef();
+		Node.Begin = Begin;
+		Node.End = End;
+		Node.Next = Document.Nodes.Num();
+
+		const FAnsiStringView Token(Bytes + Begin, End - Begin);
+		if (Token.Equals("true", ESearchCase::CaseSensitive) || Token.Equals("false", ESearchCase::CaseSensitive))
+		{
+			Node.Type = EJson::Boolean;
+			return true;
+		}
+		if (Token.Equals("null", ESearchCase::CaseSensitive))
+		{
+			Node.Type = EJson::Null;
+			return true;
+		}
+
+		Node.Type = EJson::Number;
+		return FJSONStructuralReader::ParseNumber(Bytes + Begin, Bytes + End, Node.Number);
+	}
+
+	FVaRestJsonDocument& Document;
+	const ANSICHAR* Bytes;
+	int32 Size;
+
+	TArray<uint32> Index;
+	int32 Cursor = 0;
+
+	/** Decoding buffer for the string arena */
+	FString Scratch;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Document
+
+TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> FVaRestJsonDocument::Parse(TConstArrayView<uint8> InBytes, TSharedPtr<const void, ESPMode::ThreadSafe> InOwner, bool bInUseStringArena)
+{
+	TSharedPtr<FVaRestJsonDocument, ESPMode::ThreadSafe> Document = MakeShared<FVaRestJsonDocument, ESPMode::ThreadSafe>();
+	Document->bUseStringArena = bInUseStringArena;
+	Document->Owner = MoveTemp(InOwner);
+	Document->Bytes = (const ANSICHAR*)InBytes.GetData();
+	Document->Size = InBytes.Num();
+
+	if (!Document->Build())
+	{
+		return nullptr;
+	}
+	return Document;
+}
+
+TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> FVaRestJsonDocument::Parse(TArray<uint8>&& InBytes, bool bInUseStringArena)
+{
+	TSharedPtr<FVaRestJsonDocument, ESPMode::ThreadSafe> Document = MakeShared<FVaRestJsonDocument, ESPMode::ThreadSafe>();
+	Document->bUseStringArena = bInUseStringArena;
+	Document->OwnedBytes = MoveTemp(InBytes);
+	Document->Bytes = (const ANSICHAR*)Document->OwnedBytes.GetData();
+	Document->Size = Document->OwnedBytes.Num();
+
+	if (!Document->Build())
+	{
+		return nullptr;
+	}
+	return Document;
+}
+
+bool FVaRestJsonDocument::Build()
+{
+	// Skip UTF-8 BOM
+	if (Size >= 3 && (uint8)Bytes[0] == 0xEF && (uint8)Bytes[1] == 0xBB && (uint8)Bytes[2] == 0xBF)
+	{
+		Bytes += 3;
+		Size -= 3;
+	}
+
+	FVaRestJsonDocumentBuilder Builder(*this);
+	if (!Builder.Build())
+	{
+		Nodes.Empty();
+		StringArena.Empty();
+		return false;
+	}
+
+	Nodes.Shrink();
+	StringArena.Shrink();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// View
+
+FVaRestJsonView::FVaRestJsonView(const FVaRestJsonDocument* InDocument, int32 InNode)
+	: Document(InDocument)
+	, Node(InNode)
+{
+	if (Document == nullptr || Node < 0 || Node >= Document->NumNodes())
+	{
+		Document = nullptr;
+		Node = INDEX_NONE;
+	}
+}
+
+const FVaRestJsonNode& FVaRestJsonView::GetNode() const
+{
+	check(IsValid());
+	return Document->GetNode(Node);
+}
+
+EJson FVaRestJsonView::GetType() const
+{
+	return IsValid() ? GetNode().Type : EJson::None;
+}
+
+int32 FVaRestJsonView::Num() const
+{
+	const EJson Type = GetType();
+	return Type == EJson::Object || Type == EJson::Array ? GetNode().Count : 0;
+}
+
+FVaRestJsonView FVaRestJsonView::Find(FStringView Key) const
+{
+	if (GetType() != EJson::Object)
+	{
+		return FVaRestJsonView();
+	}
+
+	// Compare raw bytes unless the key in the document has escapes
+	const FTCHARToUTF8 Utf8Key(Key.GetData(), Key.Len());
+	const FAnsiStringView RawKey((const ANSICHAR*)Utf8Key.Get(), Utf8Key.Length());
+
+	int32 Child = Node + 1;
+	for (int32 i = 0; i < GetNode().Count; ++i)
+	{
+		const FVaRestJsonNode& KeyNode = Document->GetNode(Child);
+		bool bMatches;
+		if (KeyNode.Text != INDEX_NONE)
+		{
+			bMatches = Document->GetArenaString(KeyNode).Equals(Key, ESearchCase::CaseSensitive);
+		}
+		else if (KeyNode.bHasEscapes)
+		{
+			FString Decoded;
+			bMatches = FJSONStructuralReader::DecodeString(Document->GetBytes() + KeyNode.Begin, Document->GetBytes() + KeyNode.End, Decoded) && FStringView(Decoded).Equals(Key, ESearchCase::CaseSensitive);
+		}
+		else
+		{
+			bMatches = FAnsiStringView(Document->GetBytes() + KeyNode.Begin, KeyNode.End - KeyNode.Begin).Equals(RawKey, ESearchCase::CaseSensitive);
+		}
+
+		if (bMatches)
+		{
+			return FVaRestJsonView(Document, Child + 1);
+		}
+
+		Child = Document->GetNode(Child + 1).Next;
+	}
+
+	return FVaRestJsonView();
+}
+
+FVaRestJsonView FVaRestJsonView::GetElement(int32 Index) const
+{
+	if (GetType() != EJson::Array || Index < 0 || Index >= GetNode().Count)
+	{
+		return FVaRestJsonView();
+	}
+
+	// Hop over whole subtrees
+	int32 Child = Node + 1;
+	for (int32 i = 0; i < Index; ++i)
+	{
+		Child = Document->GetNode(Child).Next;
+	}
+
+	return FVaRestJsonView(Document, Child);
+}
+
+FVaRestJsonView FVaRestJsonView::Query(FStringView Path) const
+{
+	FVaRestJsonView Current = *this;
+
+	int32 i = 0;
+	while (i < Path.Len() && Current.IsValid())
+	{
+		if (Path[i] == TEXT('.'))
+		{
+			++i;
+		}
+		else if (Path[i] == TEXT('['))
+		{
+			int32 Index = 0;
+			int32 Digits = 0;
+			for (++i; i < Path.Len() && FChar::IsDigit(Path[i]); ++i, ++Digits)
+			{
+				Index = Index * 10 + (Path[i] - TEXT('0'));
+			}
+
+			if (Digits == 0 || i >= Path.Len() || Path[i] != TEXT(']'))
+			{
+				return FVaRestJsonView();
+			}
+			++i;
+
+			Current = Current.GetElement(Index);
+		}
+		else
+		{
+			const int32 Start = i;
+			while (i < Path.Len() && Path[i] != TEXT('.') && Path[i] != TEXT('['))
+			{
+				++i;
+			}
+
+			Current = Current.Find(Path.Mid(Start, i - Start));
+		}
+	}
+
+	return Current;
+}
+
+TArray<FString> FVaRestJsonView::GetFieldNames() const
+{
+	TArray<FString> Result;
+	if (GetType() != EJson::Object)
+	{
+		return Result;
+	}
+
+	Result.Reserve(GetNode().Count);
+
+	int32 Child = Node + 1;
+	for (int32 i = 0; i < GetNode().Count; ++i)
+	{
+		FVaRestJsonView(Document, Child).TryGetString(Result.AddDefaulted_GetRef());
+		Child = Document->GetNode(Child + 1).Next;
+	}
+
+	return Result;
+}
+
+bool FVaRestJsonView::TryGetString(FString& OutString) const
+{
+	if (GetType() != EJson::String)
+	{
+		return false;
+	}
+
+	const FVaRestJsonNode& StringNode = GetNode();
+	if (StringNode.Text != INDEX_NONE)
+	{
+		OutString = FString(Document->GetArenaString(StringNode));
+		return true;
+	}
+
+	const ANSICHAR* Begin = Document->GetBytes() + StringNode.Begin;
+	const ANSICHAR* End = Document->GetBytes() + StringNode.End;
+
+	if (StringNode.bHasEscapes)
+	{
+		return FJSONStructuralReader::DecodeString(Begin, End, OutString);
+	}
+
+	OutString.Reset(End - Begin);
+	OutString.AppendChars((const UTF8CHAR*)Begin, End - Begin);
+	return true;
+}
+
+bool FVaRestJsonView::TryGetNumber(double& OutNumber) const
+{
+	if (GetType() != EJson::Number)
+	{
+		return false;
+	}
+
+	OutNumber = GetNode().Number;
+	return true;
+}
+
+bool FVaRestJsonView::TryGetBool(bool& OutBool) const
+{
+	if (GetType() != EJson::Boolean)
+	{
+		return false;
+	}
+
+	OutBool = Document->GetBytes()[GetNode().Begin] == 't';
+	return true;
+}
+
+bool FVaRestJsonView::IsNull() const
+{
+	return GetType() == EJson::Null;
+}
+
+FStringView FVaRestJsonView::GetStringView() const
+{
+	if (GetType() != EJson::String || GetNode().Text == INDEX_NONE)
+	{
+		return FStringView();
+	}
+
+	return Document->GetArenaString(GetNode());
+}
+
+FAnsiStringView FVaRestJsonView::GetRawView() const
+{
+	if (!IsValid())
+	{
+		return FAnsiStringView();
+	}
+
+	return FAnsiStringView(Document->GetBytes() + GetNode().Begin, GetNode().End - GetNode().Begin);
+}
+
+TSharedPtr<FJsonValue> FVaRestJsonView::ToJsonValue() const
+{
+	switch (GetType())
+	{
+	case EJson::Object:
+	{
+		TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+
+		int32 Child = Node + 1;
+		for (int32 i = 0; i < GetNode().Count; ++i)
+		{
+			FString Key;
+			FVaRestJsonView(Document, Child).TryGetString(Key);
+			Object->Values.Add(MoveTemp(Key), FVaRestJsonView(Document, Child + 1).ToJsonValue());
+			Child = Document->GetNode(Child + 1).Next;
+		}
+
+		return MakeShared<FJsonValueObject>(Object);
+	}
+	case EJson::Array:
+	{
+		TArray<TSharedPtr<FJsonValue>> Elements;
+		Elements.Reserve(GetNode().Count);
+
+		int32 Child = Node + 1;
+		for (int32 i = 0; i < GetNode().Count; ++i)
+		{
+			Elements.Add(FVaRestJsonView(Document, Child).ToJsonValue());
+			Child = Document->GetNode(Child).Next;
+		}
+
+		return MakeShared<FJsonValueArray>(Elements);
+	}
+	case EJson::String:
+	{
+		FString String;
+		TryGetString(String);
+		return MakeShared<FJsonValueString>(String);
+	}
+	case EJson::Number: return MakeShared<FJsonValueNumber>(GetNode().Number);
+	case EJson::Boolean: return MakeShared<FJsonValueBoolean>(Document->GetBytes()[GetNode().Begin] == 't');
+	case EJson::Null: return MakeShared<FJsonValueNull>();
+	default: return nullptr;
+	}
+}
@@ -0,0 +1,253 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#include "VaRestJsonHandle.h"
+
+#include "VaRestDefines.h"
+#include "VaRestJsonObject.h"
+#include "VaRestObjectPool.h"
+
+namespace
+{
+	void HandleErrorMessage(const FVaRestJsonHandle& Handle, const TCHAR* InType)
+	{
+		UE_LOG(LogVaRest, Error, TEXT("%s: Json handle of type '%s' used as a '%s'."), *VA_FUNC_LINE,
+			Handle.Value.IsValid() ? *StaticEnum<EVaJson>()->GetNameStringByValue((int64)UVaRestJsonHandleLibrary::GetHandleType(Handle)) : TEXT("None"), InType);
+	}
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Construction
+
+FVaRestJsonHandle UVaRestJsonHandleLibrary::MakeObjectHandle(UVaRestJsonObject* JsonObject)
+{
+	if (!JsonObject)
+	{
+		return FVaRestJsonHandle();
+	}
+
+	return FVaRestJsonHandle(MakeShared<FJsonValueObject>(JsonObject->GetRootObject()));
+}
+
+FVaRestJsonHandle UVaRestJsonHandleLibrary::MakeValueHandle(UVaRestJsonValue* JsonValue)
+{
+	if (!JsonValue)
+	{
+		return FVaRestJsonHandle();
+	}
+
+	return FVaRestJsonHandle(JsonValue->GetRootValue());
+}
+
+UVaRestJsonValue* UVaRestJsonHandleLibrary::HandleToJsonValue(const FVaRestJsonHandle& Handle)
+{
+	if (!Handle.Value.IsValid())
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FJsonValue> NewVal = Handle.Value;
+
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
+	NewValue->SetRootValue(NewVal);
+
+	return NewValue;
+}
+
+UVaRestJsonObject* UVaRestJsonHandleLibrary::HandleToJsonObject(const FVaRestJsonHandle& Handle)
+{
+	if (!Handle.Value.IsValid() || Handle.Value->Type != EJson::Object)
+	{
+		HandleErrorMessage(Handle, TEXT("Object"));
+		return nullptr;
+	}
+
+	UVaRestJsonObject* JsonObj = FVaRestObjectPool::AcquireObject();
+	JsonObj->SetRootObject(Handle.Value->AsObject());
+
+	return JsonObj;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Navigation
+
+bool UVaRestJsonHandleLibrary::IsValidHandle(const FVaRestJsonHandle& Handle)
+{
+	return Handle.Value.IsValid();
+}
+
+EVaJson UVaRestJsonHandleLibrary::GetHandleType(const FVaRestJsonHandle& Handle)
+{
+	if (!Handle.Value.IsValid())
+	{
+		return EVaJson::None;
+	}
+
+	switch (Handle.Value->Type)
+	{
+	case EJson::None:
+		return EVaJson::None;
+
+	case EJson::Null:
+		return EVaJson::Null;
+
+	case EJson::String:
+		return EVaJson::String;
+
+	case EJson::Number:
+		return EVaJson::Number;
+
+	case EJson::Boolean:
+		return EVaJson::Boolean;
+
+	case EJson::Array:
+		return EVaJson::Array;
+
+	case EJson::Object:
+		return EVaJson::Object;
+
+	default:
+		return EVaJson::None;
+	}
+}
+
+int32 UVaRestJsonHandleLibrary::GetHandleLength(const FVaRestJsonHandle& Handle)
+{
+	if (!Handle.Value.IsValid())
+	{
+		return 0;
+	}
+
+	if (Handle.Value->Type == EJson::Array)
+	{
+		return Handle.Value->AsArray().Num();
+	}
+
+	if (Handle.Value->Type == EJson::Object)
+	{
+		return Handle.Value->AsObject()->Values.Num();
+	}
+
+	return 0;
+}
+
+FVaRestJsonHandle UVaRestJsonHandleLibrary::GetHandleField(const FVaRestJsonHandle& Handle, const FString& FieldName)
+{
+	if (!Handle.Value.IsValid() || Handle.Value->Type != EJson::Object)
+	{
+		HandleErrorMessage(Handle, TEXT("Object"));
+		return FVaRestJsonHandle();
+	}
+
+	return FVaRestJsonHandle(Handle.Value->AsObject()->TryGetField(FieldName));
+}
+
+bool UVaRestJsonHandleLibrary::HandleHasField(const FVaRestJsonHandle& Handle, const FString& FieldName)
+{
+	if (!Handle.Value.IsValid() || Handle.Value->Type != EJson::Object)
+	{
+		return false;
+	}
+
+	return Handle.Value->AsObject()->HasField(FieldName);
+}
+
+TArray<FString> UVaRestJsonHandleLibrary::GetHandleFieldNames(const FVaRestJsonHandle& Handle)
+{
+	TArray<FString> Result;
+	if (!Handle.Value.IsValid() || Handle.Value->Type != EJson::Object)
+	{
+		HandleErrorMessage(Handle, TEXT("Object"));
+		return Result;
+	}
+
+	Handle.Value->AsObject()->Values.GetKeys(Result);
+	return Result;
+}
+
+FVaRestJsonHandle UVaRestJsonHandleLibrary::GetHandleElement(const FVaRestJsonHandle& Handle, int32 Index)
+{
+	if (!Handle.Value.IsValid() || Handle.Value->Type != EJson::Array)
+	{
+		HandleErrorMessage(Handle, TEXT("Array"));
+		return FVaRestJsonHandle();
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>& Elements = Handle.Value->AsArray();
+	if (!Elements.IsValidIndex(Index))
+	{
+		return FVaRestJsonHandle();
+	}
+
+	return FVaRestJsonHandle(Elements[Index]);
+}
+
+TArray<FVaRestJsonHandle> UVaRestJsonHandleLibrary::GetHandleElements(const FVaRestJsonHandle& Handle)
+{
+	TArray<FVaRestJsonHandle> Result;
+	if (!Handle.Value.IsValid() || Handle.Value->Type != EJson::Array)
+	{
+		HandleErrorMessage(Handle, TEXT("Array"));
+		return Result;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>& Elements = Handle.Value->AsArray();
+	Result.Reserve(Elements.Num());
+	for (const TSharedPtr<FJsonValue>& Element : Elements)
+	{
+		Result.Emplace(Element);
+	}
+
+	return Result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Values
+
+float UVaRestJsonHandleLibrary::HandleAsNumber(const FVaRestJsonHandle& Handle)
+{
+	double Number = 0.0;
+	if (!Handle.Value.IsValid() || !Handle.Value->TryGetNumber(Number))
+	{
+		HandleErrorMessage(Handle, TEXT("Number"));
+	}
+
+	return static_cast<float>(Number);
+}
+
+int32 UVaRestJsonHandleLibrary::HandleAsInt32(const FVaRestJsonHandle& Handle)
+{
+	double Number = 0.0;
+	if (!Handle.Value.IsValid() || !Handle.Value->TryGetNumber(Number))
+	{
+		HandleErrorMessage(Handle, TEXT("Number"));
+	}
+
+	return static_cast<int32>(Number);
+}
+
+FString UVaRestJsonHandleLibrary::HandleAsString(const FVaRestJsonHandle& Handle)
+{
+	FString String;
+	if (!Handle.Value.IsValid() || !Handle.Value->TryGetString(String))
+	{
+		HandleErrorMessage(Handle, TEXT("String"));
+	}
+
+	return String;
+}
+
+bool UVaRestJsonHandleLibrary::HandleAsBool(const FVaRestJsonHandle& Handle)
+{
+	bool bValue = false;
+	if (!Handle.Value.IsValid() || !Handle.Value->TryGetBool(bValue))
+	{
+		HandleErrorMessage(Handle, TEXT("Boolean"));
+	}
+
+	return bValue;
+}
+
+bool UVaRestJsonHandleLibrary::IsHandleNull(const FVaRestJsonHandle& Handle)
+{
+	return !Handle.Value.IsValid() || Handle.Value->IsNull();
+}
@@ -5,6 +5,7 @@
 #include "VaRestDefines.h"
 #include "VaRestJsonParser.h"
 #include "VaRestJsonValue.h"
+#include "VaRestObjectPool.h"
 
 #include "HAL/FileManager.h"
 #include "Misc/Paths.h"
@@ -168,7 +169,7 @@ UVaRestJsonValue* UVaRestJsonObject::GetField(const FString& FieldName) const
 	TSharedPtr<FJsonValue> NewVal = JsonObj->TryGetField(FieldName);
 	if (NewVal.IsValid())
 	{
-		UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>();
+		UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 		NewValue->SetRootValue(NewVal);
 
 		return NewValue;
@@ -322,7 +323,7 @@ TArray<UVaRestJsonValue*> UVaRestJsonObject::GetArrayField(const FString& FieldN
 	TArray<TSharedPtr<FJsonValue>> ValArray = JsonObj->GetArrayField(FieldName);
 	for (auto Value : ValArray)
 	{
-		UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>();
+		UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 		NewValue->SetRootValue(Value);
 
 		OutArray.Add(NewValue);
@@ -415,7 +416,7 @@ UVaRestJsonObject* UVaRestJsonObject::GetObjectField(const FString& FieldName) c
 
 	const TSharedPtr<FJsonObject> JsonObjField = JsonObj->GetObjectField(FieldName);
 
-	UVaRestJsonObject* OutRestJsonObj = NewObject<UVaRestJsonObject>();
+	UVaRestJsonObject* OutRestJsonObj = FVaRestObjectPool::AcquireObject();
 	OutRestJsonObj->SetRootObject(JsonObjField);
 
 	return OutRestJsonObj;
@@ -605,7 +606,7 @@ TArray<UVaRestJsonObject*> UVaRestJsonObject::GetObjectArrayField(const FString&
 
 		TSharedPtr<FJsonObject> NewObj = Value->AsObject();
 
-		UVaRestJsonObject* NewJson = NewObject<UVaRestJsonObject>();
+		UVaRestJsonObject* NewJson = FVaRestObjectPool::AcquireObject();
 		NewJson->SetRootObject(NewObj);
 
 		OutArray.Add(NewJson);
@@ -738,7 +739,7 @@ void UVaRestJsonObject::DecodeFromArchive(TUniquePtr<FArchive>& Reader)
 //////////////////////////////////////////////////////////////////////////
 // Serialize
 
-bool UVaRestJsonObject::WriteToFile(const FString& Path) const
+bool UVaRestJsonObject::WriteToFile(const FString& Path, EVaRestFileEncoding Encoding) const
 {
 	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*Path));
 	if (!FileWriter)
@@ -746,50 +747,18 @@ bool UVaRestJsonObject::WriteToFile(const FString& Path) const
 		return false;
 	}
 
-	FArchive& Ar = *FileWriter.Get();
-
-	UCS2CHAR BOM = UNICODE_BOM;
-	Ar.Serialize(&BOM, sizeof(UCS2CHAR));
-
-	FString Str = FString(TEXT("{"));
-	WriteStringToArchive(Ar, *Str, Str.Len());
-
-	int32 ElementCount = 0;
-	FJSONWriter JsonWriter;
-	for (auto JsonObjectValuePair : JsonObj->Values)
 	{
-		Str = FString(TEXT("\""));
-		WriteStringToArchive(Ar, *Str, Str.Len());
-
-		const TCHAR* BufferPtr = *JsonObjectValuePair.Key;
-		for (int i = 0; i < JsonObjectValuePair.Key.Len(); ++i)
-		{
-			Str = FString(1, &BufferPtr[i]);
-			WriteStringToArchive(Ar, *Str, Str.Len());
-		}
-
-		Str = FString(TEXT("\""));
-		WriteStringToArchive(Ar, *Str, Str.Len());
-
-		Str = FString(TEXT(":"));
-		WriteStringToArchive(Ar, *Str, Str.Len());
-
-		++ElementCount;
-
-		JsonWriter.Write(JsonObjectValuePair.Value, FileWriter.Get(), ElementCount >= JsonObj->Values.Num());
+		FJSONWriter JsonWriter(*FileWriter, Encoding);
+		JsonWriter.WriteHeader();
+		JsonWriter.WriteObject(*JsonObj);
 	}
 
-	Str = FString(TEXT("}"));
-	WriteStringToArchive(Ar, *Str, Str.Len());
-
-	FileWriter->Close();
-
-	return true;
+	return FileWriter->Close();
 }
 
-bool UVaRestJsonObject::WriteToFilePath(const FString& Path, const bool bIsRelativeToProjectDir)
+bool UVaRestJsonObject::WriteToFilePath(const FString& Path, const bool bIsRelativeToProjectDir, EVaRestFileEncoding Encoding)
 {
-	return WriteToFile(bIsRelativeToProjectDir ? FPaths::ProjectDir() / Path : Path);
+	return WriteToFile(bIsRelativeToProjectDir ? FPaths::ProjectDir() / Path : Path, Encoding);
 }
 
 bool UVaRestJsonObject::WriteStringToArchive(FArchive& Ar, const TCHAR* StrPtr, int64 Len)
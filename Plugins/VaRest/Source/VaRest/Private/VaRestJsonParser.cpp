@@ -2,8 +2,6 @@
 
 #include "VaRestJsonParser.h"
 
-#include "VaRestJsonObject.h"
-
 #include "Dom/JsonObject.h"
 #include "Dom/JsonValue.h"
 
@@ -485,7 +483,7 @@ FJsonValueNonConstArray* FJSONState::GetArray()
 
 TSharedPtr<FJsonValueObject> FJSONState::PushObject()
 {
-	TSharedPtr<FJsonValueObject> Result(new FJsonValueObject(MakeShared<FJsonObject>()));
+	TSharedPtr<FJsonValueObject> Result = MakeShared<FJsonValueObject>(MakeShared<FJsonObject>());
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueObject>) + sizeof(FJsonValueObject);
 	return Result;
@@ -493,7 +491,7 @@ TSharedPtr<FJsonValueObject> FJSONState::PushObject()
 
 TSharedPtr<FJsonValueObject> FJSONState::PushObject(TSharedPtr<FJsonObject> Object)
 {
-	TSharedPtr<FJsonValueObject> Result(new FJsonValueObject(Object));
+	TSharedPtr<FJsonValueObject> Result = MakeShared<FJsonValueObject>(Object);
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueObject>) + sizeof(FJsonValueObject);
 	return Result;
@@ -502,7 +500,7 @@ TSharedPtr<FJsonValueObject> FJSONState::PushObject(TSharedPtr<FJsonObject> Obje
 TSharedPtr<FJsonValueNonConstArray> FJSONState::PushArray()
 {
 	const TArray<TSharedPtr<FJsonValue>> Empty;
-	TSharedPtr<FJsonValueNonConstArray> Result(new FJsonValueNonConstArray(Empty));
+	TSharedPtr<FJsonValueNonConstArray> Result = MakeShared<FJsonValueNonConstArray>(Empty);
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueNonConstArray>) + sizeof(FJsonValueNonConstArray);
 	return Result;
@@ -510,7 +508,7 @@ TSharedPtr<FJsonValueNonConstArray> FJSONState::PushArray()
 
 TSharedPtr<FJsonValueNonConstBoolean> FJSONState::PushBoolean()
 {
-	TSharedPtr<FJsonValueNonConstBoolean> Result(new FJsonValueNonConstBoolean(false));
+	TSharedPtr<FJsonValueNonConstBoolean> Result = MakeShared<FJsonValueNonConstBoolean>(false);
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueNonConstBoolean>) + sizeof(FJsonValueNonConstBoolean);
 	return Result;
@@ -518,7 +516,7 @@ TSharedPtr<FJsonValueNonConstBoolean> FJSONState::PushBoolean()
 
 TSharedPtr<FJsonValueNull> FJSONState::PushNull()
 {
-	TSharedPtr<FJsonValueNull> Result(new FJsonValueNull());
+	TSharedPtr<FJsonValueNull> Result = MakeShared<FJsonValueNull>();
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueNull>) + sizeof(FJsonValueNull);
 	return Result;
@@ -526,7 +524,7 @@ TSharedPtr<FJsonValueNull> FJSONState::PushNull()
 
 TSharedPtr<FJsonValueNonConstNumber> FJSONState::PushNumber()
 {
-	TSharedPtr<FJsonValueNonConstNumber> Result(new FJsonValueNonConstNumber(0.f));
+	TSharedPtr<FJsonValueNonConstNumber> Result = MakeShared<FJsonValueNonConstNumber>(0.f);
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueNonConstNumber>) + sizeof(FJsonValueNonConstNumber);
 	return Result;
@@ -534,7 +532,7 @@ TSharedPtr<FJsonValueNonConstNumber> FJSONState::PushNumber()
 
 TSharedPtr<FJsonValueNonConstString> FJSONState::PushString()
 {
-	TSharedPtr<FJsonValueNonConstString> Result(new FJsonValueNonConstString(TEXT("")));
+	TSharedPtr<FJsonValueNonConstString> Result = MakeShared<FJsonValueNonConstString>(TEXT(""));
 	Objects.Add(Result);
 	Size += sizeof(TSharedPtr<FJsonValueNonConstString>) + sizeof(FJsonValueNonConstString);
 	return Result;
@@ -998,153 +996,301 @@ bool FJSONReader::Read(const TCHAR Char)
 	return true;
 }
 
-FJSONWriter::FJSONWriter()
+namespace
 {
-}
+	/** Length of the UTF-8 sequence a lead byte starts, invalid bytes count as one */
+	FORCEINLINE int32 Utf8SequenceLength(uint8 LeadByte)
+	{
+		if (LeadByte >= 0xF0 && LeadByte < 0xF8)
+		{
+			return 4;
+		}
+		if (LeadByte >= 0xE0)
+		{
+			return LeadByte < 0xF0 ? 3 : 1;
+		}
+		return LeadByte >= 0xC0 ? 2 : 1;
+	}
+} // namespace
 
-bool FJSONWriter::GetStartChar(const TSharedPtr<FJsonValue>& JsonValue, FString& Str)
+bool FJSONStreamReader::Append(const uint8* Bytes, int32 Size)
 {
-	switch (JsonValue->Type)
+	if (bFailed)
 	{
-	case EJson::Object:
-		Str = FString(TEXT("{"));
-		break;
-	case EJson::Array:
-		Str = FString(TEXT("["));
-		break;
-	case EJson::String:
-		Str = FString(TEXT("\""));
-		break;
-	default:
 		return false;
+	}
+
+	BytesReceived += Size;
+
+	// Complete the sequence left over from the previous chunk first
+	if (Pending.Num() > 0)
+	{
+		const int32 Missing = FMath::Min(Utf8SequenceLength(Pending[0]) - Pending.Num(), Size);
+		Pending.Append(Bytes, Missing);
+		Bytes += Missing;
+		Size -= Missing;
+
+		if (Pending.Num() < Utf8SequenceLength(Pending[0]))
+		{
+			return true;
+		}
+
+		if (!Feed((const ANSICHAR*)Pending.GetData(), Pending.Num()))
+		{
+			return false;
+		}
+		Pending.Reset();
+	}
+
+	// Hold back a trailing sequence that isn't complete yet
+	int32 Complete = Size;
+	for (int32 Back = 1; Back <= 3 && Back <= Size; ++Back)
+	{
+		const uint8 Byte = Bytes[Size - Back];
+		if ((Byte & 0xC0) == 0x80)
+		{
+			continue;
+		}
+
+		if (Utf8SequenceLength(Byte) > Back)
+		{
+			Complete = Size - Back;
+		}
 		break;
 	}
 
+	if (!Feed((const ANSICHAR*)Bytes, Complete))
+	{
+		return false;
+	}
+
+	Pending.Append(Bytes + Complete, Size - Complete);
 	return true;
 }
 
-bool FJSONWriter::GetEndChar(const TSharedPtr<FJsonValue>& JsonValue, FString& Str)
+bool FJSONStreamReader::Feed(const ANSICHAR* Bytes, int32 Size)
 {
-	switch (JsonValue->Type)
+	const ANSICHAR* EndByte = Bytes + Size;
+	while (Bytes < EndByte)
 	{
-	case EJson::Object:
-		Str = FString(TEXT("}"));
-		break;
-	case EJson::Array:
-		Str = FString(TEXT("]"));
-		break;
-	case EJson::String:
-		Str = FString(TEXT("\""));
-		break;
-	default:
-		return false;
-		break;
+		TCHAR Char = FUtf8Helper::CodepointFromUtf8(Bytes, EndByte - Bytes);
+		if (Char > 0xFFFF)
+		{
+			Char = UNICODE_BOGUS_CHAR_CODEPOINT;
+		}
+
+		if (!Reader.Read(Char))
+		{
+			bFailed = true;
+			return false;
+		}
 	}
 
 	return true;
 }
 
-void FJSONWriter::Write(TSharedPtr<FJsonValue> JsonValue, FArchive* Writer, bool IsLastElement)
+FJSONWriter::FJSONWriter(FArchive& InArchive, EVaRestFileEncoding InEncoding)
+	: Archive(InArchive)
+	, Encoding(InEncoding)
 {
-	FString Str;
-	FArchive& Ar = *Writer;
+	Buffer.Reserve(FlushThreshold + 1024);
+}
 
-	if (GetStartChar(JsonValue, Str))
+FJSONWriter::~FJSONWriter()
+{
+	Flush();
+}
+
+void FJSONWriter::WriteHeader()
+{
+	if (Encoding == EVaRestFileEncoding::UCS2)
 	{
-		UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
+		UCS2CHAR BOM = UNICODE_BOM;
+		Archive.Serialize(&BOM, sizeof(UCS2CHAR));
 	}
+}
 
-	switch (JsonValue->Type)
-	{
-	case EJson::Object:
-	{
-		int ElementsCount = 0;
-		auto Values = JsonValue->AsObject()->Values;
+void FJSONWriter::WriteObject(const FJsonObject& Object)
+{
+	Append(TEXT('{'));
 
-		for (auto& ChildJsonPair : Values)
+	bool bIsFirst = true;
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Object.Values)
+	{
+		if (!bIsFirst)
 		{
-			Str = FString(TEXT("\""));
-			UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-
-			const TCHAR* BufferPtr = *ChildJsonPair.Key;
-			for (int i = 0; i < ChildJsonPair.Key.Len(); ++i)
-			{
-				Str = FString(1, &ChildJsonPair.Key[i]);
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-			}
+			Append(TEXT(','));
+		}
+		bIsFirst = false;
 
-			Str = FString(TEXT("\""));
-			UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
+		WriteString(Pair.Key);
+		Append(TEXT(':'));
+		Write(Pair.Value);
+	}
 
-			Str = FString(TEXT(":"));
-			UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
+	Append(TEXT('}'));
+}
 
-			++ElementsCount;
+void FJSONWriter::Write(const TSharedPtr<FJsonValue>& JsonValue)
+{
+	if (!JsonValue.IsValid())
+	{
+		Append(TEXT("null"), 4);
+		return;
+	}
 
-			Write(ChildJsonPair.Value, Writer, ElementsCount >= Values.Num());
+	switch (JsonValue->Type)
+	{
+	case EJson::Object:
+	{
+		const TSharedPtr<FJsonObject>& Object = JsonValue->AsObject();
+		if (Object.IsValid())
+		{
+			WriteObject(*Object);
+		}
+		else
+		{
+			Append(TEXT("null"), 4);
 		}
 		break;
 	}
 	case EJson::Array:
 	{
-		int ElementsCount = 0;
-		auto Array = JsonValue->AsArray();
+		const TArray<TSharedPtr<FJsonValue>>& Array = JsonValue->AsArray();
 
-		for (auto& ChildJsonValue : Array)
+		Append(TEXT('['));
+		for (int32 i = 0; i < Array.Num(); ++i)
 		{
-			++ElementsCount;
-			Write(ChildJsonValue, Writer, ElementsCount >= Array.Num());
+			if (i > 0)
+			{
+				Append(TEXT(','));
+			}
+			Write(Array[i]);
+		}
+		Append(TEXT(']'));
+		break;
+	}
+	case EJson::String:
+	{
+		JsonValue->TryGetString(Scratch);
+		WriteString(Scratch);
+		break;
+	}
+	case EJson::Number:
+	{
+		JsonValue->TryGetString(Scratch);
+		Append(*Scratch, Scratch.Len());
+		break;
+	}
+	case EJson::Boolean:
+	{
+		if (JsonValue->AsBool())
+		{
+			Append(TEXT("true"), 4);
+		}
+		else
+		{
+			Append(TEXT("false"), 5);
 		}
 		break;
 	}
 	default:
 	{
-		const FString Value = JsonValue->AsString();
+		Append(TEXT("null"), 4);
+		break;
+	}
+	}
+}
+
+void FJSONWriter::WriteString(const FString& String)
+{
+	static const TCHAR HexDigits[] = TEXT("0123456789abcdef");
+
+	Append(TEXT('"'));
 
-		const TCHAR* BufferPtr = *Value;
-		for (int i = 0; i < Value.Len(); ++i)
+	// Copy everything between characters that need escaping in one go
+	const TCHAR* Chars = *String;
+	const int32 Len = String.Len();
+	int32 SpanStart = 0;
+	for (int32 i = 0; i < Len; ++i)
+	{
+		const TCHAR Char = Chars[i];
+		if (Char >= 0x20 && Char != TEXT('"') && Char != TEXT('\\'))
 		{
-			Str = FString(1, &BufferPtr[i]);
-			if (Str == TEXT("\""))
-			{
-				Str = FString(TEXT("\\"));
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-				Str = FString(1, &BufferPtr[i]);
-			}
-			if (Str == TEXT("\n"))
-			{
-				Str = FString(TEXT("\\"));
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-				Str = FString(TEXT("n"));
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-				Str = FString(1, &BufferPtr[i]);
-			}
-			else if (Str == TEXT("\t"))
-			{
-				Str = FString(TEXT("\\"));
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-				Str = FString(TEXT("t"));
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-				Str = FString(1, &BufferPtr[i]);
-			}
-			else
-			{
-				UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
-			}
+			continue;
 		}
 
-		break;
+		Append(Chars + SpanStart, i - SpanStart);
+		SpanStart = i + 1;
+
+		switch (Char)
+		{
+		case TEXT('"'): Append(TEXT("\\\""), 2); break;
+		case TEXT('\\'): Append(TEXT("\\\\"), 2); break;
+		case TEXT('\n'): Append(TEXT("\\n"), 2); break;
+		case TEXT('\r'): Append(TEXT("\\r"), 2); break;
+		case TEXT('\t'): Append(TEXT("\\t"), 2); break;
+		case TEXT('\b'): Append(TEXT("\\b"), 2); break;
+		case TEXT('\f'): Append(TEXT("\\f"), 2); break;
+		default:
+		{
+			const TCHAR Escaped[6] = {TEXT('\\'), TEXT('u'), TEXT('0'), TEXT('0'), HexDigits[(Char >> 4) & 0xF], HexDigits[Char & 0xF]};
+			Append(Escaped, 6);
+			break;
+		}
+		}
+	}
+	Append(Chars + SpanStart, Len - SpanStart);
+
+	Append(TEXT('"'));
+}
+
+void FJSONWriter::Append(const TCHAR* Chars, int32 Len)
+{
+	Buffer.Append(Chars, Len);
+	if (Buffer.Num() >= FlushThreshold)
+	{
+		FlushBuffer(true);
 	}
+}
+
+void FJSONWriter::Append(TCHAR Char)
+{
+	Buffer.Add(Char);
+	if (Buffer.Num() >= FlushThreshold)
+	{
+		FlushBuffer(true);
+	}
+}
+
+void FJSONWriter::Flush()
+{
+	FlushBuffer(false);
+}
+
+void FJSONWriter::FlushBuffer(bool bKeepPendingSurrogate)
+{
+	int32 Count = Buffer.Num();
+	if (bKeepPendingSurrogate && Count > 0 && StringConv::IsHighSurrogate(Buffer[Count - 1]))
+	{
+		--Count;
 	}
 
-	if (GetEndChar(JsonValue, Str))
+	if (Count == 0)
 	{
-		UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
+		return;
 	}
 
-	if (!IsLastElement)
+	if (Encoding == EVaRestFileEncoding::UTF8)
 	{
-		Str = FString(TEXT(","));
-		UVaRestJsonObject::WriteStringToArchive(Ar, *Str, Str.Len());
+		const auto Converted = StringCast<UTF8CHAR>(Buffer.GetData(), Count);
+		Archive.Serialize(const_cast<UTF8CHAR*>(Converted.Get()), Converted.Length() * sizeof(UTF8CHAR));
 	}
+	else
+	{
+		const auto Converted = StringCast<UCS2CHAR>(Buffer.GetData(), Count);
+		Archive.Serialize(const_cast<UCS2CHAR*>(Converted.Get()), Converted.Length() * sizeof(UCS2CHAR));
+	}
+
+	Buffer.RemoveAt(0, Count, EAllowShrinking::No);
 }
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "VaRestTypes.h"
+
 #include "CoreMinimal.h"
 #include "Dom/JsonValue.h"
 
@@ -197,14 +199,61 @@ public:
 	bool Read(const TCHAR Char); // @Pushkin
 };
 
+/** Feeds UTF-8 bytes to FJSONReader as they arrive, holding back a code point split between two chunks */
+struct FJSONStreamReader
+{
+	/** @return False once the reader has failed, the rest of the body is of no use */
+	bool Append(const uint8* Bytes, int32 Size);
+
+	/** Reader with the parsed root and size once the whole body went through Append */
+	FJSONReader Reader;
+
+	/** Body bytes seen so far */
+	int64 BytesReceived = 0;
+
+private:
+	bool Feed(const ANSICHAR* Bytes, int32 Size);
+
+	/** Start of a multi-byte sequence that continues in the next chunk */
+	TArray<uint8, TInlineAllocator<4>> Pending;
+
+	bool bFailed = false;
+};
+
+/** Buffered json serializer: escapes whole spans into a reusable buffer and flushes it to the archive in large blocks */
 struct FJSONWriter
 {
-	FJSONWriter();
+	FJSONWriter(FArchive& InArchive, EVaRestFileEncoding InEncoding);
 
-	FORCEINLINE bool GetStartChar(const TSharedPtr<FJsonValue>& JsonValue, FString& Char);
+	/** Flushes whatever is still buffered */
+	~FJSONWriter();
 
-	FORCEINLINE bool GetEndChar(const TSharedPtr<FJsonValue>& JsonValue, FString& Char);
+	/** Byte order mark for UCS-2, nothing for UTF-8 */
+	void WriteHeader();
 
-public:
-	void Write(TSharedPtr<FJsonValue> JsonValue, FArchive* Writer, bool IsLastElement); // @Pushkin
+	void WriteObject(const FJsonObject& Object);
+
+	void Write(const TSharedPtr<FJsonValue>& JsonValue);
+
+	/** Write everything buffered so far to the archive */
+	void Flush();
+
+private:
+	void WriteString(const FString& String);
+
+	FORCEINLINE void Append(const TCHAR* Chars, int32 Len);
+	FORCEINLINE void Append(TCHAR Char);
+
+	/** Converts and serializes the buffer, optionally holding back a trailing high surrogate so the pair converts together */
+	void FlushBuffer(bool bKeepPendingSurrogate);
+
+	FArchive& Archive;
+	EVaRestFileEncoding Encoding;
+
+	TArray<TCHAR> Buffer;
+
+	/** String and number values are copied here, reusing one allocation */
+	FString Scratch;
+
+	static constexpr int32 FlushThreshold = 64 * 1024;
 };
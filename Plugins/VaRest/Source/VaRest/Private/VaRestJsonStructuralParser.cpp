@@ -0,0 +1,669 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#include "VaRestJsonStructuralParser.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Misc/StringBuilder.h"
+
+#include <atomic>
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_64BITS
+#define VAREST_JSON_NEON 1
+#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#define VAREST_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifndef VAREST_JSON_NEON
+#define VAREST_JSON_NEON 0
+#endif
+
+#ifndef VAREST_JSON_SSE2
+#define VAREST_JSON_SSE2 0
+#endif
+
+namespace VaRestJsonStructural
+{
+	/** Bit per byte of a 64 byte block */
+	struct FBlockMasks
+	{
+		uint64 Quote = 0;
+		uint64 Backslash = 0;
+		uint64 Structural = 0;
+		uint64 Whitespace = 0;
+	};
+
+	FORCEINLINE bool IsWhitespace(const ANSICHAR Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r';
+	}
+
+	FORCEINLINE bool IsDigit(const ANSICHAR Char)
+	{
+		return Char >= '0' && Char <= '9';
+	}
+
+#if VAREST_JSON_NEON
+	FORCEINLINE uint64 MoveMask(const uint8x16_t Mask)
+	{
+		static const uint8 BitValues[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+		const uint8x16_t Bits = vandq_u8(Mask, vld1q_u8(BitValues));
+		return (uint64)vaddv_u8(vget_low_u8(Bits)) | ((uint64)vaddv_u8(vget_high_u8(Bits)) << 8);
+	}
+
+	FORCEINLINE void Classify16(const ANSICHAR* Ptr, const int32 Shift, FBlockMasks& Masks)
+	{
+		const uint8x16_t Chars = vld1q_u8((const uint8*)Ptr);
+
+		// '[' and ']' are '{' and '}' without bit 5
+		const uint8x16_t Folded = vorrq_u8(Chars, vdupq_n_u8(0x20));
+		const uint8x16_t Brackets = vorrq_u8(vceqq_u8(Folded, vdupq_n_u8('{')), vceqq_u8(Folded, vdupq_n_u8('}')));
+		const uint8x16_t Separators = vorrq_u8(vceqq_u8(Chars, vdupq_n_u8(':')), vceqq_u8(Chars, vdupq_n_u8(',')));
+		const uint8x16_t Spaces = vorrq_u8(vceqq_u8(Chars, vdupq_n_u8(' ')), vceqq_u8(Chars, vdupq_n_u8('\t')));
+		const uint8x16_t Breaks = vorrq_u8(vceqq_u8(Chars, vdupq_n_u8('\n')), vceqq_u8(Chars, vdupq_n_u8('\r')));
+
+		Masks.Quote |= MoveMask(vceqq_u8(Chars, vdupq_n_u8('"'))) << Shift;
+		Masks.Backslash |= MoveMask(vceqq_u8(Chars, vdupq_n_u8('\\'))) << Shift;
+		Masks.Structural |= MoveMask(vorrq_u8(Brackets, Separators)) << Shift;
+		Masks.Whitespace |= MoveMask(vorrq_u8(Spaces, Breaks)) << Shift;
+	}
+#elif VAREST_JSON_SSE2
+	FORCEINLINE void Classify16(const ANSICHAR* Ptr, const int32 Shift, FBlockMasks& Masks)
+	{
+		const __m128i Chars = _mm_loadu_si128((const __m128i*)Ptr);
+
+		// '[' and ']' are '{' and '}' without bit 5
+		const __m128i Folded = _mm_or_si128(Chars, _mm_set1_epi8(0x20));
+		const __m128i Brackets = _mm_or_si128(_mm_cmpeq_epi8(Folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(Folded, _mm_set1_epi8('}')));
+		const __m128i Separators = _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8(':')), _mm_cmpeq_epi8(Chars, _mm_set1_epi8(',')));
+		const __m128i Spaces = _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\t')));
+		const __m128i Breaks = _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\r')));
+
+		Masks.Quote |= (uint64)(uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('"'))) << Shift;
+		Masks.Backslash |= (uint64)(uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('\\'))) << Shift;
+		Masks.Structural |= (uint64)(uint32)_mm_movemask_epi8(_mm_or_si128(Brackets, Separators)) << Shift;
+		Masks.Whitespace |= (uint64)(uint32)_mm_movemask_epi8(_mm_or_si128(Spaces, Breaks)) << Shift;
+	}
+#else
+	FORCEINLINE void Classify16(const ANSICHAR* Ptr, const int32 Shift, FBlockMasks& Masks)
+	{
+		for (int32 i = 0; i < 16; ++i)
+		{
+			const uint64 Bit = 1ull << (Shift + i);
+			switch (Ptr[i])
+			{
+			case '"': Masks.Quote |= Bit; break;
+			case '\\': Masks.Backslash |= Bit; break;
+			case '{':
+			case '}':
+			case '[':
+			case ']':
+			case ':':
+			case ',': Masks.Structural |= Bit; break;
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\r': Masks.Whitespace |= Bit; break;
+			}
+		}
+	}
+#endif
+
+	FORCEINLINE void ClassifyBlock(const ANSICHAR* Block, FBlockMasks& Masks)
+	{
+		Classify16(Block, 0, Masks);
+		Classify16(Block + 16, 16, Masks);
+		Classify16(Block + 32, 32, Masks);
+		Classify16(Block + 48, 48, Masks);
+	}
+
+	/** Bit i of the result is the xor of bits 0..i, i.e. set for every byte between an opening and a closing quote */
+	FORCEINLINE uint64 PrefixXor(uint64 Bits)
+	{
+		Bits ^= Bits << 1;
+		Bits ^= Bits << 2;
+		Bits ^= Bits << 4;
+		Bits ^= Bits << 8;
+		Bits ^= Bits << 16;
+		Bits ^= Bits << 32;
+		return Bits;
+	}
+
+	bool ParseHex4(const ANSICHAR*& Ptr, const ANSICHAR* End, uint32& OutValue)
+	{
+		if (End - Ptr < 4)
+		{
+			return false;
+		}
+
+		OutValue = 0;
+		for (int32 i = 0; i < 4; ++i)
+		{
+			const ANSICHAR Char = *Ptr++;
+			OutValue <<= 4;
+			if (IsDigit(Char))
+			{
+				OutValue |= Char - '0';
+			}
+			else if (Char >= 'a' && Char <= 'f')
+			{
+				OutValue |= Char - 'a' + 10;
+			}
+			else if (Char >= 'A' && Char <= 'F')
+			{
+				OutValue |= Char - 'A' + 10;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+} // namespace VaRestJsonStructural
+
+using namespace VaRestJsonStructural;
+
+bool FJSONStructuralReader::BuildStructuralIndex(const ANSICHAR* Bytes, int32 Size, TArray<uint32>& OutIndex)
+{
+	OutIndex.Reset();
+
+	// Typical payloads have one entry every four to eight bytes
+	OutIndex.Reserve(Size / 4 + 64);
+
+	uint64 PrevEscaped = 0;  // 1 when the first byte of the next block is escaped
+	uint64 PrevInString = 0; // All ones when the next block starts inside a string
+	uint64 PrevScalar = 0;   // 1 when the last byte of the previous block belongs to a scalar
+
+	ANSICHAR Tail[64];
+	for (int32 Offset = 0; Offset < Size; Offset += 64)
+	{
+		const ANSICHAR* Block = Bytes + Offset;
+		if (Size - Offset < 64)
+		{
+			// Pad with whitespace so the tail produces no extra entries
+			FMemory::Memset(Tail, ' ', sizeof(Tail));
+			FMemory::Memcpy(Tail, Block, Size - Offset);
+			Block = Tail;
+		}
+
+		FBlockMasks Masks;
+		ClassifyBlock(Block, Masks);
+
+		// Backslashes are rare enough to resolve one by one, an escaped backslash escapes nothing
+		uint64 Escaped = PrevEscaped;
+		PrevEscaped = 0;
+		for (uint64 Pending = Masks.Backslash; Pending != 0; Pending &= Pending - 1)
+		{
+			const uint64 Bit = Pending & (~Pending + 1);
+			if ((Escaped & Bit) == 0)
+			{
+				if (Bit == (1ull << 63))
+				{
+					PrevEscaped = 1;
+				}
+				else
+				{
+					Escaped |= Bit << 1;
+				}
+			}
+		}
+
+		const uint64 Quote = Masks.Quote & ~Escaped;
+		const uint64 InString = PrefixXor(Quote) ^ PrevInString;
+		PrevInString = (uint64)((int64)InString >> 63);
+
+		const uint64 Structural = Masks.Structural & ~InString;
+		const uint64 Scalar = ~(Masks.Structural | Masks.Whitespace | Quote | InString);
+		const uint64 ScalarStart = Scalar & ~((Scalar << 1) | PrevScalar);
+		PrevScalar = Scalar >> 63;
+
+		uint64 Bits = Structural | Quote | ScalarStart;
+		if (Bits == 0)
+		{
+			continue;
+		}
+
+		const int32 FirstNew = OutIndex.Num();
+		OutIndex.AddUninitialized(FMath::CountBits(Bits));
+		uint32* Out = OutIndex.GetData() + FirstNew;
+		while (Bits != 0)
+		{
+			*Out++ = (uint32)Offset + (uint32)FMath::CountTrailingZeros64(Bits);
+			Bits &= Bits - 1;
+		}
+	}
+
+	return PrevInString == 0;
+}
+
+bool FJSONStructuralReader::DecodeString(const ANSICHAR* Begin, const ANSICHAR* End, FString& OutString)
+{
+	OutString.Reset(End - Begin);
+
+	const ANSICHAR* Run = Begin;
+	const ANSICHAR* Ptr = Begin;
+	while (Ptr < End)
+	{
+		if (*Ptr != '\\')
+		{
+			++Ptr;
+			continue;
+		}
+
+		OutString.AppendChars((const UTF8CHAR*)Run, Ptr - Run);
+		if (++Ptr == End)
+		{
+			return false;
+		}
+
+		switch (*Ptr++)
+		{
+		case '"': OutString.AppendChar(TEXT('"')); break;
+		case '\\': OutString.AppendChar(TEXT('\\')); break;
+		case '/': OutString.AppendChar(TEXT('/')); break;
+		case 'b': OutString.AppendChar(TEXT('\b')); break;
+		case 'f': OutString.AppendChar(TEXT('\f')); break;
+		case 'n': OutString.AppendChar(TEXT('\n')); break;
+		case 'r': OutString.AppendChar(TEXT('\r')); break;
+		case 't': OutString.AppendChar(TEXT('\t')); break;
+		case 'u':
+		{
+			// Surrogate pairs arrive as two escapes and combine in the UTF-16 string on their own
+			uint32 CodeUnit;
+			if (!ParseHex4(Ptr, End, CodeUnit))
+			{
+				return false;
+			}
+			OutString.AppendChar((TCHAR)CodeUnit);
+			break;
+		}
+		default: return false;
+		}
+
+		Run = Ptr;
+	}
+
+	OutString.AppendChars((const UTF8CHAR*)Run, End - Run);
+	return true;
+}
+
+bool FJSONStructuralReader::ParseNumber(const ANSICHAR* Begin, const ANSICHAR* End, double& OutNumber)
+{
+	const ANSICHAR* Ptr = Begin;
+	const bool bNegative = Ptr < End && *Ptr == '-';
+	if (bNegative)
+	{
+		++Ptr;
+	}
+
+	const ANSICHAR* IntegerBegin = Ptr;
+	uint64 Mantissa = 0;
+	while (Ptr < End && IsDigit(*Ptr))
+	{
+		Mantissa = Mantissa * 10 + (*Ptr++ - '0');
+	}
+
+	const int64 IntegerDigits = Ptr - IntegerBegin;
+	if (IntegerDigits == 0 || (IntegerDigits > 1 && *IntegerBegin == '0'))
+	{
+		return false;
+	}
+
+	bool bIsInteger = true;
+	if (Ptr < End && *Ptr == '.')
+	{
+		bIsInteger = false;
+		const ANSICHAR* FractionBegin = ++Ptr;
+		while (Ptr < End && IsDigit(*Ptr))
+		{
+			++Ptr;
+		}
+		if (Ptr == FractionBegin)
+		{
+			return false;
+		}
+	}
+
+	if (Ptr < End && (*Ptr == 'e' || *Ptr == 'E'))
+	{
+		bIsInteger = false;
+		if (++Ptr < End && (*Ptr == '+' || *Ptr == '-'))
+		{
+			++Ptr;
+		}
+		const ANSICHAR* ExponentBegin = Ptr;
+		while (Ptr < End && IsDigit(*Ptr))
+		{
+			++Ptr;
+		}
+		if (Ptr == ExponentBegin)
+		{
+			return false;
+		}
+	}
+
+	if (Ptr != End)
+	{
+		return false;
+	}
+
+	// Up to 15 digits convert to double exactly
+	if (bIsInteger && IntegerDigits <= 15)
+	{
+		OutNumber = bNegative ? -(double)Mantissa : (double)Mantissa;
+		return true;
+	}
+
+	// Same conversion TJsonReader ends up with
+	TAnsiStringBuilder<64> Token;
+	Token.Append(Begin, End - Begin);
+	OutNumber = FCStringAnsi::Atod(Token.ToString());
+	return true;
+}
+
+bool FJSONStructuralReader::BuildIndex(const ANSICHAR* InBytes, int32 InSize)
+{
+	// Skip UTF-8 BOM
+	if (InSize >= 3 && (uint8)InBytes[0] == 0xEF && (uint8)InBytes[1] == 0xBB && (uint8)InBytes[2] == 0xBF)
+	{
+		InBytes += 3;
+		InSize -= 3;
+	}
+
+	Bytes = InBytes;
+	Size = InSize;
+	Cursor = 0;
+
+	if (!BuildStructuralIndex(Bytes, Size, IndexStorage) || IndexStorage.Num() == 0)
+	{
+		Index = TConstArrayView<uint32>();
+		return false;
+	}
+
+	Index = IndexStorage;
+	return true;
+}
+
+bool FJSONStructuralReader::Read(const ANSICHAR* InBytes, int32 InSize)
+{
+	Root.Reset();
+
+	if (!BuildIndex(InBytes, InSize))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonValue> Value = ReadValue(0);
+
+	// Anything after the root value is an error
+	if (!Value.IsValid() || Cursor != Index.Num())
+	{
+		return false;
+	}
+
+	Root = MoveTemp(Value);
+	return true;
+}
+
+bool FJSONStructuralReader::ReadParallel(const ANSICHAR* InBytes, int32 InSize)
+{
+	Root.Reset();
+
+	if (!BuildIndex(InBytes, InSize))
+	{
+		return false;
+	}
+
+	if (Peek() != '[')
+	{
+		TSharedPtr<FJsonValue> Value = ReadValue(0);
+		if (!Value.IsValid() || Cursor != Index.Num())
+		{
+			return false;
+		}
+
+		Root = MoveTemp(Value);
+		return true;
+	}
+
+	// Entry of the comma or bracket that ends each element of the root array
+	TArray<int32> ElementEnds;
+	int32 Nesting = 0;
+	int32 Entry = 1;
+	for (; Entry < Index.Num() && Nesting >= 0; ++Entry)
+	{
+		switch (Bytes[Index[Entry]])
+		{
+		case '"': ++Entry; break; // The closing quote is always the next entry
+		case '{':
+		case '[': ++Nesting; break;
+		case '}':
+		case ']':
+			if (--Nesting < 0)
+			{
+				ElementEnds.Add(Entry);
+			}
+			break;
+		case ',':
+			if (Nesting == 0)
+			{
+				ElementEnds.Add(Entry);
+			}
+			break;
+		}
+	}
+
+	// The root array has to close with the last entry
+	if (Nesting >= 0 || Entry != Index.Num())
+	{
+		return false;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Elements;
+	if (ElementEnds.Num() > 1 || ElementEnds[0] > 1)
+	{
+		Elements.SetNum(ElementEnds.Num());
+
+		std::atomic<bool> bFailed = false;
+		ParallelFor(TEXT("VaRestJsonArray"), ElementEnds.Num(), 64, [&](int32 ElementIndex) {
+			if (bFailed.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+
+			FJSONStructuralReader Element;
+			Element.Bytes = Bytes;
+			Element.Size = Size;
+			Element.Index = Index;
+			Element.Cursor = ElementIndex == 0 ? 1 : ElementEnds[ElementIndex - 1] + 1;
+
+			TSharedPtr<FJsonValue> Value = Element.ReadValue(1);
+			if (!Value.IsValid() || Element.Cursor != ElementEnds[ElementIndex])
+			{
+				bFailed = true;
+				return;
+			}
+
+			Elements[ElementIndex] = MoveTemp(Value);
+		});
+
+		if (bFailed)
+		{
+			return false;
+		}
+	}
+
+	Cursor = Index.Num();
+	Root = MakeShared<FJsonValueArray>(Elements);
+	return true;
+}
+
+ANSICHAR FJSONStructuralReader::Peek() const
+{
+	return Cursor < Index.Num() ? Bytes[Index[Cursor]] : '\0';
+}
+
+TSharedPtr<FJsonValue> FJSONStructuralReader::ReadValue(int32 Depth)
+{
+	const ANSICHAR Char = Peek();
+	if ((Char == '{' || Char == '[') && Depth >= MaxDepth)
+	{
+		return nullptr;
+	}
+
+	switch (Char)
+	{
+	case '{': return ReadObject(Depth + 1);
+	case '[': return ReadArray(Depth + 1);
+	case '"':
+	{
+		FString String;
+		if (!ReadString(String))
+		{
+			return nullptr;
+		}
+		return MakeShared<FJsonValueString>(MoveTemp(String));
+	}
+	case '\0':
+	case '}':
+	case ']':
+	case ':':
+	case ',': return nullptr;
+	}
+
+	return ReadScalar();
+}
+
+TSharedPtr<FJsonValue> FJSONStructuralReader::ReadObject(int32 Depth)
+{
+	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+
+	++Cursor; // '{'
+	if (Peek() == '}')
+	{
+		++Cursor;
+		return MakeShared<FJsonValueObject>(Object);
+	}
+
+	for (;;)
+	{
+		FString Key;
+		if (Peek() != '"' || !ReadString(Key) || Peek() != ':')
+		{
+			return nullptr;
+		}
+		++Cursor;
+
+		TSharedPtr<FJsonValue> Value = ReadValue(Depth);
+		if (!Value.IsValid())
+		{
+			return nullptr;
+		}
+
+		// Later duplicates win, same as FJsonObject::SetField
+		Object->Values.Add(MoveTemp(Key), MoveTemp(Value));
+
+		const ANSICHAR Next = Peek();
+		++Cursor;
+		if (Next == '}')
+		{
+			return MakeShared<FJsonValueObject>(Object);
+		}
+		if (Next != ',')
+		{
+			return nullptr;
+		}
+	}
+}
+
+TSharedPtr<FJsonValue> FJSONStructuralReader::ReadArray(int32 Depth)
+{
+	TArray<TSharedPtr<FJsonValue>> Elements;
+
+	++Cursor; // '['
+	if (Peek() == ']')
+	{
+		++Cursor;
+		return MakeShared<FJsonValueArray>(Elements);
+	}
+
+	for (;;)
+	{
+		TSharedPtr<FJsonValue> Value = ReadValue(Depth);
+		if (!Value.IsValid())
+		{
+			return nullptr;
+		}
+		Elements.Add(MoveTemp(Value));
+
+		const ANSICHAR Next = Peek();
+		++Cursor;
+		if (Next == ']')
+		{
+			return MakeShared<FJsonValueArray>(Elements);
+		}
+		if (Next != ',')
+		{
+			return nullptr;
+		}
+	}
+}
+
+bool FJSONStructuralReader::ReadString(FString& OutString)
+{
+	// The closing quote is always the next entry
+	if (Cursor + 1 >= Index.Num())
+	{
+		return false;
+	}
+
+	const uint32 Begin = Index[Cursor] + 1;
+	const uint32 End = Index[Cursor + 1];
+	Cursor += 2;
+
+	return DecodeString(Bytes + Begin, Bytes + End, OutString);
+}
+
+TSharedPtr<FJsonValue> FJSONStructuralReader::ReadScalar()
+{
+	// A scalar runs up to the next entry, minus trailing whitespace
+	const uint32 Begin = Index[Cursor];
+	uint32 End = Cursor + 1 < Index.Num() ? Index[Cursor + 1] : (uint32)Size;
+	++Cursor;
+
+	while (End > Begin && IsWhitespace(Bytes[End - 1]))
+	{
+		--End;
+	}
+
+	const ANSICHAR* Token = Bytes + Begin;
+	const uint32 Len = End - Begin;
+
+	if (*Token == 't' || *Token == 'f' || *Token == 'n')
+	{
+		if (Len == 4 && FMemory::Memcmp(Token, "true", 4) == 0)
+		{
+			return MakeShared<FJsonValueBoolean>(true);
+		}
+		if (Len == 5 && FMemory::Memcmp(Token, "false", 5) == 0)
+		{
+			return MakeShared<FJsonValueBoolean>(false);
+		}
+		if (Len == 4 && FMemory::Memcmp(Token, "null", 4) == 0)
+		{
+			return MakeShared<FJsonValueNull>();
+		}
+		return nullptr;
+	}
+
+	double Number;
+	if (!ParseNumber(Token, Token + Len, Number))
+	{
+		return nullptr;
+	}
+	return MakeShared<FJsonValueNumber>(Number);
+}
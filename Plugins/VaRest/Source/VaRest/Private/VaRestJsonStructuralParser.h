@@ -0,0 +1,68 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonValue.h"
+
+/**
+ * Two-stage reader for UTF-8 json documents.
+ *
+ * Stage one scans the raw bytes 64 at a time (SSE2 or NEON where available, plain C++ otherwise) and records the
+ * offset of every structural character, unescaped quote and scalar start that is not inside a string.
+ * Stage two walks that index and builds the same FJsonValue tree as TJsonReader, decoding only string contents.
+ */
+class FJSONStructuralReader
+{
+public:
+	/** Parse a whole document. The root may be an object, an array or a single value */
+	bool Read(const ANSICHAR* InBytes, int32 InSize);
+
+	/**
+	 * Same result as Read, but the elements of a root array are parsed on worker threads.
+	 * Only pays off for large documents: the index is still built on the calling thread.
+	 */
+	bool ReadParallel(const ANSICHAR* InBytes, int32 InSize);
+
+	/** Parsed document, invalid after a failed Read */
+	TSharedPtr<FJsonValue> Root;
+
+	/**
+	 * Stage one on its own. Quotes are always recorded in open/close pairs, so a string's content
+	 * lies between two consecutive entries.
+	 *
+	 * @return False if the document ends inside a string
+	 */
+	static bool BuildStructuralIndex(const ANSICHAR* Bytes, int32 Size, TArray<uint32>& OutIndex);
+
+	/** Decode the raw content between two quotes, resolving escapes */
+	static bool DecodeString(const ANSICHAR* Begin, const ANSICHAR* End, FString& OutString);
+
+	/** Convert a number token, rejecting anything that is not valid json */
+	static bool ParseNumber(const ANSICHAR* Begin, const ANSICHAR* End, double& OutNumber);
+
+	/** Nesting limit, keeps malicious documents from exhausting the stack */
+	static constexpr int32 MaxDepth = 256;
+
+private:
+	/** Skip the BOM and run stage one */
+	bool BuildIndex(const ANSICHAR* InBytes, int32 InSize);
+
+	TSharedPtr<FJsonValue> ReadValue(int32 Depth);
+	TSharedPtr<FJsonValue> ReadObject(int32 Depth);
+	TSharedPtr<FJsonValue> ReadArray(int32 Depth);
+	TSharedPtr<FJsonValue> ReadScalar();
+	bool ReadString(FString& OutString);
+
+	/** Character at the current index entry, or zero past the end */
+	ANSICHAR Peek() const;
+
+	const ANSICHAR* Bytes = nullptr;
+	int32 Size = 0;
+
+	TArray<uint32> IndexStorage;
+
+	/** Entries being read, IndexStorage or the index of the reader that forked this one */
+	TConstArrayView<uint32> Index;
+	int32 Cursor = 0;
+};
@@ -4,6 +4,7 @@
 
 #include "VaRestDefines.h"
 #include "VaRestJsonObject.h"
+#include "VaRestObjectPool.h"
 
 UVaRestJsonValue::UVaRestJsonValue(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -176,7 +177,7 @@ TArray<UVaRestJsonValue*> UVaRestJsonValue::AsArray() const
 	TArray<TSharedPtr<FJsonValue>> ValArray = JsonVal->AsArray();
 	for (auto Value : ValArray)
 	{
-		UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>();
+		UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 		NewValue->SetRootValue(Value);
 
 		OutArray.Add(NewValue);
@@ -195,7 +196,7 @@ UVaRestJsonObject* UVaRestJsonValue::AsObject()
 
 	const TSharedPtr<FJsonObject> NewObj = JsonVal->AsObject();
 
-	UVaRestJsonObject* JsonObj = NewObject<UVaRestJsonObject>();
+	UVaRestJsonObject* JsonObj = FVaRestObjectPool::AcquireObject();
 	JsonObj->SetRootObject(NewObj);
 
 	return JsonObj;
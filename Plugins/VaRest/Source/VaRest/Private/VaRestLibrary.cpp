@@ -5,6 +5,7 @@
 #include "VaRest.h"
 #include "VaRestDefines.h"
 #include "VaRestRequestJSON.h"
+#include "VaRestStructSerializer.h"
 
 #include "Engine/World.h"
 #include "GenericPlatform/GenericPlatformHttp.h"
@@ -87,6 +88,56 @@ FString UVaRestLibrary::GetVaRestVersion()
 	return !PluginRef.IsValid() ? FString("invalid") : PluginRef->GetDescriptor().VersionName;
 }
 
+DEFINE_FUNCTION(UVaRestLibrary::execDecodeJsonToStruct)
+{
+	P_GET_PROPERTY(FStrProperty, JsonString);
+
+	Stack.MostRecentProperty = nullptr;
+	Stack.StepCompiledIn<FStructProperty>(nullptr);
+	const FStructProperty* StructProperty = CastField<FStructProperty>(Stack.MostRecentProperty);
+	void* StructPtr = Stack.MostRecentPropertyAddress;
+
+	P_FINISH;
+
+	bool bSuccess = false;
+	if (StructProperty && StructPtr)
+	{
+		P_NATIVE_BEGIN;
+		bSuccess = FVaRestStructSerializer::DecodeJson(StructProperty->Struct, StructPtr, JsonString);
+		P_NATIVE_END;
+	}
+	else
+	{
+		UE_LOG(LogVaRest, Error, TEXT("%s: Decode target is not a struct"), *VA_FUNC_LINE);
+	}
+
+	*(bool*)RESULT_PARAM = bSuccess;
+}
+
+DEFINE_FUNCTION(UVaRestLibrary::execEncodeStructToJson)
+{
+	Stack.MostRecentProperty = nullptr;
+	Stack.StepCompiledIn<FStructProperty>(nullptr);
+	const FStructProperty* StructProperty = CastField<FStructProperty>(Stack.MostRecentProperty);
+	const void* StructPtr = Stack.MostRecentPropertyAddress;
+
+	P_FINISH;
+
+	FString Json;
+	if (StructProperty && StructPtr)
+	{
+		P_NATIVE_BEGIN;
+		FVaRestStructSerializer::EncodeJson(StructProperty->Struct, StructPtr, Json);
+		P_NATIVE_END;
+	}
+	else
+	{
+		UE_LOG(LogVaRest, Error, TEXT("%s: Encode source is not a struct"), *VA_FUNC_LINE);
+	}
+
+	*(FString*)RESULT_PARAM = MoveTemp(Json);
+}
+
 FVaRestURL UVaRestLibrary::GetWorldURL(UObject* WorldContextObject)
 {
 	if (WorldContextObject)
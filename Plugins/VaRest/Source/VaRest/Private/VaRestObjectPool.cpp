@@ -0,0 +1,100 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#include "VaRestObjectPool.h"
+
+#include "VaRestJsonObject.h"
+#include "VaRestJsonValue.h"
+
+#include "Misc/ScopeLock.h"
+
+FVaRestObjectPool* FVaRestObjectPool::Instance = nullptr;
+
+void FVaRestObjectPool::Startup()
+{
+	check(Instance == nullptr);
+	Instance = new FVaRestObjectPool();
+}
+
+void FVaRestObjectPool::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+UVaRestJsonValue* FVaRestObjectPool::AcquireValue()
+{
+	if (Instance)
+	{
+		FScopeLock Lock(&Instance->Mutex);
+		if (Instance->FreeValues.Num() > 0)
+		{
+			UVaRestJsonValue* Value = Instance->FreeValues.Pop(EAllowShrinking::No);
+			Instance->Pooled.Remove(Value);
+			return Value;
+		}
+	}
+
+	return NewObject<UVaRestJsonValue>();
+}
+
+UVaRestJsonObject* FVaRestObjectPool::AcquireObject()
+{
+	if (Instance)
+	{
+		FScopeLock Lock(&Instance->Mutex);
+		if (Instance->FreeObjects.Num() > 0)
+		{
+			UVaRestJsonObject* Object = Instance->FreeObjects.Pop(EAllowShrinking::No);
+			Instance->Pooled.Remove(Object);
+			return Object;
+		}
+	}
+
+	return NewObject<UVaRestJsonObject>();
+}
+
+void FVaRestObjectPool::ReleaseValue(UVaRestJsonValue* Value)
+{
+	if (!Instance || !IsValid(Value))
+	{
+		return;
+	}
+
+	Value->Reset();
+
+	FScopeLock Lock(&Instance->Mutex);
+	if (Instance->FreeValues.Num() < MaxPooled && !Instance->Pooled.Contains(Value))
+	{
+		Instance->Pooled.Add(Value);
+		Instance->FreeValues.Add(Value);
+	}
+}
+
+void FVaRestObjectPool::ReleaseObject(UVaRestJsonObject* Object)
+{
+	if (!Instance || !IsValid(Object))
+	{
+		return;
+	}
+
+	Object->Reset();
+
+	FScopeLock Lock(&Instance->Mutex);
+	if (Instance->FreeObjects.Num() < MaxPooled && !Instance->Pooled.Contains(Object))
+	{
+		Instance->Pooled.Add(Object);
+		Instance->FreeObjects.Add(Object);
+	}
+}
+
+void FVaRestObjectPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	FScopeLock Lock(&Mutex);
+	Collector.AddReferencedObjects(FreeValues);
+	Collector.AddReferencedObjects(FreeObjects);
+}
+
+FString FVaRestObjectPool::GetReferencerName() const
+{
+	return TEXT("FVaRestObjectPool");
+}
@@ -0,0 +1,47 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+class UVaRestJsonObject;
+class UVaRestJsonValue;
+
+/**
+ * Recycles json wrappers handed back through UVaRestSubsystem::ReleaseJsonValues/ReleaseJsonObjects, so getters
+ * that return one wrapper per element stop creating a new GC-tracked object each time. Owned by the module.
+ */
+class FVaRestObjectPool : public FGCObject
+{
+public:
+	static void Startup();
+	static void Shutdown();
+
+	/** Pooled wrapper if there is one, a new one otherwise */
+	static UVaRestJsonValue* AcquireValue();
+	static UVaRestJsonObject* AcquireObject();
+
+	/** Reset and keep for reuse. The caller must not touch it afterwards */
+	static void ReleaseValue(UVaRestJsonValue* Value);
+	static void ReleaseObject(UVaRestJsonObject* Object);
+
+	/** Upper bound of idle wrappers of each kind */
+	static constexpr int32 MaxPooled = 4096;
+
+	// Begin FGCObject
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	// End FGCObject
+
+private:
+	static FVaRestObjectPool* Instance;
+
+	FCriticalSection Mutex;
+
+	TArray<TObjectPtr<UVaRestJsonValue>> FreeValues;
+	TArray<TObjectPtr<UVaRestJsonObject>> FreeObjects;
+
+	/** Guards against the same wrapper being released twice and then handed out to two owners */
+	TSet<UObject*> Pooled;
+};
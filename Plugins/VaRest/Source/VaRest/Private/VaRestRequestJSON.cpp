@@ -4,10 +4,16 @@
 
 #include "VaRestDefines.h"
 #include "VaRestJsonObject.h"
+#include "VaRestJsonParser.h"
+#include "VaRestJsonStructuralParser.h"
 #include "VaRestJsonValue.h"
 #include "VaRestLibrary.h"
+#include "VaRestResponseCache.h"
 #include "VaRestSettings.h"
+#include "VaRestStructSerializer.h"
+#include "VaRestSubsystem.h"
 
+#include "Async/Async.h"
 #include "Engine/Engine.h"
 #include "Engine/LatentActionManager.h"
 #include "Engine/World.h"
@@ -17,6 +23,74 @@
 
 FString UVaRestRequestJSON::DeprecatedResponseString(TEXT("DEPRECATED: Please use GetResponseContentAsString() instead"));
 
+/** Longest part of a response body that goes to the log with bExtendedLog */
+static constexpr int32 MaxLoggedResponseBytes = 4096;
+
+/** Parser choices, taken from the settings on the game thread */
+struct FVaRestDecodeOptions
+{
+	bool bDocumentOnly = false;
+	bool bUseDocumentStringArena = false;
+	bool bUseStructuralParser = false;
+	bool bUseChunkedParser = false;
+	int32 ParallelDecodeThreshold = 0;
+
+	/** Set for cacheable GETs only */
+	TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> Cache;
+	TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe> CacheEntry;
+	FString URL;
+	TMap<FString, FString> VaryHeaders;
+};
+
+/** Everything decoded from one response, handed from the decode stage to the game thread */
+struct FVaRestDecodedResponse
+{
+	TMap<FString, FString> Headers;
+
+	TSharedPtr<FJsonValue> JsonValue;
+	TSharedPtr<FJsonObject> JsonObject;
+
+	TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document;
+	bool bDocumentParsed = false;
+
+	/** Zero when the body isn't usable json */
+	int32 Size = 0;
+
+	/** Raw body, only kept when it isn't json */
+	FString Content;
+	TArray<uint8> Bytes;
+	int32 ContentLength = 0;
+
+	/** Entry the response was served from, a fresh hit or one confirmed by a 304 */
+	TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe> CacheEntry;
+};
+
+static FVaRestDecodeOptions MakeDecodeOptions(bool bDocumentOnly)
+{
+	const UVaRestSettings* Settings = UVaRestLibrary::GetVaRestSettings();
+
+	FVaRestDecodeOptions Options;
+	Options.bDocumentOnly = bDocumentOnly;
+	Options.bUseDocumentStringArena = Settings->bUseDocumentStringArena;
+	Options.bUseStructuralParser = Settings->bUseStructuralParser;
+	Options.bUseChunkedParser = Settings->bUseChunkedParser;
+	Options.ParallelDecodeThreshold = Settings->ParallelDecodeThreshold;
+
+	return Options;
+}
+
+static TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> GetSharedResponseCache()
+{
+	const UVaRestSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UVaRestSubsystem>() : nullptr;
+	return Subsystem ? Subsystem->GetResponseCache() : nullptr;
+}
+
+static FString BodyToString(TConstArrayView<uint8> Body)
+{
+	const FUTF8ToTCHAR Converted((const ANSICHAR*)Body.GetData(), Body.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
 template <class T>
 void FVaRestLatentAction<T>::Cancel()
 {
@@ -32,6 +106,7 @@ UVaRestRequestJSON::UVaRestRequestJSON(const class FObjectInitializer& PCIP)
 	, BinaryContentType(TEXT("application/octet-stream"))
 {
 	ContinueAction = nullptr;
+	bResponseDocumentOnly = false;
 
 	RequestVerb = EVaRestRequestVerb::GET;
 	RequestContentType = EVaRestRequestContentType::x_www_form_urlencoded_url;
@@ -132,6 +207,11 @@ void UVaRestRequestJSON::ResetResponseData()
 
 	ResponseBytes.Empty();
 	ResponseContentLength = 0;
+
+	LastResponse.Reset();
+	ServedCacheEntry.Reset();
+	ResponseDocument.Reset();
+	bResponseDocumentParsed = false;
 }
 
 void UVaRestRequestJSON::Cancel()
@@ -184,6 +264,120 @@ UVaRestJsonValue* UVaRestRequestJSON::GetResponseValue() const
 	return ResponseJsonValue;
 }
 
+void UVaRestRequestJSON::SetResponseDocumentOnly(bool bDocumentOnly)
+{
+	bResponseDocumentOnly = bDocumentOnly;
+}
+
+TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> UVaRestRequestJSON::GetResponseDocument()
+{
+	if (!bResponseDocumentParsed && LastResponse.IsValid())
+	{
+		bResponseDocumentParsed = true;
+		ResponseDocument = FVaRestJsonDocument::Parse(LastResponse->GetContent(), LastResponse, UVaRestLibrary::GetVaRestSettings()->bUseDocumentStringArena);
+	}
+
+	return ResponseDocument;
+}
+
+FString UVaRestRequestJSON::GetResponseStringAtPath(const FString& Path, bool& bFound)
+{
+	FString Result;
+	const TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document = GetResponseDocument();
+	bFound = Document.IsValid() && Document->Query(Path).TryGetString(Result);
+
+	return Result;
+}
+
+float UVaRestRequestJSON::GetResponseNumberAtPath(const FString& Path, bool& bFound)
+{
+	double Result = 0.0;
+	const TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document = GetResponseDocument();
+	bFound = Document.IsValid() && Document->Query(Path).TryGetNumber(Result);
+
+	return static_cast<float>(Result);
+}
+
+bool UVaRestRequestJSON::GetResponseBoolAtPath(const FString& Path, bool& bFound)
+{
+	bool bResult = false;
+	const TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document = GetResponseDocument();
+	bFound = Document.IsValid() && Document->Query(Path).TryGetBool(bResult);
+
+	return bResult;
+}
+
+UVaRestJsonValue* UVaRestRequestJSON::GetResponseValueAtPath(const FString& Path)
+{
+	const TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document = GetResponseDocument();
+	if (!Document.IsValid())
+	{
+		return nullptr;
+	}
+
+	const FVaRestJsonView View = Document->Query(Path);
+	if (!View.IsValid())
+	{
+		return nullptr;
+	}
+
+	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>();
+	NewValue->SetRootValue(View.ToJsonValue());
+
+	return NewValue;
+}
+
+bool UVaRestRequestJSON::DecodeResponseStruct(const UScriptStruct* Struct, void* OutData) const
+{
+	if (!LastResponse.IsValid() && !ServedCacheEntry.IsValid())
+	{
+		UE_LOG(LogVaRest, Error, TEXT("%s: No response to decode"), *VA_FUNC_LINE);
+		return false;
+	}
+
+	const TConstArrayView<uint8> Content = GetResponseBody();
+	return FVaRestStructSerializer::DecodeJson(Struct, OutData, (const ANSICHAR*)Content.GetData(), Content.Num());
+}
+
+TConstArrayView<uint8> UVaRestRequestJSON::GetResponseBody() const
+{
+	if (ServedCacheEntry.IsValid())
+	{
+		return ServedCacheEntry->GetBody();
+	}
+
+	if (LastResponse.IsValid())
+	{
+		return LastResponse->GetContent();
+	}
+
+	return TConstArrayView<uint8>();
+}
+
+DEFINE_FUNCTION(UVaRestRequestJSON::execGetResponseStruct)
+{
+	Stack.MostRecentProperty = nullptr;
+	Stack.StepCompiledIn<FStructProperty>(nullptr);
+	const FStructProperty* StructProperty = CastField<FStructProperty>(Stack.MostRecentProperty);
+	void* StructPtr = Stack.MostRecentPropertyAddress;
+
+	P_FINISH;
+
+	bool bSuccess = false;
+	if (StructProperty && StructPtr)
+	{
+		P_NATIVE_BEGIN;
+		bSuccess = P_THIS->DecodeResponseStruct(StructProperty->Struct, StructPtr);
+		P_NATIVE_END;
+	}
+	else
+	{
+		UE_LOG(LogVaRest, Error, TEXT("%s: Decode target is not a struct"), *VA_FUNC_LINE);
+	}
+
+	*(bool*)RESULT_PARAM = bSuccess;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Response data access
 
@@ -304,6 +498,9 @@ void UVaRestRequestJSON::ProcessRequest()
 	// Force add to root once request is launched
 	AddToRoot();
 
+	// Results of an earlier request still decoding are dropped
+	++ResponseSerial;
+
 	// Set verb
 	switch (RequestVerb)
 	{
@@ -471,11 +668,88 @@ void UVaRestRequestJSON::ProcessRequest()
 		HttpRequest->SetHeader(It.Key(), It.Value());
 	}
 
+	// HttpRequest can't drop a header, blank the validators of an earlier revalidation
+	if (bConditionalHeadersSet)
+	{
+		HttpRequest->SetHeader(TEXT("If-None-Match"), TEXT(""));
+		HttpRequest->SetHeader(TEXT("If-Modified-Since"), TEXT(""));
+		bConditionalHeadersSet = false;
+	}
+
+	// GETs are answered from the response cache while fresh, then revalidated with the stored validators
+	ResponseCache.Reset();
+	PendingCacheEntry.Reset();
+	if (FVaRestResponseCache::IsCacheableRequest(*HttpRequest))
+	{
+		ResponseCache = GetSharedResponseCache();
+	}
+
+	if (ResponseCache.IsValid())
+	{
+		PendingCacheEntry = ResponseCache->Find(*HttpRequest);
+		if (PendingCacheEntry.IsValid() && PendingCacheEntry->IsFresh())
+		{
+			// Complete on the next tick like a real response would
+			const uint32 Serial = ResponseSerial;
+			TWeakObjectPtr<UVaRestRequestJSON> WeakThis(this);
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial]() {
+				UVaRestRequestJSON* This = WeakThis.Get();
+				if (This && This->ResponseSerial == Serial)
+				{
+					This->ServeCachedResponse();
+				}
+			});
+			return;
+		}
+
+		if (PendingCacheEntry.IsValid() && PendingCacheEntry->HasValidators())
+		{
+			HttpRequest->SetHeader(TEXT("If-None-Match"), PendingCacheEntry->ETag);
+			HttpRequest->SetHeader(TEXT("If-Modified-Since"), PendingCacheEntry->LastModified);
+			bConditionalHeadersSet = true;
+		}
+	}
+
+	// Parse the body while it downloads. Once the parser fails the rest is still received, just not parsed.
+	// Cacheable GETs keep the whole body instead
+	ResponseStream.Reset();
+	if (UVaRestLibrary::GetVaRestSettings()->bUseStreamingParser && !bResponseDocumentOnly && !ResponseCache.IsValid())
+	{
+		TSharedPtr<FJSONStreamReader, ESPMode::ThreadSafe> Stream = MakeShared<FJSONStreamReader, ESPMode::ThreadSafe>();
+		ResponseStream = Stream;
+
+		HttpRequest->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2::CreateLambda([Stream](void* Ptr, int64& Length) {
+			Stream->Append((const uint8*)Ptr, (int32)Length);
+		}));
+	}
+	else
+	{
+		HttpRequest->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2());
+	}
+
 	// Bind event
 	HttpRequest->OnProcessRequestComplete().BindUObject(this, &UVaRestRequestJSON::OnProcessRequestComplete);
 
 	// Execute the request
-	HttpRequest->ProcessRequest();
+	bAwaitingResponse = true;
+	if (!HttpRequest->ProcessRequest() && bAwaitingResponse)
+	{
+		// Rejected up front (e.g. invalid URL) without a completion. Fail on the next tick instead, so whoever waits
+		// for one (such as the subsystem's per-host slots) is released
+		UE_LOG(LogVaRest, Error, TEXT("%s: Request could not be started: %s"), *VA_FUNC_LINE, *HttpRequest->GetURL());
+		HttpRequest->OnProcessRequestComplete().Unbind();
+		bAwaitingResponse = false;
+
+		const uint32 Serial = ResponseSerial;
+		TWeakObjectPtr<UVaRestRequestJSON> WeakThis(this);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial]() {
+			UVaRestRequestJSON* This = WeakThis.Get();
+			if (This && This->ResponseSerial == Serial)
+			{
+				This->OnProcessRequestComplete(This->HttpRequest, nullptr, false);
+			}
+		});
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -483,12 +757,13 @@ void UVaRestRequestJSON::ProcessRequest()
 
 void UVaRestRequestJSON::OnProcessRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
-	// Remove from root on completion
-	RemoveFromRoot();
+	bAwaitingResponse = false;
 
 	// Be sure that we have no data from previous response
 	ResetResponseData();
 
+	const TSharedPtr<FJSONStreamReader, ESPMode::ThreadSafe> Stream = MoveTemp(ResponseStream);
+
 	// Check we have a response and save response code as int32
 	if (Response.IsValid())
 	{
@@ -498,6 +773,9 @@ void UVaRestRequestJSON::OnProcessRequestComplete(FHttpRequestPtr Request, FHttp
 	// Check we have result to process futher
 	if (!bWasSuccessful || !Response.IsValid())
 	{
+		// Remove from root on completion
+		RemoveFromRoot();
+
 		UE_LOG(LogVaRest, Error, TEXT("Request failed (%d): %s"), ResponseCode, *Request->GetURL());
 
 		// Broadcast the result event
@@ -507,31 +785,144 @@ void UVaRestRequestJSON::OnProcessRequestComplete(FHttpRequestPtr Request, FHttp
 		return;
 	}
 
+	// A write through any other verb makes the cached GET of the same URL stale
+	if (Request->GetVerb() != TEXT("GET") && ResponseCode < EHttpResponseCodes::BadRequest)
+	{
+		if (const TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> Cache = GetSharedResponseCache())
+		{
+			Cache->Remove(Request->GetURL());
+		}
+	}
+
 #if PLATFORM_DESKTOP
-	// Log response state
-	UE_LOG(LogVaRest, Log, TEXT("Response (%d): %sJSON(%s%s%s)JSON"), ResponseCode, LINE_TERMINATOR, LINE_TERMINATOR, *Response->GetContentAsString(), LINE_TERMINATOR);
+	// Log response state, the body only in part so large responses don't flood the log
+	const TArray<uint8>& Content = Response->GetContent();
+	const int64 BodySize = Stream.IsValid() ? Stream->BytesReceived : Content.Num();
+	if (UVaRestLibrary::GetVaRestSettings()->bExtendedLog && Content.Num() > 0)
+	{
+		const FUTF8ToTCHAR Converted((const ANSICHAR*)Content.GetData(), FMath::Min(Content.Num(), MaxLoggedResponseBytes));
+		const FString Logged(Converted.Length(), Converted.Get());
+		UE_LOG(LogVaRest, Log, TEXT("Response (%d): %lld bytes %sJSON(%s%s%s%s)JSON"), ResponseCode, BodySize, LINE_TERMINATOR, LINE_TERMINATOR, *Logged, Content.Num() > MaxLoggedResponseBytes ? TEXT("...") : TEXT(""), LINE_TERMINATOR);
+	}
+	else
+	{
+		UE_LOG(LogVaRest, Log, TEXT("Response (%d): %lld bytes (check bExtendedLog for additional data)"), ResponseCode, BodySize);
+	}
 #endif
 
+	FVaRestDecodeOptions Options = MakeDecodeOptions(bResponseDocumentOnly);
+	Options.Cache = MoveTemp(ResponseCache);
+	Options.CacheEntry = MoveTemp(PendingCacheEntry);
+	Options.URL = Request->GetURL();
+	if (Options.Cache.IsValid())
+	{
+		Options.VaryHeaders = FVaRestResponseCache::GetVaryHeaders(*Request, Response->GetHeader(TEXT("Vary")));
+	}
+
+	if (!UVaRestLibrary::GetVaRestSettings()->bDecodeResponseOnWorker)
+	{
+		FVaRestDecodedResponse Decoded;
+		DecodeResponse(Response, Stream, Options, Decoded);
+		FinishResponse(Response, Decoded);
+		return;
+	}
+
+	// Stay rooted until the result is back on the game thread. A newer ProcessRequest() makes it stale
+	const uint32 Serial = ResponseSerial;
+	TWeakObjectPtr<UVaRestRequestJSON> WeakThis(this);
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, Serial, Response, Stream, Options]() {
+		FVaRestDecodedResponse Decoded;
+		DecodeResponse(Response, Stream, Options, Decoded);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Response, Decoded = MoveTemp(Decoded)]() mutable {
+			UVaRestRequestJSON* This = WeakThis.Get();
+			if (This && This->ResponseSerial == Serial)
+			{
+				This->FinishResponse(Response, Decoded);
+			}
+		});
+	});
+}
+
+void UVaRestRequestJSON::DecodeResponse(const FHttpResponsePtr& Response, const TSharedPtr<FJSONStreamReader, ESPMode::ThreadSafe>& Stream, const FVaRestDecodeOptions& Options, FVaRestDecodedResponse& OutDecoded)
+{
 	// Process response headers
-	TArray<FString> Headers = Response->GetAllHeaders();
-	for (FString Header : Headers)
+	for (const FString& Header : Response->GetAllHeaders())
 	{
 		FString Key;
 		FString Value;
 		if (Header.Split(TEXT(": "), &Key, &Value))
 		{
-			ResponseHeaders.Add(Key, Value);
+			OutDecoded.Headers.Add(Key, Value);
+		}
+	}
+
+	// Not modified, the cached document answers it
+	if (Options.CacheEntry.IsValid() && Response->GetResponseCode() == EHttpResponseCodes::NotModified)
+	{
+		DecodeCachedResponse(Options.Cache->Refresh(Options.CacheEntry, OutDecoded.Headers), Options, OutDecoded);
+		return;
+	}
+
+	if (Stream.IsValid())
+	{
+		// Body already went through the chunked parser while it downloaded
+		OutDecoded.JsonObject = Stream->Reader.State.Root;
+		OutDecoded.Size = Stream->Reader.State.Size;
+
+		if (OutDecoded.Size == 0)
+		{
+			UE_LOG(LogVaRest, Warning, TEXT("JSON could not be decoded!"));
+		}
+	}
+	else if (Options.bDocumentOnly)
+	{
+		// Index the response bytes in place, no object tree
+		OutDecoded.bDocumentParsed = true;
+		OutDecoded.Document = FVaRestJsonDocument::Parse(Response->GetContent(), Response, Options.bUseDocumentStringArena);
+		if (OutDecoded.Document.IsValid())
+		{
+			OutDecoded.Size = Response->GetContent().Num();
+		}
+		else
+		{
+			UE_LOG(LogVaRest, Warning, TEXT("JSON could not be decoded!"));
 		}
 	}
+	else if (Options.bUseStructuralParser)
+	{
+		// Parse raw UTF-8 bytes directly, no intermediate string. Large root arrays are split between workers
+		const TArray<uint8>& Bytes = Response->GetContent();
+		const bool bParallel = Options.ParallelDecodeThreshold > 0 && Bytes.Num() >= Options.ParallelDecodeThreshold;
 
-	if (UVaRestLibrary::GetVaRestSettings()->bUseChunkedParser)
+		FJSONStructuralReader Reader;
+		if (bParallel ? Reader.ReadParallel((const ANSICHAR*)Bytes.GetData(), Bytes.Num()) : Reader.Read((const ANSICHAR*)Bytes.GetData(), Bytes.Num()))
+		{
+			OutDecoded.JsonValue = Reader.Root;
+
+			if (Reader.Root->Type == EJson::Object)
+			{
+				OutDecoded.JsonObject = Reader.Root->AsObject();
+				OutDecoded.Size = Bytes.Num();
+			}
+		}
+		else
+		{
+			UE_LOG(LogVaRest, Warning, TEXT("JSON could not be decoded!"));
+		}
+	}
+	else if (Options.bUseChunkedParser)
 	{
 		// Try to deserialize data to JSON
 		const TArray<uint8>& Bytes = Response->GetContent();
-		ResponseSize = ResponseJsonObj->DeserializeFromUTF8Bytes((const ANSICHAR*)Bytes.GetData(), Bytes.Num());
+		FJSONStreamReader Reader;
+		Reader.Append(Bytes.GetData(), Bytes.Num());
+
+		OutDecoded.JsonObject = Reader.Reader.State.Root;
+		OutDecoded.Size = Reader.Reader.State.Size;
 
 		// Log errors
-		if (ResponseSize == 0)
+		if (OutDecoded.Size == 0)
 		{
 			// As we assume it's recommended way to use current class, but not the only one,
 			// it will be the warning instead of error
@@ -545,27 +936,113 @@ void UVaRestRequestJSON::OnProcessRequestComplete(FHttpRequestPtr Request, FHttp
 		TSharedPtr<FJsonValue> OutJsonValue;
 		if (FJsonSerializer::Deserialize(Reader, OutJsonValue))
 		{
-			ResponseJsonValue->SetRootValue(OutJsonValue);
+			OutDecoded.JsonValue = OutJsonValue;
 
-			if (ResponseJsonValue->GetType() == EVaJson::Object)
+			if (OutJsonValue->Type == EJson::Object)
 			{
-				ResponseJsonObj->SetRootObject(ResponseJsonValue->GetRootValue()->AsObject());
-				ResponseSize = Response->GetContentLength();
+				OutDecoded.JsonObject = OutJsonValue->AsObject();
+				OutDecoded.Size = Response->GetContentLength();
 			}
 		}
 	}
 
+	if (OutDecoded.Size == 0)
+	{
+		// Save response data as a string
+		OutDecoded.Content = Response->GetContentAsString();
+		OutDecoded.Bytes = Response->GetContent();
+		OutDecoded.ContentLength = Response->GetContentLength();
+	}
+
+	// Kept for later requests. The document is built here once, so hits and 304s never parse again
+	if (Options.Cache.IsValid() && OutDecoded.Size > 0 && Response->GetResponseCode() == EHttpResponseCodes::Ok)
+	{
+		Options.Cache->Store(Options.URL, Options.VaryHeaders, OutDecoded.Headers, Response->GetContent(), Response, OutDecoded.Document);
+	}
+}
+
+void UVaRestRequestJSON::DecodeCachedResponse(const TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe>& Entry, const FVaRestDecodeOptions& Options, FVaRestDecodedResponse& OutDecoded)
+{
+	OutDecoded.CacheEntry = Entry;
+	OutDecoded.Headers = Entry->Headers;
+	OutDecoded.Document = Entry->Document;
+	OutDecoded.bDocumentParsed = true;
+	OutDecoded.Size = Entry->Document->GetSize();
+
+	if (Options.bDocumentOnly)
+	{
+		return;
+	}
+
+	// Object tree rebuilt from the stored document, the text isn't parsed again
+	OutDecoded.JsonValue = Entry->Document->GetRoot().ToJsonValue();
+	if (OutDecoded.JsonValue.IsValid() && OutDecoded.JsonValue->Type == EJson::Object)
+	{
+		OutDecoded.JsonObject = OutDecoded.JsonValue->AsObject();
+		return;
+	}
+
+	OutDecoded.Size = 0;
+	OutDecoded.Content = BodyToString(Entry->GetBody());
+	OutDecoded.Bytes = TArray<uint8>(Entry->GetBody());
+	OutDecoded.ContentLength = OutDecoded.Bytes.Num();
+}
+
+void UVaRestRequestJSON::ServeCachedResponse()
+{
+	// Be sure that we have no data from previous response
+	ResetResponseData();
+
+	UE_LOG(LogVaRest, Log, TEXT("Response (cached): %s"), *PendingCacheEntry->URL);
+
+	FVaRestDecodedResponse Decoded;
+	DecodeCachedResponse(PendingCacheEntry, MakeDecodeOptions(bResponseDocumentOnly), Decoded);
+
+	ResponseCache.Reset();
+	PendingCacheEntry.Reset();
+
+	FinishResponse(nullptr, Decoded);
+}
+
+void UVaRestRequestJSON::FinishResponse(const FHttpResponsePtr& Response, FVaRestDecodedResponse& Decoded)
+{
+	// Remove from root on completion
+	RemoveFromRoot();
+
+	ResponseHeaders = MoveTemp(Decoded.Headers);
+	LastResponse = Response;
+
+	if (Decoded.JsonValue.IsValid())
+	{
+		ResponseJsonValue->SetRootValue(Decoded.JsonValue);
+	}
+
+	if (Decoded.JsonObject.IsValid())
+	{
+		ResponseJsonObj->SetRootObject(Decoded.JsonObject);
+	}
+
+	ResponseDocument = MoveTemp(Decoded.Document);
+	bResponseDocumentParsed = Decoded.bDocumentParsed;
+
+	// A 304 reads as the 200 it confirmed
+	ServedCacheEntry = MoveTemp(Decoded.CacheEntry);
+	if (ServedCacheEntry.IsValid())
+	{
+		ResponseCode = EHttpResponseCodes::Ok;
+	}
+
 	// Decide whether the request was successful
-	bIsValidJsonResponse = bWasSuccessful && (ResponseSize > 0);
+	ResponseSize = Decoded.Size;
+	bIsValidJsonResponse = ResponseSize > 0;
 
 	if (!bIsValidJsonResponse)
 	{
-		// Save response data as a string
-		ResponseContent = Response->GetContentAsString();
+		ResponseContent = MoveTemp(Decoded.Content);
 		ResponseSize = ResponseContent.GetAllocatedSize();
 
-		ResponseBytes = Response->GetContent();
-		ResponseContentLength = Response->GetContentLength();
+		ResponseBytes = MoveTemp(Decoded.Bytes);
+		ResponseContentLength = Decoded.ContentLength;
 	}
 
 	// Broadcast the result events on next tick
@@ -615,6 +1092,22 @@ FString UVaRestRequestJSON::GetResponseContentAsString(bool bCacheResponseConten
 		return ResponseContent;
 	}
 
+	// Document-only responses have no object tree, hand out the raw text instead
+	if (bResponseDocumentOnly && (LastResponse.IsValid() || ServedCacheEntry.IsValid()))
+	{
+		if (!bCacheResponseContent)
+		{
+			return BodyToString(GetResponseBody());
+		}
+
+		if (ResponseContent == DeprecatedResponseString)
+		{
+			ResponseContent = BodyToString(GetResponseBody());
+		}
+
+		return ResponseContent;
+	}
+
 	// Check we have valid response object
 	if (!ResponseJsonObj || !ResponseJsonObj->IsValidLowLevel())
 	{
@@ -0,0 +1,598 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#include "VaRestResponseCache.h"
+
+#include "VaRestDefines.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+/** Bump when the layout of cache files changes, older files are then ignored */
+static constexpr int32 CacheFileVersion = 2;
+
+bool FVaRestCachedResponse::MatchesRequest(const IHttpRequest& Request) const
+{
+	for (const TPair<FString, FString>& Header : VaryHeaders)
+	{
+		if (Request.GetHeader(Header.Key) != Header.Value)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FVaRestResponseCache::FVaRestResponseCache(int64 InMaxBytes, const FString& InDiskDirectory, int64 InMaxDiskBytes, bool bInUseStringArena)
+	: MaxBytes(InMaxBytes)
+	, DiskDirectory(InDiskDirectory)
+	, MaxDiskBytes(InMaxDiskBytes)
+	, bUseStringArena(bInUseStringArena)
+{
+	if (DiskDirectory.IsEmpty())
+	{
+		return;
+	}
+
+	IFileManager::Get().MakeDirectory(*DiskDirectory, true);
+	IFileManager::Get().IterateDirectoryStat(*DiskDirectory, [this](const TCHAR* Path, const FFileStatData& Stat) {
+		if (!Stat.bIsDirectory && FPaths::GetExtension(Path) == TEXT("json-cache"))
+		{
+			FDiskFile& File = DiskFiles.Add(FPaths::GetBaseFilename(Path));
+			File.Bytes = Stat.FileSize;
+			File.LastUsed = Stat.ModificationTime.GetTicks();
+			DiskUsedBytes += Stat.FileSize;
+		}
+		return true;
+	});
+
+	// The budget may have been lowered since the last session
+	PruneDisk();
+}
+
+bool FVaRestResponseCache::IsCacheableRequest(const IHttpRequest& Request)
+{
+	if (Request.GetVerb() != TEXT("GET"))
+	{
+		return false;
+	}
+
+	// Responses to these belong to one account or session, and the cache is shared and may be persisted
+	static const TCHAR* const CredentialHeaders[] = {TEXT("Authorization"), TEXT("Proxy-Authorization"), TEXT("Cookie")};
+	for (const TCHAR* Header : CredentialHeaders)
+	{
+		if (!Request.GetHeader(Header).IsEmpty())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TMap<FString, FString> FVaRestResponseCache::GetVaryHeaders(const IHttpRequest& Request, const FString& Vary)
+{
+	TArray<FString> Names;
+	Vary.ParseIntoArray(Names, TEXT(","));
+
+	TMap<FString, FString> VaryHeaders;
+	for (FString& Name : Names)
+	{
+		Name.TrimStartAndEndInline();
+		if (!Name.IsEmpty())
+		{
+			VaryHeaders.Add(Name, Request.GetHeader(Name));
+		}
+	}
+
+	return VaryHeaders;
+}
+
+FVaRestResponseCache::FEntryPtr FVaRestResponseCache::Find(const IHttpRequest& Request)
+{
+	const FString URL = Request.GetURL();
+	FEntryPtr Entry = FindByURL(URL);
+
+	// Only one variant is kept per URL, the response to this request replaces it
+	return Entry.IsValid() && Entry->MatchesRequest(Request) ? Entry : nullptr;
+}
+
+FVaRestResponseCache::FEntryPtr FVaRestResponseCache::FindByURL(const FString& URL)
+{
+	bool bIsDead = false;
+	{
+		FScopeLock Lock(&Mutex);
+
+		// Map keys ignore case, URLs don't
+		FSlot* Slot = Slots.Find(URL);
+		if (Slot && Slot->Entry->URL.Equals(URL, ESearchCase::CaseSensitive))
+		{
+			bIsDead = IsDead(*Slot->Entry);
+			if (!bIsDead)
+			{
+				Slot->LastUsed = ++UseCounter;
+				if (FDiskFile* File = DiskFiles.Find(Slot->DiskKey))
+				{
+					File->LastUsed = FDateTime::UtcNow().GetTicks();
+				}
+				return Slot->Entry;
+			}
+		}
+	}
+
+	if (bIsDead)
+	{
+		Remove(URL);
+		return nullptr;
+	}
+
+	// Reading and parsing may take as long as a request, this one goes to the server and later ones find it in memory
+	LoadFromDiskAsync(URL);
+	return nullptr;
+}
+
+FVaRestResponseCache::FEntryPtr FVaRestResponseCache::Store(const FString& URL, const TMap<FString, FString>& VaryHeaders, const TMap<FString, FString>& Headers, TConstArrayView<uint8> Body, TSharedPtr<const void, ESPMode::ThreadSafe> Owner, TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document)
+{
+	// Vary: * matches no later request, and cookies set by the response are per session
+	FDateTime FreshUntil;
+	if (VaryHeaders.Contains(TEXT("*")) || Headers.Contains(TEXT("Set-Cookie")) || !GetFreshUntil(Headers, FreshUntil))
+	{
+		Remove(URL);
+		return nullptr;
+	}
+
+	const FString* ETag = Headers.Find(TEXT("ETag"));
+	const FString* LastModified = Headers.Find(TEXT("Last-Modified"));
+
+	// Neither fresh nor revalidatable, there is nothing to reuse it for
+	if (FreshUntil <= FDateTime::UtcNow() && !ETag && !LastModified)
+	{
+		Remove(URL);
+		return nullptr;
+	}
+
+	if (!Document.IsValid())
+	{
+		Document = FVaRestJsonDocument::Parse(Body, MoveTemp(Owner), bUseStringArena);
+		if (!Document.IsValid())
+		{
+			return nullptr;
+		}
+	}
+
+	TSharedPtr<FVaRestCachedResponse, ESPMode::ThreadSafe> Entry = MakeShared<FVaRestCachedResponse, ESPMode::ThreadSafe>();
+	Entry->URL = URL;
+	Entry->Headers = Headers;
+	Entry->VaryHeaders = VaryHeaders;
+	Entry->ETag = ETag ? *ETag : FString();
+	Entry->LastModified = LastModified ? *LastModified : FString();
+	Entry->FreshUntil = FreshUntil;
+	Entry->Document = MoveTemp(Document);
+
+	Keep(Entry);
+
+	return Entry;
+}
+
+FVaRestResponseCache::FEntryPtr FVaRestResponseCache::Refresh(const FEntryPtr& Entry, const TMap<FString, FString>& NotModifiedHeaders)
+{
+	TSharedPtr<FVaRestCachedResponse, ESPMode::ThreadSafe> Refreshed = MakeShared<FVaRestCachedResponse, ESPMode::ThreadSafe>(*Entry);
+
+	// Headers of a 304 replace the stored ones, the body stays
+	for (const TPair<FString, FString>& Header : NotModifiedHeaders)
+	{
+		if (!Header.Key.Equals(TEXT("Content-Length"), ESearchCase::IgnoreCase))
+		{
+			Refreshed->Headers.Add(Header.Key, Header.Value);
+		}
+	}
+
+	if (const FString* ETag = Refreshed->Headers.Find(TEXT("ETag")))
+	{
+		Refreshed->ETag = *ETag;
+	}
+
+	if (const FString* LastModified = Refreshed->Headers.Find(TEXT("Last-Modified")))
+	{
+		Refreshed->LastModified = *LastModified;
+	}
+
+	if (!GetFreshUntil(Refreshed->Headers, Refreshed->FreshUntil))
+	{
+		// Still good for the request that revalidated it, just not kept
+		Remove(Refreshed->URL);
+		return Refreshed;
+	}
+
+	Keep(Refreshed);
+
+	return Refreshed;
+}
+
+void FVaRestResponseCache::Clear()
+{
+	{
+		FScopeLock Lock(&Mutex);
+		Slots.Empty();
+		UsedBytes = 0;
+		DiskFiles.Empty();
+		DiskUsedBytes = 0;
+		DiskLoads.Empty();
+	}
+
+	if (!DiskDirectory.IsEmpty())
+	{
+		IFileManager::Get().DeleteDirectory(*DiskDirectory, false, true);
+		IFileManager::Get().MakeDirectory(*DiskDirectory, true);
+	}
+}
+
+int64 FVaRestResponseCache::GetUsedBytes() const
+{
+	FScopeLock Lock(&Mutex);
+	return UsedBytes;
+}
+
+bool FVaRestResponseCache::GetFreshUntil(const TMap<FString, FString>& Headers, FDateTime& OutFreshUntil)
+{
+	// Without explicit freshness every use revalidates
+	OutFreshUntil = FDateTime::MinValue();
+
+	bool bNoCache = false;
+	int64 MaxAge = -1;
+	if (const FString* CacheControl = Headers.Find(TEXT("Cache-Control")))
+	{
+		TArray<FString> Directives;
+		CacheControl->ParseIntoArray(Directives, TEXT(","));
+		for (FString& Directive : Directives)
+		{
+			Directive.TrimStartAndEndInline();
+			if (Directive.Equals(TEXT("no-store"), ESearchCase::IgnoreCase))
+			{
+				return false;
+			}
+
+			if (Directive.Equals(TEXT("no-cache"), ESearchCase::IgnoreCase))
+			{
+				bNoCache = true;
+			}
+			else if (Directive.StartsWith(TEXT("max-age="), ESearchCase::IgnoreCase))
+			{
+				LexFromString(MaxAge, *Directive.RightChop(8));
+			}
+		}
+	}
+
+	if (bNoCache)
+	{
+		return true;
+	}
+
+	if (MaxAge >= 0)
+	{
+		// Time the response already spent in shared caches counts against its lifetime
+		int64 Age = 0;
+		if (const FString* AgeHeader = Headers.Find(TEXT("Age")))
+		{
+			LexFromString(Age, **AgeHeader);
+		}
+
+		OutFreshUntil = FDateTime::UtcNow() + FTimespan::FromSeconds(FMath::Max<int64>(MaxAge - Age, 0));
+	}
+	else if (const FString* Expires = Headers.Find(TEXT("Expires")))
+	{
+		FDateTime ExpiresAt;
+		if (FDateTime::ParseHttpDate(*Expires, ExpiresAt))
+		{
+			OutFreshUntil = ExpiresAt;
+		}
+	}
+
+	return true;
+}
+
+int64 FVaRestResponseCache::GetEntryBytes(const FVaRestCachedResponse& Entry)
+{
+	int64 Bytes = Entry.Document->GetSize() + (int64)Entry.Document->NumNodes() * sizeof(FVaRestJsonNode);
+	for (const TPair<FString, FString>& Header : Entry.Headers)
+	{
+		Bytes += (Header.Key.Len() + Header.Value.Len()) * sizeof(TCHAR);
+	}
+
+	return Bytes;
+}
+
+bool FVaRestResponseCache::Insert(const FEntryPtr& Entry)
+{
+	const int64 Bytes = GetEntryBytes(*Entry);
+	const FString DiskKey = DiskDirectory.IsEmpty() ? FString() : GetDiskKey(Entry->URL);
+
+	FScopeLock Lock(&Mutex);
+
+	// A load of the file still running would only bring back older data
+	DiskLoads.Remove(DiskKey);
+
+	if (const FSlot* Existing = Slots.Find(Entry->URL))
+	{
+		UsedBytes -= Existing->Bytes;
+		Slots.Remove(Entry->URL);
+	}
+
+	// Larger than the whole budget, reading it back from disk on every request would cost more than it saves
+	if (Bytes > MaxBytes)
+	{
+		return false;
+	}
+
+	FSlot& Slot = Slots.Add(Entry->URL);
+	Slot.Entry = Entry;
+	Slot.Bytes = Bytes;
+	Slot.LastUsed = ++UseCounter;
+	Slot.DiskKey = DiskKey;
+	UsedBytes += Bytes;
+
+	// Evicted entries stay on disk, which has its own budget (see PruneDisk). Responses are few and large, a scan for the least recently used one is cheap next to them
+	while (UsedBytes > MaxBytes)
+	{
+		const FString* Oldest = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<FString, FSlot>& Pair : Slots)
+		{
+			if (Pair.Value.LastUsed < OldestUse)
+			{
+				Oldest = &Pair.Key;
+				OldestUse = Pair.Value.LastUsed;
+			}
+		}
+
+		const FString OldestURL = *Oldest;
+		UsedBytes -= Slots.FindChecked(OldestURL).Bytes;
+		Slots.Remove(OldestURL);
+	}
+
+	return true;
+}
+
+void FVaRestResponseCache::Keep(const FEntryPtr& Entry)
+{
+	if (Insert(Entry))
+	{
+		SaveToDisk(*Entry);
+	}
+	else
+	{
+		DeleteFromDisk(Entry->URL);
+	}
+}
+
+void FVaRestResponseCache::Remove(const FString& URL)
+{
+	const FString DiskKey = DiskDirectory.IsEmpty() ? FString() : GetDiskKey(URL);
+	{
+		FScopeLock Lock(&Mutex);
+		DiskLoads.Remove(DiskKey);
+		if (const FSlot* Existing = Slots.Find(URL))
+		{
+			UsedBytes -= Existing->Bytes;
+			Slots.Remove(URL);
+		}
+	}
+
+	DeleteFromDisk(URL);
+}
+
+FString FVaRestResponseCache::GetDiskKey(const FString& URL)
+{
+	return FMD5::HashAnsiString(*URL);
+}
+
+FString FVaRestResponseCache::GetDiskPath(const FString& DiskKey) const
+{
+	return FPaths::Combine(DiskDirectory, DiskKey + TEXT(".json-cache"));
+}
+
+void FVaRestResponseCache::SaveToDisk(const FVaRestCachedResponse& Entry)
+{
+	if (DiskDirectory.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	// Saving archives only read the values they are given
+	FVaRestCachedResponse& Saved = const_cast<FVaRestCachedResponse&>(Entry);
+
+	int32 Version = CacheFileVersion;
+	int32 BodySize = Entry.Document->GetSize();
+	Writer << Version << Saved.URL << Saved.Headers << Saved.VaryHeaders << Saved.ETag << Saved.LastModified << Saved.FreshUntil << BodySize;
+	Writer.Serialize(const_cast<ANSICHAR*>(Entry.Document->GetBytes()), BodySize);
+
+	const FString DiskKey = GetDiskKey(Entry.URL);
+	if (!FFileHelper::SaveArrayToFile(Data, *GetDiskPath(DiskKey)))
+	{
+		UE_LOG(LogVaRest, Warning, TEXT("%s: Can't write cached response of %s"), *VA_FUNC_LINE, *Entry.URL);
+		DeleteFromDisk(Entry.URL);
+		return;
+	}
+
+	{
+		FScopeLock Lock(&Mutex);
+		FDiskFile& File = DiskFiles.FindOrAdd(DiskKey);
+		DiskUsedBytes += Data.Num() - File.Bytes;
+		File.Bytes = Data.Num();
+		File.LastUsed = FDateTime::UtcNow().GetTicks();
+	}
+
+	PruneDisk();
+}
+
+void FVaRestResponseCache::LoadFromDiskAsync(const FString& URL)
+{
+	if (DiskDirectory.IsEmpty())
+	{
+		return;
+	}
+
+	const FString DiskKey = GetDiskKey(URL);
+	uint64 Token = 0;
+	{
+		// Only files known from the index are read, and none that could never be kept in memory
+		FScopeLock Lock(&Mutex);
+		FDiskFile* File = DiskFiles.Find(DiskKey);
+		if (!File || File->Bytes > MaxBytes || DiskLoads.Contains(DiskKey))
+		{
+			return;
+		}
+		File->LastUsed = FDateTime::UtcNow().GetTicks();
+
+		Token = ++DiskLoadCounter;
+		DiskLoads.Add(DiskKey, Token);
+	}
+
+	TWeakPtr<FVaRestResponseCache, ESPMode::ThreadSafe> WeakThis = AsShared();
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, URL, DiskKey, Token]() {
+		if (const TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> This = WeakThis.Pin())
+		{
+			This->FinishDiskLoad(URL, DiskKey, Token);
+		}
+	});
+}
+
+void FVaRestResponseCache::FinishDiskLoad(const FString& URL, const FString& DiskKey, uint64 Token)
+{
+	bool bIsUnreadable = false;
+	FEntryPtr Entry = LoadFromDisk(URL, DiskKey, bIsUnreadable);
+
+	bool bDelete = bIsUnreadable || (Entry.IsValid() && IsDead(*Entry));
+	{
+		FScopeLock Lock(&Mutex);
+
+		// Stored, removed or cleared while loading, what was read is older than that
+		const uint64* Current = DiskLoads.Find(DiskKey);
+		if (!Current || *Current != Token)
+		{
+			return;
+		}
+		DiskLoads.Remove(DiskKey);
+
+		// Too large once parsed, don't read it again. The lock is recursive, so nothing can store the URL between
+		// the check above and this
+		if (Entry.IsValid() && !bDelete && !Insert(Entry))
+		{
+			bDelete = true;
+		}
+	}
+
+	if (bDelete)
+	{
+		DeleteFromDisk(URL);
+	}
+}
+
+FVaRestResponseCache::FEntryPtr FVaRestResponseCache::LoadFromDisk(const FString& URL, const FString& DiskKey, bool& bOutIsUnreadable)
+{
+	bOutIsUnreadable = true;
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetDiskPath(DiskKey), FILEREAD_Silent))
+	{
+		return nullptr;
+	}
+
+	FMemoryReader Reader(Data);
+
+	// Written by an older layout, never readable again
+	int32 Version = 0;
+	Reader << Version;
+	if (Version != CacheFileVersion)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FVaRestCachedResponse, ESPMode::ThreadSafe> Entry = MakeShared<FVaRestCachedResponse, ESPMode::ThreadSafe>();
+
+	int32 BodySize = 0;
+	Reader << Entry->URL << Entry->Headers << Entry->VaryHeaders << Entry->ETag << Entry->LastModified << Entry->FreshUntil << BodySize;
+
+	// Hash collision or a damaged file
+	if (Reader.IsError() || !Entry->URL.Equals(URL, ESearchCase::CaseSensitive) || BodySize < 0 || BodySize > Reader.TotalSize() - Reader.Tell())
+	{
+		return nullptr;
+	}
+
+	TArray<uint8> Body;
+	Body.SetNumUninitialized(BodySize);
+	Reader.Serialize(Body.GetData(), BodySize);
+
+	Entry->Document = FVaRestJsonDocument::Parse(MoveTemp(Body), bUseStringArena);
+	if (!Entry->Document.IsValid())
+	{
+		return nullptr;
+	}
+
+	bOutIsUnreadable = false;
+	return Entry;
+}
+
+void FVaRestResponseCache::DeleteFromDisk(const FString& URL)
+{
+	if (DiskDirectory.IsEmpty())
+	{
+		return;
+	}
+
+	const FString DiskKey = GetDiskKey(URL);
+	{
+		FScopeLock Lock(&Mutex);
+		FDiskFile File;
+		if (!DiskFiles.RemoveAndCopyValue(DiskKey, File))
+		{
+			return;
+		}
+		DiskUsedBytes -= File.Bytes;
+	}
+
+	IFileManager::Get().Delete(*GetDiskPath(DiskKey), false, false, true);
+}
+
+void FVaRestResponseCache::PruneDisk()
+{
+	TArray<FString> Pruned;
+	{
+		FScopeLock Lock(&Mutex);
+
+		// Every distinct URL adds a file, so without this the directory only grows. A scan per file is cheap next
+		// to deleting it
+		while (DiskUsedBytes > MaxDiskBytes && DiskFiles.Num() > 0)
+		{
+			const FString* Oldest = nullptr;
+			int64 OldestUse = MAX_int64;
+			for (const TPair<FString, FDiskFile>& Pair : DiskFiles)
+			{
+				if (Pair.Value.LastUsed < OldestUse)
+				{
+					Oldest = &Pair.Key;
+					OldestUse = Pair.Value.LastUsed;
+				}
+			}
+
+			const FString OldestKey = *Oldest;
+			DiskUsedBytes -= DiskFiles.FindChecked(OldestKey).Bytes;
+			DiskFiles.Remove(OldestKey);
+			Pruned.Add(OldestKey);
+		}
+	}
+
+	for (const FString& DiskKey : Pruned)
+	{
+		IFileManager::Get().Delete(*GetDiskPath(DiskKey), false, false, true);
+	}
+}
@@ -0,0 +1,160 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "VaRestJsonDocument.h"
+
+#include "Interfaces/IHttpRequest.h"
+
+/** One cached json response, never changed once stored so requests can share it across threads */
+struct FVaRestCachedResponse
+{
+	FString URL;
+	TMap<FString, FString> Headers;
+
+	/** Request header values named by the response's Vary, only requests that send the same are answered from it */
+	TMap<FString, FString> VaryHeaders;
+
+	/** Validators sent back as If-None-Match/If-Modified-Since */
+	FString ETag;
+	FString LastModified;
+
+	/** Served without asking the server until then */
+	FDateTime FreshUntil;
+
+	/** Parsed once when stored, owns (or keeps alive) the body bytes */
+	TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document;
+
+	bool IsFresh() const { return FDateTime::UtcNow() < FreshUntil; }
+	bool HasValidators() const { return !ETag.IsEmpty() || !LastModified.IsEmpty(); }
+
+	/** Whether the entry may answer Request as far as Vary is concerned */
+	bool MatchesRequest(const IHttpRequest& Request) const;
+
+	/** Body as received */
+	TConstArrayView<uint8> GetBody() const { return TConstArrayView<uint8>((const uint8*)Document->GetBytes(), Document->GetSize()); }
+};
+
+/**
+ * Cache of GET responses that parse as json, shared by all requests through UVaRestSubsystem.
+ *
+ * Honors Cache-Control no-store/no-cache/max-age, Age, Expires and Vary. Entries past their freshness are kept while
+ * they have an ETag or Last-Modified, so the next request revalidates them and a 304 reuses the stored document.
+ * Requests carrying credentials and responses setting cookies are never cached, so one account's data can't be
+ * served to another. Memory is bounded by bytes with least recently used eviction, entries can also be written to
+ * disk to outlive the session. The disk is bounded the same way on its own budget, and entries that expired without
+ * validators are deleted once found. The files on disk are indexed once up front, so a miss never touches the disk,
+ * and responses too large for the memory budget aren't kept at all. Files are read and parsed on a worker, never by
+ * the caller. All functions are thread-safe.
+ */
+class FVaRestResponseCache : public TSharedFromThis<FVaRestResponseCache, ESPMode::ThreadSafe>
+{
+public:
+	typedef TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe> FEntryPtr;
+
+	/**
+	 * @param InMaxBytes        Memory budget of bodies plus parsed documents
+	 * @param InDiskDirectory   Where entries are persisted, empty to keep them in memory only
+	 * @param InMaxDiskBytes    Size budget of the files in InDiskDirectory
+	 */
+	FVaRestResponseCache(int64 InMaxBytes, const FString& InDiskDirectory, int64 InMaxDiskBytes, bool bInUseStringArena);
+
+	/** Whether Request may be answered from and stored in the cache: a GET without credentials */
+	static bool IsCacheableRequest(const IHttpRequest& Request);
+
+	/** Values Request sent for the headers the response names in Vary, to be passed to Store */
+	static TMap<FString, FString> GetVaryHeaders(const IHttpRequest& Request, const FString& Vary);
+
+	/**
+	 * Entry for Request from memory, stale ones included so they can be revalidated. One only on disk is a miss this
+	 * time and is loaded on a worker for the next request.
+	 */
+	FEntryPtr Find(const IHttpRequest& Request);
+
+	/**
+	 * Store a 200 response. Document may be null, the body is parsed then.
+	 * Returns nullptr when the headers forbid caching or the body isn't json.
+	 */
+	FEntryPtr Store(const FString& URL, const TMap<FString, FString>& VaryHeaders, const TMap<FString, FString>& Headers, TConstArrayView<uint8> Body, TSharedPtr<const void, ESPMode::ThreadSafe> Owner, TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Document);
+
+	/** Entry confirmed by a 304, with headers and freshness updated from it */
+	FEntryPtr Refresh(const FEntryPtr& Entry, const TMap<FString, FString>& NotModifiedHeaders);
+
+	/** Drop the entry of a URL, on disk too, e.g. after a request that may have changed it */
+	void Remove(const FString& URL);
+
+	/** Drop all entries, on disk too */
+	void Clear();
+
+	int64 GetUsedBytes() const;
+
+private:
+	/** Freshness lifetime from the headers, false for no-store */
+	static bool GetFreshUntil(const TMap<FString, FString>& Headers, FDateTime& OutFreshUntil);
+
+	static int64 GetEntryBytes(const FVaRestCachedResponse& Entry);
+
+	FEntryPtr FindByURL(const FString& URL);
+
+	/** Read the file of URL on a worker and insert it, unless the URL was stored or removed meanwhile */
+	void LoadFromDiskAsync(const FString& URL);
+	void FinishDiskLoad(const FString& URL, const FString& DiskKey, uint64 Token);
+
+	/** Add or replace in memory and evict least recently used entries over budget, false if it can never fit */
+	bool Insert(const FEntryPtr& Entry);
+
+	/** Insert and persist, or drop everywhere when too large to keep */
+	void Keep(const FEntryPtr& Entry);
+
+	static FString GetDiskKey(const FString& URL);
+	FString GetDiskPath(const FString& DiskKey) const;
+	void SaveToDisk(const FVaRestCachedResponse& Entry);
+	/** bOutIsUnreadable when the file can never be loaded and should be deleted */
+	FEntryPtr LoadFromDisk(const FString& URL, const FString& DiskKey, bool& bOutIsUnreadable);
+	void DeleteFromDisk(const FString& URL);
+
+	/** Delete least recently used files until the disk budget is met */
+	void PruneDisk();
+
+	/** Neither fresh nor revalidatable, nothing can be served from it anymore */
+	static bool IsDead(const FVaRestCachedResponse& Entry) { return !Entry.IsFresh() && !Entry.HasValidators(); }
+
+	struct FSlot
+	{
+		FEntryPtr Entry;
+		int64 Bytes = 0;
+		uint64 LastUsed = 0;
+
+		/** Of the entry's file, empty without a disk directory */
+		FString DiskKey;
+	};
+
+	struct FDiskFile
+	{
+		int64 Bytes = 0;
+
+		/** UTC ticks of the last write or use, files found on startup count from their modification time */
+		int64 LastUsed = 0;
+	};
+
+	mutable FCriticalSection Mutex;
+
+	TMap<FString, FSlot> Slots;
+	uint64 UseCounter = 0;
+	int64 UsedBytes = 0;
+
+	/** Each file in DiskDirectory by disk key */
+	TMap<FString, FDiskFile> DiskFiles;
+	int64 DiskUsedBytes = 0;
+
+	/** Loads running on workers by disk key, dropping one makes its result be discarded */
+	TMap<FString, uint64> DiskLoads;
+	uint64 DiskLoadCounter = 0;
+
+	const int64 MaxBytes;
+	const FString DiskDirectory;
+	const int64 MaxDiskBytes;
+	const bool bUseStringArena;
+};
@@ -7,4 +7,14 @@ UVaRestSettings::UVaRestSettings(const FObjectInitializer& ObjectInitializer)
 {
 	bExtendedLog = false;
 	bUseChunkedParser = false;
+	bUseStructuralParser = false;
+	bUseStreamingParser = false;
+	bDecodeResponseOnWorker = false;
+	ParallelDecodeThreshold = 0;
+	MaxRequestsPerHost = 0;
+	bUseDocumentStringArena = false;
+	bEnableResponseCache = false;
+	ResponseCacheSizeMB = 32;
+	bPersistResponseCache = false;
+	ResponseCacheDiskSizeMB = 256;
 }
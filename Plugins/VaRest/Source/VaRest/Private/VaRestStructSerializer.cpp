@@ -0,0 +1,794 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#include "VaRestStructSerializer.h"
+
+#include "VaRestDefines.h"
+#include "VaRestJsonStructuralParser.h"
+
+#include "Misc/ScopeRWLock.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
+
+namespace VaRestStructSerializer
+{
+	/** Property layout of one struct, built the first time the struct is serialized */
+	struct FFieldTable
+	{
+		/** Property chain the table was built from, changes when a user defined struct is recompiled */
+		const FProperty* PropertyLink = nullptr;
+
+		TArray<const FProperty*> Properties;
+
+		/** Escaped "name": prefix of each property, same order */
+		TArray<FString> Keys;
+
+		/** Authored name to property index, case-insensitive like FJsonObject field names */
+		TMap<FString, int32> Lookup;
+	};
+
+	using FFieldTablePtr = TSharedPtr<const FFieldTable, ESPMode::ThreadSafe>;
+
+	FRWLock TablesLock;
+	TMap<FObjectKey, FFieldTablePtr> Tables;
+
+	void AppendEscaped(FString& Out, const FString& String)
+	{
+		static const TCHAR HexDigits[] = TEXT("0123456789abcdef");
+
+		Out.AppendChar(TEXT('"'));
+
+		const TCHAR* Chars = *String;
+		const int32 Len = String.Len();
+		int32 SpanStart = 0;
+		for (int32 i = 0; i < Len; ++i)
+		{
+			const TCHAR Char = Chars[i];
+			if (Char >= 0x20 && Char != TEXT('"') && Char != TEXT('\\'))
+			{
+				continue;
+			}
+
+			Out.AppendChars(Chars + SpanStart, i - SpanStart);
+			SpanStart = i + 1;
+
+			switch (Char)
+			{
+			case TEXT('"'): Out.Append(TEXT("\\\"")); break;
+			case TEXT('\\'): Out.Append(TEXT("\\\\")); break;
+			case TEXT('\n'): Out.Append(TEXT("\\n")); break;
+			case TEXT('\r'): Out.Append(TEXT("\\r")); break;
+			case TEXT('\t'): Out.Append(TEXT("\\t")); break;
+			case TEXT('\b'): Out.Append(TEXT("\\b")); break;
+			case TEXT('\f'): Out.Append(TEXT("\\f")); break;
+			default:
+			{
+				const TCHAR Escaped[6] = {TEXT('\\'), TEXT('u'), TEXT('0'), TEXT('0'), HexDigits[(Char >> 4) & 0xF], HexDigits[Char & 0xF]};
+				Out.AppendChars(Escaped, 6);
+				break;
+			}
+			}
+		}
+		Out.AppendChars(Chars + SpanStart, Len - SpanStart);
+
+		Out.AppendChar(TEXT('"'));
+	}
+
+	FFieldTablePtr GetFieldTable(const UScriptStruct* Struct)
+	{
+		{
+			FReadScopeLock Lock(TablesLock);
+			const FFieldTablePtr* Found = Tables.Find(FObjectKey(Struct));
+			if (Found && (*Found)->PropertyLink == Struct->PropertyLink)
+			{
+				return *Found;
+			}
+		}
+
+		TSharedPtr<FFieldTable, ESPMode::ThreadSafe> Table = MakeShared<FFieldTable, ESPMode::ThreadSafe>();
+		Table->PropertyLink = Struct->PropertyLink;
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			const FString Name = It->GetAuthoredName();
+
+			FString Key;
+			AppendEscaped(Key, Name);
+			Key.AppendChar(TEXT(':'));
+
+			Table->Lookup.Add(Name, Table->Properties.Num());
+			Table->Properties.Add(*It);
+			Table->Keys.Add(MoveTemp(Key));
+		}
+
+		FWriteScopeLock Lock(TablesLock);
+		Tables.Add(FObjectKey(Struct), Table);
+		return Table;
+	}
+
+	FORCEINLINE bool IsWhitespace(ANSICHAR Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r';
+	}
+
+	/** Walks the structural index and writes every value into the property it maps to */
+	class FDecoder
+	{
+	public:
+		FDecoder(const ANSICHAR* InBytes, int32 InSize)
+			: Bytes(InBytes)
+			, Size(InSize)
+		{
+		}
+
+		bool Read(const UScriptStruct* Struct, void* Data)
+		{
+			if (!FJSONStructuralReader::BuildStructuralIndex(Bytes, Size, Index) || Peek() != '{')
+			{
+				return false;
+			}
+
+			return ReadStruct(Struct, Data, 1) && Cursor == Index.Num();
+		}
+
+		/** Byte offset decoding stopped at */
+		int32 GetOffset() const
+		{
+			return Index.IsValidIndex(Cursor) ? (int32)Index[Cursor] : Size;
+		}
+
+	private:
+		bool ReadStruct(const UScriptStruct* Struct, void* Data, int32 Depth)
+		{
+			const FFieldTablePtr Table = GetFieldTable(Struct);
+			return ReadFields([&]() {
+				const int32* Field = Table->Lookup.Find(Key);
+				if (!Field)
+				{
+					return SkipValue();
+				}
+				return ReadProperty(Table->Properties[*Field], Data, Depth);
+			});
+		}
+
+		bool ReadProperty(const FProperty* Property, void* Container, int32 Depth)
+		{
+			if (Property->ArrayDim == 1)
+			{
+				return ReadValue(Property, Property->ContainerPtrToValuePtr<void>(Container), Depth);
+			}
+
+			// Static arrays are json arrays, surplus elements are dropped
+			if (Peek() != '[')
+			{
+				return false;
+			}
+
+			return ReadElements([&](int32 ElementIndex) {
+				if (ElementIndex >= Property->ArrayDim)
+				{
+					return SkipValue();
+				}
+				return ReadValue(Property, Property->ContainerPtrToValuePtr<void>(Container, ElementIndex), Depth + 1);
+			});
+		}
+
+		bool ReadValue(const FProperty* Property, void* Value, int32 Depth)
+		{
+			const ANSICHAR Char = Peek();
+			if ((Char == '{' || Char == '[') && Depth >= FJSONStructuralReader::MaxDepth)
+			{
+				return false;
+			}
+
+			if (Char == '"')
+			{
+				return ReadString(Text) && ImportString(Property, Value, Text);
+			}
+
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				return Char == '{' ? ReadStruct(StructProperty->Struct, Value, Depth + 1) : ReadNull();
+			}
+
+			if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+			{
+				if (Char != '[')
+				{
+					return ReadNull();
+				}
+
+				FScriptArrayHelper Helper(ArrayProperty, Value);
+				Helper.EmptyValues();
+				return ReadElements([&](int32) {
+					const int32 ElementIndex = Helper.AddValue();
+					return ReadValue(ArrayProperty->Inner, Helper.GetRawPtr(ElementIndex), Depth + 1);
+				});
+			}
+
+			if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+			{
+				if (Char != '[')
+				{
+					return ReadNull();
+				}
+
+				FScriptSetHelper Helper(SetProperty, Value);
+				Helper.EmptyElements();
+				const bool bSuccess = ReadElements([&](int32) {
+					const int32 ElementIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
+					return ReadValue(SetProperty->ElementProp, Helper.GetElementPtr(ElementIndex), Depth + 1);
+				});
+				Helper.Rehash();
+				return bSuccess;
+			}
+
+			if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+			{
+				if (Char != '{')
+				{
+					return ReadNull();
+				}
+
+				// Keys come in as strings and are imported into the key property
+				FScriptMapHelper Helper(MapProperty, Value);
+				Helper.EmptyValues();
+				const bool bSuccess = ReadFields([&]() {
+					const int32 PairIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
+					return ImportString(MapProperty->KeyProp, Helper.GetKeyPtr(PairIndex), Key) && ReadValue(MapProperty->ValueProp, Helper.GetValuePtr(PairIndex), Depth + 1);
+				});
+				Helper.Rehash();
+				return bSuccess;
+			}
+
+			switch (Char)
+			{
+			case '\0':
+			case '{':
+			case '[':
+			case '}':
+			case ']':
+			case ':':
+			case ',': return false;
+			}
+
+			return ReadScalar(Property, Value);
+		}
+
+		bool ReadScalar(const FProperty* Property, void* Value)
+		{
+			const ANSICHAR* Token;
+			int32 Len;
+			ReadToken(Token, Len);
+
+			// Null keeps whatever the struct had
+			if (Len == 4 && FMemory::Memcmp(Token, "null", 4) == 0)
+			{
+				return true;
+			}
+
+			if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+			{
+				if (Len == 4 && FMemory::Memcmp(Token, "true", 4) == 0)
+				{
+					BoolProperty->SetPropertyValue(Value, true);
+					return true;
+				}
+				if (Len == 5 && FMemory::Memcmp(Token, "false", 5) == 0)
+				{
+					BoolProperty->SetPropertyValue(Value, false);
+					return true;
+				}
+				return false;
+			}
+
+			const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property);
+			if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				NumericProperty = EnumProperty->GetUnderlyingProperty();
+			}
+
+			if (!NumericProperty)
+			{
+				// Numbers and booleans still fit anything with a text form, e.g. a string property
+				return ImportString(Property, Value, FString(Len, Token));
+			}
+
+			double Number;
+			if (!FJSONStructuralReader::ParseNumber(Token, Token + Len, Number))
+			{
+				return false;
+			}
+
+			if (NumericProperty->IsFloatingPoint())
+			{
+				NumericProperty->SetFloatingPointPropertyValue(Value, Number);
+				return true;
+			}
+
+			// Plain integers are taken digit by digit so 64-bit ids survive, anything else is truncated
+			const bool bNegative = *Token == '-';
+			uint64 Magnitude = 0;
+			bool bExact = true;
+			for (const ANSICHAR* Digit = Token + (bNegative ? 1 : 0); Digit < Token + Len; ++Digit)
+			{
+				if (*Digit < '0' || *Digit > '9' || Magnitude > (MAX_uint64 - 9) / 10)
+				{
+					bExact = false;
+					break;
+				}
+				Magnitude = Magnitude * 10 + (*Digit - '0');
+			}
+
+			if (!bExact)
+			{
+				NumericProperty->SetIntPropertyValue(Value, (int64)Number);
+			}
+			else if (bNegative)
+			{
+				NumericProperty->SetIntPropertyValue(Value, Magnitude <= (uint64)MAX_int64 ? -(int64)Magnitude : (int64)Number);
+			}
+			else
+			{
+				NumericProperty->SetIntPropertyValue(Value, Magnitude);
+			}
+			return true;
+		}
+
+		bool ImportString(const FProperty* Property, void* Value, const FString& String)
+		{
+			if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+			{
+				StrProperty->SetPropertyValue(Value, String);
+				return true;
+			}
+
+			if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+			{
+				NameProperty->SetPropertyValue(Value, FName(*String));
+				return true;
+			}
+
+			if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+			{
+				TextProperty->SetPropertyValue(Value, FText::FromString(String));
+				return true;
+			}
+
+			// Enums by name, either "Value" or "EType::Value"
+			const UEnum* Enum = nullptr;
+			const FNumericProperty* NumericProperty = nullptr;
+			if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				Enum = EnumProperty->GetEnum();
+				NumericProperty = EnumProperty->GetUnderlyingProperty();
+			}
+			else if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+			{
+				Enum = ByteProperty->Enum;
+				NumericProperty = ByteProperty;
+			}
+
+			if (Enum)
+			{
+				const int64 EnumValue = Enum->GetValueByNameString(String);
+				if (EnumValue == INDEX_NONE)
+				{
+					return false;
+				}
+
+				NumericProperty->SetIntPropertyValue(Value, EnumValue);
+				return true;
+			}
+
+			// Object paths from the server must not find or load arbitrary assets, and delegates would bind by name.
+			// Structs and containers given as text (e.g. "(Ref=/Game/Foo.Foo)") are checked all the way down.
+			TArray<const FStructProperty*> EncounteredStructProps;
+			if (Property->IsA<FObjectPropertyBase>() || Property->IsA<FInterfaceProperty>() || Property->IsA<FDelegateProperty>()
+				|| Property->IsA<FMulticastDelegateProperty>()
+				|| Property->ContainsObjectReference(EncounteredStructProps,
+					EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak | EPropertyObjectReferenceType::Soft))
+			{
+				return true;
+			}
+
+			return Property->ImportText_Direct(*String, Value, nullptr, PPF_None) != nullptr;
+		}
+
+		/** Call ReadField for every key of the object at the cursor, with the key in Key and the cursor on its value */
+		bool ReadFields(TFunctionRef<bool()> ReadField)
+		{
+			++Cursor; // '{'
+			if (Peek() == '}')
+			{
+				++Cursor;
+				return true;
+			}
+
+			for (;;)
+			{
+				if (Peek() != '"' || !ReadString(Key) || Peek() != ':')
+				{
+					return false;
+				}
+				++Cursor;
+
+				if (!ReadField())
+				{
+					return false;
+				}
+
+				const ANSICHAR Next = Peek();
+				++Cursor;
+				if (Next == '}')
+				{
+					return true;
+				}
+				if (Next != ',')
+				{
+					return false;
+				}
+			}
+		}
+
+		/** Call ReadElement for every element of the array at the cursor */
+		bool ReadElements(TFunctionRef<bool(int32)> ReadElement)
+		{
+			++Cursor; // '['
+			if (Peek() == ']')
+			{
+				++Cursor;
+				return true;
+			}
+
+			for (int32 ElementIndex = 0;; ++ElementIndex)
+			{
+				if (!ReadElement(ElementIndex))
+				{
+					return false;
+				}
+
+				const ANSICHAR Next = Peek();
+				++Cursor;
+				if (Next == ']')
+				{
+					return true;
+				}
+				if (Next != ',')
+				{
+					return false;
+				}
+			}
+		}
+
+		/** Step over a value nobody asked for. Only bracket balance is checked inside it */
+		bool SkipValue()
+		{
+			int32 Nesting = 0;
+			do
+			{
+				switch (Peek())
+				{
+				case '\0':
+					return false;
+
+				case '"':
+					// Quotes are indexed in pairs
+					Cursor += 2;
+					continue;
+
+				case '{':
+				case '[':
+					++Nesting;
+					break;
+
+				case '}':
+				case ']':
+					if (--Nesting < 0)
+					{
+						return false;
+					}
+					break;
+
+				case ',':
+				case ':':
+					if (Nesting == 0)
+					{
+						return false;
+					}
+					break;
+				}
+				++Cursor;
+			} while (Nesting > 0);
+
+			return true;
+		}
+
+		/** Containers and structs only accept null besides their own bracket */
+		bool ReadNull()
+		{
+			if (Peek() == '\0')
+			{
+				return false;
+			}
+
+			const ANSICHAR* Token;
+			int32 Len;
+			ReadToken(Token, Len);
+			return Len == 4 && FMemory::Memcmp(Token, "null", 4) == 0;
+		}
+
+		bool ReadString(FString& OutString)
+		{
+			// The closing quote is always the next entry
+			if (Cursor + 1 >= Index.Num())
+			{
+				return false;
+			}
+
+			const uint32 Begin = Index[Cursor] + 1;
+			const uint32 End = Index[Cursor + 1];
+			Cursor += 2;
+
+			return FJSONStructuralReader::DecodeString(Bytes + Begin, Bytes + End, OutString);
+		}
+
+		/** A scalar runs up to the next entry, minus trailing whitespace */
+		void ReadToken(const ANSICHAR*& OutToken, int32& OutLen)
+		{
+			const uint32 Begin = Index[Cursor];
+			uint32 End = Cursor + 1 < Index.Num() ? Index[Cursor + 1] : (uint32)Size;
+			++Cursor;
+
+			while (End > Begin && IsWhitespace(Bytes[End - 1]))
+			{
+				--End;
+			}
+
+			OutToken = Bytes + Begin;
+			OutLen = End - Begin;
+		}
+
+		ANSICHAR Peek() const
+		{
+			return Cursor < Index.Num() ? Bytes[Index[Cursor]] : '\0';
+		}
+
+		const ANSICHAR* Bytes;
+		int32 Size;
+
+		TArray<uint32> Index;
+		int32 Cursor = 0;
+
+		/** Current field name, only valid until the field's value is read */
+		FString Key;
+
+		/** String values, reusing one allocation */
+		FString Text;
+	};
+
+	/** Appends properties as condensed json */
+	class FEncoder
+	{
+	public:
+		explicit FEncoder(FString& InOut)
+			: Out(InOut)
+		{
+		}
+
+		void WriteStruct(const UScriptStruct* Struct, const void* Data)
+		{
+			const FFieldTablePtr Table = GetFieldTable(Struct);
+
+			Out.AppendChar(TEXT('{'));
+			for (int32 i = 0; i < Table->Properties.Num(); ++i)
+			{
+				if (i > 0)
+				{
+					Out.AppendChar(TEXT(','));
+				}
+				Out.Append(Table->Keys[i]);
+				WriteProperty(Table->Properties[i], Data);
+			}
+			Out.AppendChar(TEXT('}'));
+		}
+
+	private:
+		void WriteProperty(const FProperty* Property, const void* Container)
+		{
+			if (Property->ArrayDim == 1)
+			{
+				WriteValue(Property, Property->ContainerPtrToValuePtr<void>(Container));
+				return;
+			}
+
+			Out.AppendChar(TEXT('['));
+			for (int32 i = 0; i < Property->ArrayDim; ++i)
+			{
+				if (i > 0)
+				{
+					Out.AppendChar(TEXT(','));
+				}
+				WriteValue(Property, Property->ContainerPtrToValuePtr<void>(Container, i));
+			}
+			Out.AppendChar(TEXT(']'));
+		}
+
+		void WriteValue(const FProperty* Property, const void* Value)
+		{
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				WriteStruct(StructProperty->Struct, Value);
+			}
+			else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+			{
+				FScriptArrayHelper Helper(ArrayProperty, Value);
+				Out.AppendChar(TEXT('['));
+				for (int32 i = 0; i < Helper.Num(); ++i)
+				{
+					if (i > 0)
+					{
+						Out.AppendChar(TEXT(','));
+					}
+					WriteValue(ArrayProperty->Inner, Helper.GetRawPtr(i));
+				}
+				Out.AppendChar(TEXT(']'));
+			}
+			else if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+			{
+				FScriptSetHelper Helper(SetProperty, Value);
+				Out.AppendChar(TEXT('['));
+				bool bFirst = true;
+				for (int32 i = 0, Remaining = Helper.Num(); Remaining > 0; ++i)
+				{
+					if (!Helper.IsValidIndex(i))
+					{
+						continue;
+					}
+					--Remaining;
+
+					if (!bFirst)
+					{
+						Out.AppendChar(TEXT(','));
+					}
+					bFirst = false;
+					WriteValue(SetProperty->ElementProp, Helper.GetElementPtr(i));
+				}
+				Out.AppendChar(TEXT(']'));
+			}
+			else if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+			{
+				FScriptMapHelper Helper(MapProperty, Value);
+				Out.AppendChar(TEXT('{'));
+				bool bFirst = true;
+				for (int32 i = 0, Remaining = Helper.Num(); Remaining > 0; ++i)
+				{
+					if (!Helper.IsValidIndex(i))
+					{
+						continue;
+					}
+					--Remaining;
+
+					if (!bFirst)
+					{
+						Out.AppendChar(TEXT(','));
+					}
+					bFirst = false;
+					AppendEscaped(Out, ExportString(MapProperty->KeyProp, Helper.GetKeyPtr(i)));
+					Out.AppendChar(TEXT(':'));
+					WriteValue(MapProperty->ValueProp, Helper.GetValuePtr(i));
+				}
+				Out.AppendChar(TEXT('}'));
+			}
+			else if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+			{
+				Out.Append(BoolProperty->GetPropertyValue(Value) ? TEXT("true") : TEXT("false"));
+			}
+			else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				WriteEnum(EnumProperty->GetEnum(), EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value));
+			}
+			else if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+			{
+				if (const UEnum* Enum = NumericProperty->GetIntPropertyEnum())
+				{
+					WriteEnum(Enum, NumericProperty->GetSignedIntPropertyValue(Value));
+				}
+				else if (NumericProperty->IsFloatingPoint())
+				{
+					const double Number = NumericProperty->GetFloatingPointPropertyValue(Value);
+					Out.Append(FMath::IsFinite(Number) ? FString::SanitizeFloat(Number) : FString(TEXT("null")));
+				}
+				else if (NumericProperty->IsA<FUInt64Property>())
+				{
+					Out.Appendf(TEXT("%llu"), NumericProperty->GetUnsignedIntPropertyValue(Value));
+				}
+				else
+				{
+					Out.Appendf(TEXT("%lld"), NumericProperty->GetSignedIntPropertyValue(Value));
+				}
+			}
+			else
+			{
+				AppendEscaped(Out, ExportString(Property, Value));
+			}
+		}
+
+		void WriteEnum(const UEnum* Enum, int64 Value)
+		{
+			const FString Name = Enum->GetNameStringByValue(Value);
+			if (Name.IsEmpty())
+			{
+				Out.Appendf(TEXT("%lld"), Value);
+			}
+			else
+			{
+				AppendEscaped(Out, Name);
+			}
+		}
+
+		static FString ExportString(const FProperty* Property, const void* Value)
+		{
+			if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+			{
+				return StrProperty->GetPropertyValue(Value);
+			}
+
+			if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+			{
+				return NameProperty->GetPropertyValue(Value).ToString();
+			}
+
+			if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+			{
+				return TextProperty->GetPropertyValue(Value).ToString();
+			}
+
+			FString String;
+			Property->ExportText_Direct(String, Value, nullptr, nullptr, PPF_None);
+			return String;
+		}
+
+		FString& Out;
+	};
+} // namespace VaRestStructSerializer
+
+bool FVaRestStructSerializer::DecodeJson(const UScriptStruct* Struct, void* OutData, const ANSICHAR* Bytes, int32 Size)
+{
+	if (!Struct || !OutData)
+	{
+		return false;
+	}
+
+	// Skip UTF-8 BOM
+	if (Size >= 3 && (uint8)Bytes[0] == 0xEF && (uint8)Bytes[1] == 0xBB && (uint8)Bytes[2] == 0xBF)
+	{
+		Bytes += 3;
+		Size -= 3;
+	}
+
+	VaRestStructSerializer::FDecoder Decoder(Bytes, Size);
+	if (!Decoder.Read(Struct, OutData))
+	{
+		UE_LOG(LogVaRest, Error, TEXT("%s: Can't decode json into %s near offset %d"), *VA_FUNC_LINE, *Struct->GetName(), Decoder.GetOffset());
+		return false;
+	}
+
+	return true;
+}
+
+bool FVaRestStructSerializer::DecodeJson(const UScriptStruct* Struct, void* OutData, const FString& JsonString)
+{
+	const FTCHARToUTF8 Converted(*JsonString, JsonString.Len());
+	return DecodeJson(Struct, OutData, (const ANSICHAR*)Converted.Get(), Converted.Length());
+}
+
+void FVaRestStructSerializer::EncodeJson(const UScriptStruct* Struct, const void* Data, FString& OutJson)
+{
+	OutJson.Reset();
+	if (!Struct || !Data)
+	{
+		return;
+	}
+
+	VaRestStructSerializer::FEncoder(OutJson).WriteStruct(Struct, Data);
+}
@@ -4,8 +4,15 @@
 
 #include "VaRestDefines.h"
 #include "VaRestJsonObject.h"
+#include "VaRestJsonStructuralParser.h"
 #include "VaRestJsonValue.h"
+#include "VaRestLibrary.h"
+#include "VaRestObjectPool.h"
+#include "VaRestResponseCache.h"
+#include "VaRestSettings.h"
 
+#include "Algo/Find.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "Serialization/JsonReader.h"
@@ -21,16 +28,30 @@ void UVaRestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 
+	const UVaRestSettings* Settings = UVaRestLibrary::GetVaRestSettings();
+	if (Settings->bEnableResponseCache)
+	{
+		const FString DiskDirectory = Settings->bPersistResponseCache ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VaRest"), TEXT("ResponseCache")) : FString();
+		ResponseCache = MakeShared<FVaRestResponseCache, ESPMode::ThreadSafe>((int64)Settings->ResponseCacheSizeMB * 1024 * 1024, DiskDirectory, (int64)Settings->ResponseCacheDiskSizeMB * 1024 * 1024, Settings->bUseDocumentStringArena);
+	}
+
 	UE_LOG(LogVaRest, Log, TEXT("%s: VaRest subsystem initialized"), *VA_FUNC_LINE);
 }
 
 void UVaRestSubsystem::Deinitialize()
 {
-	// Do nothing for now
+	// Calls that never got a slot won't be sent
+	HostQueues.Empty();
+	NumQueued = 0;
+	NumInFlight = 0;
+
+	// Requests still being decoded keep their own reference
+	ResponseCache.Reset();
+
 	Super::Deinitialize();
 }
 
-void UVaRestSubsystem::CallURL(const FString& URL, EVaRestRequestVerb Verb, EVaRestRequestContentType ContentType, UVaRestJsonObject* VaRestJson, const FVaRestCallDelegate& Callback)
+void UVaRestSubsystem::CallURL(const FString& URL, EVaRestRequestVerb Verb, EVaRestRequestContentType ContentType, UVaRestJsonObject* VaRestJson, const FVaRestCallDelegate& Callback, EVaRestRequestPriority Priority)
 {
 	// Check we have valid data json
 	if (VaRestJson == nullptr)
@@ -50,11 +71,55 @@ void UVaRestSubsystem::CallURL(const FString& URL, EVaRestRequestVerb Verb, EVaR
 
 	Response.CompleteDelegateHandle = Request->OnStaticRequestComplete.AddUObject(this, &UVaRestSubsystem::OnCallComplete);
 	Response.FailDelegateHandle = Request->OnStaticRequestFail.AddUObject(this, &UVaRestSubsystem::OnCallComplete);
+	Response.Host = FGenericPlatformHttp::GetUrlDomain(URL);
 
 	RequestMap.Add(Request, Response);
 
 	Request->ResetResponseData();
-	Request->ProcessURL(URL);
+
+	// Always queue first, so a free slot can't let a new call overtake waiting ones
+	FVaRestQueuedCall Call;
+	Call.Request = Request;
+	Call.URL = URL;
+	HostQueues.FindOrAdd(Response.Host).Pending[(int32)Priority].PushLast(MoveTemp(Call));
+	++NumQueued;
+
+	PumpHostQueue(Response.Host);
+}
+
+void UVaRestSubsystem::PumpHostQueue(const FString& Host)
+{
+	const int32 MaxRequestsPerHost = UVaRestLibrary::GetVaRestSettings()->MaxRequestsPerHost;
+
+	// Looked up again every round, sending may complete a call and change the map
+	while (FVaRestHostQueue* Queue = HostQueues.Find(Host))
+	{
+		if (MaxRequestsPerHost > 0 && Queue->InFlight >= MaxRequestsPerHost)
+		{
+			return;
+		}
+
+		TDeque<FVaRestQueuedCall>* Pending = Algo::FindByPredicate(Queue->Pending, [](const TDeque<FVaRestQueuedCall>& Calls) { return !Calls.IsEmpty(); });
+		if (!Pending)
+		{
+			if (Queue->InFlight == 0)
+			{
+				HostQueues.Remove(Host);
+			}
+			return;
+		}
+
+		const FVaRestQueuedCall Call = MoveTemp(Pending->First());
+		Pending->PopFirst();
+
+		++Queue->InFlight;
+		--NumQueued;
+		++NumInFlight;
+
+		// Every request completes or fails through OnCallComplete, which frees the slot again, even when it is
+		// answered from the cache or can't be started at all
+		Call.Request->ProcessURL(Call.URL);
+	}
 }
 
 void UVaRestSubsystem::OnCallComplete(UVaRestRequestJSON* Request)
@@ -68,9 +133,55 @@ void UVaRestSubsystem::OnCallComplete(UVaRestRequestJSON* Request)
 	Request->OnStaticRequestComplete.Remove(Response->CompleteDelegateHandle);
 	Request->OnStaticRequestFail.Remove(Response->FailDelegateHandle);
 
+	const FString Host = Response->Host;
+
 	Response->Callback.ExecuteIfBound(Request);
 	Response->Request = nullptr;
 	RequestMap.Remove(Request);
+
+	// Hand the slot to the next waiting call
+	if (FVaRestHostQueue* Queue = HostQueues.Find(Host))
+	{
+		if (Queue->InFlight > 0)
+		{
+			--Queue->InFlight;
+			--NumInFlight;
+		}
+		PumpHostQueue(Host);
+	}
+}
+
+int32 UVaRestSubsystem::GetQueuedRequestCount() const
+{
+	return NumQueued;
+}
+
+int32 UVaRestSubsystem::GetInFlightRequestCount() const
+{
+	return NumInFlight;
+}
+
+void UVaRestSubsystem::GetHostRequestCounts(const FString& Host, int32& Queued, int32& InFlight) const
+{
+	Queued = 0;
+	InFlight = 0;
+
+	if (const FVaRestHostQueue* Queue = HostQueues.Find(Host))
+	{
+		for (const TDeque<FVaRestQueuedCall>& Pending : Queue->Pending)
+		{
+			Queued += Pending.Num();
+		}
+		InFlight = Queue->InFlight;
+	}
+}
+
+void UVaRestSubsystem::ClearResponseCache()
+{
+	if (ResponseCache.IsValid())
+	{
+		ResponseCache->Clear();
+	}
 }
 
 UVaRestRequestJSON* UVaRestSubsystem::ConstructVaRestRequest()
@@ -90,7 +201,7 @@ UVaRestRequestJSON* UVaRestSubsystem::ConstructVaRestRequestExt(EVaRestRequestVe
 
 UVaRestJsonObject* UVaRestSubsystem::ConstructVaRestJsonObject()
 {
-	return NewObject<UVaRestJsonObject>(this);
+	return FVaRestObjectPool::AcquireObject();
 }
 
 UVaRestJsonObject* UVaRestSubsystem::StaticConstructVaRestJsonObject()
@@ -103,7 +214,7 @@ UVaRestJsonValue* UVaRestSubsystem::ConstructJsonValueNumber(float Number)
 {
 	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueNumber(Number));
 
-	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>(this);
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 	NewValue->SetRootValue(NewVal);
 
 	return NewValue;
@@ -113,7 +224,7 @@ UVaRestJsonValue* UVaRestSubsystem::ConstructJsonValueString(const FString& Stri
 {
 	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueString(StringValue));
 
-	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>(this);
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 	NewValue->SetRootValue(NewVal);
 
 	return NewValue;
@@ -123,7 +234,7 @@ UVaRestJsonValue* UVaRestSubsystem::ConstructJsonValueBool(bool InValue)
 {
 	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueBoolean(InValue));
 
-	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>(this);
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 	NewValue->SetRootValue(NewVal);
 
 	return NewValue;
@@ -140,7 +251,7 @@ UVaRestJsonValue* UVaRestSubsystem::ConstructJsonValueArray(const TArray<UVaRest
 
 	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueArray(ValueArray));
 
-	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>(this);
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 	NewValue->SetRootValue(NewVal);
 
 	return NewValue;
@@ -150,7 +261,7 @@ UVaRestJsonValue* UVaRestSubsystem::ConstructJsonValueObject(UVaRestJsonObject*
 {
 	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueObject(JsonObject->GetRootObject()));
 
-	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>(this);
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 	NewValue->SetRootValue(NewVal);
 
 	return NewValue;
@@ -160,7 +271,7 @@ UVaRestJsonValue* UVaRestSubsystem::ConstructJsonValue(const TSharedPtr<FJsonVal
 {
 	TSharedPtr<FJsonValue> NewVal = InValue;
 
-	UVaRestJsonValue* NewValue = NewObject<UVaRestJsonValue>(this);
+	UVaRestJsonValue* NewValue = FVaRestObjectPool::AcquireValue();
 	NewValue->SetRootValue(NewVal);
 
 	return NewValue;
@@ -184,7 +295,7 @@ UVaRestJsonObject* UVaRestSubsystem::DecodeJsonObject(const FString& JsonString)
 	TSharedPtr<FJsonObject> OutJsonObj;
 	if (FJsonSerializer::Deserialize(Reader, OutJsonObj))
 	{
-		auto NewJsonObj = NewObject<UVaRestJsonObject>(this);
+		auto NewJsonObj = FVaRestObjectPool::AcquireObject();
 		NewJsonObj->SetRootObject(OutJsonObj);
 		return NewJsonObj;
 	}
@@ -192,10 +303,60 @@ UVaRestJsonObject* UVaRestSubsystem::DecodeJsonObject(const FString& JsonString)
 	return nullptr;
 }
 
+void UVaRestSubsystem::ReleaseJsonValues(const TArray<UVaRestJsonValue*>& Values)
+{
+	for (UVaRestJsonValue* Value : Values)
+	{
+		FVaRestObjectPool::ReleaseValue(Value);
+	}
+}
+
+void UVaRestSubsystem::ReleaseJsonObjects(const TArray<UVaRestJsonObject*>& Objects)
+{
+	for (UVaRestJsonObject* Object : Objects)
+	{
+		FVaRestObjectPool::ReleaseObject(Object);
+	}
+}
+
 class UVaRestJsonObject* UVaRestSubsystem::LoadJsonFromFile(const FString& Path, const bool bIsRelativeToContentDir)
 {
 	auto* Json = ConstructVaRestJsonObject();
 
+	if (UVaRestLibrary::GetVaRestSettings()->bUseStructuralParser)
+	{
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *(bIsRelativeToContentDir ? FPaths::ProjectContentDir() / Path : Path)))
+		{
+			UE_LOG(LogVaRest, Error, TEXT("%s: Can't open file %s"), *VA_FUNC_LINE, *Path);
+			return nullptr;
+		}
+
+		// UTF-16 files (WriteToFile output) still go through the string path
+		const bool bIsUTF16 = Bytes.Num() >= 2 && ((Bytes[0] == 0xFF && Bytes[1] == 0xFE) || (Bytes[0] == 0xFE && Bytes[1] == 0xFF));
+		if (bIsUTF16)
+		{
+			FString JSONString;
+			FFileHelper::BufferToString(JSONString, Bytes.GetData(), Bytes.Num());
+			if (Json->DecodeJson(JSONString))
+			{
+				return Json;
+			}
+		}
+		else
+		{
+			FJSONStructuralReader Reader;
+			if (Reader.Read((const ANSICHAR*)Bytes.GetData(), Bytes.Num()) && Reader.Root->Type == EJson::Object)
+			{
+				Json->SetRootObject(Reader.Root->AsObject());
+				return Json;
+			}
+		}
+
+		UE_LOG(LogVaRest, Error, TEXT("%s: Can't decode json from file %s"), *VA_FUNC_LINE, *Path);
+		return nullptr;
+	}
+
 	FString JSONString;
 	if (FFileHelper::LoadFileToString(JSONString, *(bIsRelativeToContentDir ? FPaths::ProjectContentDir() / Path : Path)))
 	{
@@ -0,0 +1,139 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonValue.h"
+
+class FVaRestJsonDocument;
+
+/** One value of a parsed document. Containers are followed by their subtree, object keys precede their values */
+struct FVaRestJsonNode
+{
+	/** Byte range of the token, without the quotes for strings */
+	uint32 Begin = 0;
+	uint32 End = 0;
+
+	/** Index one past this node's subtree, i.e. its next sibling */
+	int32 Next = 0;
+
+	/** Number of elements for arrays, of fields for objects and of characters for strings in the string arena */
+	int32 Count = 0;
+
+	/** Offset of the decoded string in the document's string arena, if it has one */
+	int32 Text = INDEX_NONE;
+
+	EJson Type = EJson::None;
+
+	/** String contains escape sequences and has to be decoded before it can be compared */
+	bool bHasEscapes = false;
+
+	/** Converted once while parsing, numbers only */
+	double Number = 0.0;
+};
+
+/**
+ * Cheap read-only handle to one node of a FVaRestJsonDocument.
+ * Nothing is decoded or allocated until a string is requested. Only valid while its document lives.
+ */
+class VAREST_API FVaRestJsonView
+{
+public:
+	FVaRestJsonView() = default;
+	FVaRestJsonView(const FVaRestJsonDocument* InDocument, int32 InNode);
+
+	bool IsValid() const { return Document != nullptr; }
+
+	EJson GetType() const;
+
+	/** Number of elements of an array or fields of an object */
+	int32 Num() const;
+
+	/** Field of an object, invalid view if there is none */
+	FVaRestJsonView Find(FStringView Key) const;
+
+	/** Element of an array, invalid view if out of range */
+	FVaRestJsonView GetElement(int32 Index) const;
+
+	/**
+	 * Follow a path of field names and array indices, e.g. "data.items[2].name" or "[0].id".
+	 * Field names containing '.' or '[' can't be addressed this way.
+	 */
+	FVaRestJsonView Query(FStringView Path) const;
+
+	/** Field names of an object in document order */
+	TArray<FString> GetFieldNames() const;
+
+	bool TryGetString(FString& OutString) const;
+	bool TryGetNumber(double& OutNumber) const;
+	bool TryGetBool(bool& OutBool) const;
+	bool IsNull() const;
+
+	/** Decoded string without a copy. Only for documents parsed with a string arena, empty otherwise */
+	FStringView GetStringView() const;
+
+	/** Raw UTF-8 token as it appears in the document, strings without quotes and still escaped */
+	FAnsiStringView GetRawView() const;
+
+	/** Build a regular json value for this subtree */
+	TSharedPtr<FJsonValue> ToJsonValue() const;
+
+private:
+	const FVaRestJsonNode& GetNode() const;
+
+	const FVaRestJsonDocument* Document = nullptr;
+	int32 Node = INDEX_NONE;
+};
+
+/**
+ * Immutable json document: a flat array of nodes with offsets into the original UTF-8 bytes.
+ * Parsing is a structural scan plus one node per value, no per-value allocations, so reading a few fields out of
+ * a large response is cheap. Safe to share between threads once parsed.
+ */
+class VAREST_API FVaRestJsonDocument
+{
+public:
+	/**
+	 * Parse a buffer that Owner keeps alive (e.g. the http response it came with), nothing is copied
+	 *
+	 * @param bUseStringArena Decode every key and string up front into one contiguous buffer owned by the document,
+	 *        so reads never allocate and escaped keys compare as fast as plain ones
+	 */
+	static TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Parse(TConstArrayView<uint8> Bytes, TSharedPtr<const void, ESPMode::ThreadSafe> Owner, bool bUseStringArena = false);
+
+	/** Parse a buffer the document takes over */
+	static TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> Parse(TArray<uint8>&& Bytes, bool bUseStringArena = false);
+
+	FVaRestJsonView GetRoot() const { return FVaRestJsonView(this, 0); }
+
+	/** @see FVaRestJsonView::Query */
+	FVaRestJsonView Query(FStringView Path) const { return GetRoot().Query(Path); }
+
+	int32 NumNodes() const { return Nodes.Num(); }
+	const FVaRestJsonNode& GetNode(int32 Index) const { return Nodes[Index]; }
+
+	const ANSICHAR* GetBytes() const { return Bytes; }
+	int32 GetSize() const { return Size; }
+
+	bool HasStringArena() const { return bUseStringArena; }
+
+	/** Decoded string of a node parsed into the string arena */
+	FStringView GetArenaString(const FVaRestJsonNode& Node) const { return FStringView(StringArena.GetData() + Node.Text, Node.Count); }
+
+private:
+	bool Build();
+
+	TSharedPtr<const void, ESPMode::ThreadSafe> Owner;
+	TArray<uint8> OwnedBytes;
+
+	const ANSICHAR* Bytes = nullptr;
+	int32 Size = 0;
+
+	TArray<FVaRestJsonNode> Nodes;
+
+	/** All decoded keys and strings back to back, freed with the document */
+	TArray<TCHAR> StringArena;
+	bool bUseStringArena = false;
+
+	friend class FVaRestJsonDocumentBuilder;
+};
@@ -0,0 +1,111 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#pragma once
+
+#include "Dom/JsonValue.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+
+#include "VaRestJsonValue.h"
+
+#include "VaRestJsonHandle.generated.h"
+
+class UVaRestJsonObject;
+
+/**
+ * Blueprint handle to a json value that lives on the stack instead of the GC heap.
+ * Copies share the same value, reading fields and elements through it creates no UObjects.
+ */
+USTRUCT(BlueprintType)
+struct VAREST_API FVaRestJsonHandle
+{
+	GENERATED_BODY()
+
+	FVaRestJsonHandle() = default;
+	explicit FVaRestJsonHandle(const TSharedPtr<FJsonValue>& InValue)
+		: Value(InValue)
+	{
+	}
+
+	TSharedPtr<FJsonValue> Value;
+};
+
+/**
+ * Struct based json accessors, for hot reads where wrapping every field in a UVaRestJsonValue costs too much
+ */
+UCLASS()
+class VAREST_API UVaRestJsonHandleLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+	//////////////////////////////////////////////////////////////////////////
+	// Construction
+
+public:
+	/** Handle to the root object of a json object wrapper */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static FVaRestJsonHandle MakeObjectHandle(UVaRestJsonObject* JsonObject);
+
+	/** Handle to the value of a json value wrapper */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static FVaRestJsonHandle MakeValueHandle(UVaRestJsonValue* JsonValue);
+
+	/** Wrap the handle's value into a json value object (pooled, @see UVaRestSubsystem::ReleaseJsonValues) */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Handle")
+	static UVaRestJsonValue* HandleToJsonValue(const FVaRestJsonHandle& Handle);
+
+	/** Wrap the handle's object into a json object, nullptr if it isn't one */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Handle")
+	static UVaRestJsonObject* HandleToJsonObject(const FVaRestJsonHandle& Handle);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Navigation
+
+public:
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static bool IsValidHandle(const FVaRestJsonHandle& Handle);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static EVaJson GetHandleType(const FVaRestJsonHandle& Handle);
+
+	/** Number of elements of an array or fields of an object, 0 for anything else */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static int32 GetHandleLength(const FVaRestJsonHandle& Handle);
+
+	/** Field of an object, invalid handle if there is none */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static FVaRestJsonHandle GetHandleField(const FVaRestJsonHandle& Handle, const FString& FieldName);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static bool HandleHasField(const FVaRestJsonHandle& Handle, const FString& FieldName);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static TArray<FString> GetHandleFieldNames(const FVaRestJsonHandle& Handle);
+
+	/** Element of an array, invalid handle if out of range */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static FVaRestJsonHandle GetHandleElement(const FVaRestJsonHandle& Handle, int32 Index);
+
+	/** All elements of an array */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static TArray<FVaRestJsonHandle> GetHandleElements(const FVaRestJsonHandle& Handle);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Values
+
+public:
+	/** Attn.!! float used instead of double to make the function blueprintable! */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static float HandleAsNumber(const FVaRestJsonHandle& Handle);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static int32 HandleAsInt32(const FVaRestJsonHandle& Handle);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static FString HandleAsString(const FVaRestJsonHandle& Handle);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static bool HandleAsBool(const FVaRestJsonHandle& Handle);
+
+	UFUNCTION(BlueprintPure, Category = "VaRest|Handle")
+	static bool IsHandleNull(const FVaRestJsonHandle& Handle);
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "VaRestDefines.h"
+#include "VaRestTypes.h"
 
 #include "Dom/JsonObject.h"
 #include "Templates/UnrealTypeTraits.h"
@@ -268,15 +269,16 @@ public:
 
 public:
 	/** Save json to file */
-	bool WriteToFile(const FString& Path) const;
+	bool WriteToFile(const FString& Path, EVaRestFileEncoding Encoding = EVaRestFileEncoding::UCS2) const;
 
 	/**
 	 * Blueprint Save json to filepath
 	 *
 	 * @param bIsRelativeToProjectDir If set to 'false' path is treated as absolute
+	 * @param Encoding UCS-2 (with byte order mark) or UTF-8
 	 */
 	UFUNCTION(BlueprintCallable, Category = "VaRest|Json")
-	bool WriteToFilePath(const FString& Path, const bool bIsRelativeToProjectDir = true);
+	bool WriteToFilePath(const FString& Path, const bool bIsRelativeToProjectDir = true, EVaRestFileEncoding Encoding = EVaRestFileEncoding::UCS2);
 
 	static bool WriteStringToArchive(FArchive& Ar, const TCHAR* StrPtr, int64 Len);
 
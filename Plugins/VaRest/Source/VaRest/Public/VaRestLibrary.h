@@ -97,6 +97,23 @@ public:
 	UFUNCTION(BlueprintPure, Category = "VaRest|Utility", meta = (DisplayName = "Get VaRest Version"))
 	static FString GetVaRestVersion();
 
+	//////////////////////////////////////////////////////////////////////////
+	// Struct Serialization
+
+public:
+	/**
+	 * Fill any struct straight from json text, without building a Json Object first.
+	 * Fields are matched to struct members by name (case-insensitive), unknown fields are ignored.
+	 */
+	UFUNCTION(BlueprintCallable, CustomThunk, Category = "VaRest|Utility", meta = (CustomStructureParam = "OutStruct"))
+	static bool DecodeJsonToStruct(const FString& JsonString, int32& OutStruct);
+	DECLARE_FUNCTION(execDecodeJsonToStruct);
+
+	/** Write any struct as condensed json text */
+	UFUNCTION(BlueprintPure, CustomThunk, Category = "VaRest|Utility", meta = (CustomStructureParam = "Struct"))
+	static FString EncodeStructToJson(const int32& Struct);
+	DECLARE_FUNCTION(execEncodeStructToJson);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Common Network Helpers
 
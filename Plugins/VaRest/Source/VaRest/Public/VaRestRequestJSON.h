@@ -8,10 +8,18 @@
 #include "Interfaces/IHttpRequest.h"
 #include "LatentActions.h"
 
+#include "VaRestJsonDocument.h"
 #include "VaRestTypes.h"
 
 #include "VaRestRequestJSON.generated.h"
 
+struct FJSONStreamReader;
+struct FVaRestCachedResponse;
+struct FVaRestDecodedResponse;
+struct FVaRestDecodeOptions;
+
+class FVaRestResponseCache;
+
 class UVaRestJsonValue;
 class UVaRestJsonObject;
 class UVaRestSettings;
@@ -162,9 +170,48 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VaRest|Response")
 	UVaRestJsonValue* GetResponseValue() const;
 
+	/**
+	 * Skip building the response object tree and only index the raw response. Read it with the *AtPath
+	 * functions or GetResponseDocument(), which is far cheaper when just a few fields of a large response are needed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Response")
+	void SetResponseDocumentOnly(bool bDocumentOnly);
+
+	/** Read-only view of the last response, parsed on first use (nullptr if the response isn't valid json) */
+	TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> GetResponseDocument();
+
+	/** Get string at a path like "data.items[2].name" in the response */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Response")
+	FString GetResponseStringAtPath(const FString& Path, bool& bFound);
+
+	/** Get number at a path like "data.items[2].id" in the response */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Response")
+	float GetResponseNumberAtPath(const FString& Path, bool& bFound);
+
+	/** Get boolean at a path like "data.items[2].enabled" in the response */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Response")
+	bool GetResponseBoolAtPath(const FString& Path, bool& bFound);
+
+	/** Get the subtree at a path in the response as a regular json value (nullptr if there is none) */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Response")
+	UVaRestJsonValue* GetResponseValueAtPath(const FString& Path);
+
+	/** Fill any struct straight from the raw response body, no json object tree is built */
+	UFUNCTION(BlueprintCallable, CustomThunk, Category = "VaRest|Response", meta = (CustomStructureParam = "OutStruct"))
+	bool GetResponseStruct(int32& OutStruct);
+	DECLARE_FUNCTION(execGetResponseStruct);
+
+	/** Decode the raw response body into a struct instance */
+	bool DecodeResponseStruct(const UScriptStruct* Struct, void* OutData) const;
+
+protected:
+	/** Raw body of the last response, the cached one when it was served from the response cache */
+	TConstArrayView<uint8> GetResponseBody() const;
+
 	///////////////////////////////////////////////////////////////////////////
 	// Request/response data access
 
+public:
 	/** Get url of http request */
 	UFUNCTION(BlueprintPure, Category = "VaRest|Request")
 	FString GetURL() const;
@@ -237,6 +284,18 @@ private:
 	/** Internal bind function for the IHTTPRequest::OnProcessRequestCompleted() event */
 	void OnProcessRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
 
+	/** Header split and json decode of a response. Touches no UObject, so it can run on a worker */
+	static void DecodeResponse(const FHttpResponsePtr& Response, const TSharedPtr<FJSONStreamReader, ESPMode::ThreadSafe>& Stream, const FVaRestDecodeOptions& Options, FVaRestDecodedResponse& OutDecoded);
+
+	/** Apply a decoded response and broadcast the result, game thread only */
+	void FinishResponse(const FHttpResponsePtr& Response, FVaRestDecodedResponse& Decoded);
+
+	/** Fill a decoded response from a cache entry, its stored document replaces parsing */
+	static void DecodeCachedResponse(const TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe>& Entry, const FVaRestDecodeOptions& Options, FVaRestDecodedResponse& OutDecoded);
+
+	/** Complete with the fresh cache entry found by ProcessRequest(), no network involved */
+	void ServeCachedResponse();
+
 public:
 	/** Event occured when the request has been completed */
 	UPROPERTY(BlueprintAssignable, Category = "VaRest|Event")
@@ -331,6 +390,37 @@ protected:
 	UPROPERTY()
 	UVaRestJsonValue* ResponseJsonValue;
 
+	/** Build only the flat document for responses, see SetResponseDocumentOnly() */
+	bool bResponseDocumentOnly;
+
+	/** Last response, keeps the bytes the document points into alive */
+	FHttpResponsePtr LastResponse;
+
+	/** Lazily parsed view of LastResponse */
+	TSharedPtr<const FVaRestJsonDocument, ESPMode::ThreadSafe> ResponseDocument;
+	bool bResponseDocumentParsed;
+
+	/** Parser fed by the body stream of the request in flight, see UVaRestSettings::bUseStreamingParser */
+	TSharedPtr<FJSONStreamReader, ESPMode::ThreadSafe> ResponseStream;
+
+	/** Bumped by every ProcessRequest(), tells a response decoded on a worker whether it is still current */
+	uint32 ResponseSerial = 0;
+
+	/** Response cache of the GET in flight, see UVaRestSettings::bEnableResponseCache */
+	TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> ResponseCache;
+
+	/** Cached copy of the GET in flight, served if fresh, revalidated otherwise */
+	TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe> PendingCacheEntry;
+
+	/** Cache entry the last response was served from */
+	TSharedPtr<const FVaRestCachedResponse, ESPMode::ThreadSafe> ServedCacheEntry;
+
+	/** If-None-Match/If-Modified-Since were put on HttpRequest and have to be blanked for the next request */
+	bool bConditionalHeadersSet = false;
+
+	/** HttpRequest was sent and OnProcessRequestComplete hasn't run for it yet */
+	bool bAwaitingResponse = false;
+
 	/** Verb for making request (GET,POST,etc) */
 	EVaRestRequestVerb RequestVerb;
 
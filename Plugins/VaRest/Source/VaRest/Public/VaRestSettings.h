@@ -17,4 +17,47 @@ public:
 	/** Use custom chunked parses (best for memory, but has issues with hex-encoded utf-8) */
 	UPROPERTY(Config, EditAnywhere, Category = "VaRest")
 	bool bUseChunkedParser;
+
+	/** Use two-stage parser for UTF-8 responses and json files (SIMD structural scan, same result as default one). Takes precedence over chunked parser */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest")
+	bool bUseStructuralParser;
+
+	/** Feed response bodies to the chunked parser while they download. The raw body isn't kept, so only the parsed object is available. Takes precedence over other parsers */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest")
+	bool bUseStreamingParser;
+
+	/** Split headers and decode response bodies on a worker thread, the request events still fire on the game thread */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest")
+	bool bDecodeResponseOnWorker;
+
+	/** Responses of at least this many bytes with a root array have their elements parsed in parallel (structural parser only, 0 to disable) */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest", meta = (ClampMin = "0"))
+	int32 ParallelDecodeThreshold;
+
+	/** Most CallURL requests in flight to one host at a time, the rest wait in priority order (0 for no limit) */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest", meta = (ClampMin = "0"))
+	int32 MaxRequestsPerHost;
+
+	/** Decode all keys and strings of response documents into one contiguous buffer up front: no allocations on reads, more memory */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest")
+	bool bUseDocumentStringArena;
+
+	/**
+	 * Keep GET responses that parse as json and reuse them as Cache-Control and Vary allow, revalidating with ETag/Last-Modified.
+	 * Requests with Authorization or Cookie headers bypass it, other verbs drop the cached response of their URL.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest")
+	bool bEnableResponseCache;
+
+	/** Memory budget of the response cache in megabytes, least recently used responses are dropped first */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest", meta = (ClampMin = "1", EditCondition = "bEnableResponseCache"))
+	int32 ResponseCacheSizeMB;
+
+	/** Also write cached responses to Saved/VaRest/ResponseCache, so they survive restarts */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest", meta = (EditCondition = "bEnableResponseCache"))
+	bool bPersistResponseCache;
+
+	/** Disk budget of the persisted response cache in megabytes, least recently used files are deleted first */
+	UPROPERTY(Config, EditAnywhere, Category = "VaRest", meta = (ClampMin = "1", EditCondition = "bEnableResponseCache && bPersistResponseCache"))
+	int32 ResponseCacheDiskSizeMB;
 };
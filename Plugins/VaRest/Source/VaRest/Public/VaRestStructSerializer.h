@@ -0,0 +1,40 @@
+// Copyright 2024 Ziya Bahceci. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Class.h"
+
+/**
+ * Reads json straight into struct memory and writes structs straight to json text, no FJsonObject in between.
+ *
+ * Fields match properties by their authored name, case-insensitively. Unknown fields are skipped, missing and null
+ * ones leave the property untouched. Enums are written by name and read by name or value, strings are imported into
+ * any property that has a text form (FDateTime, FGuid...). Object, class, interface and delegate references are never
+ * read, so a response can't make the game find or load assets. The property layout of each struct is looked up once
+ * and cached.
+ */
+class VAREST_API FVaRestStructSerializer
+{
+public:
+	/** Decode UTF-8 json into a struct instance */
+	static bool DecodeJson(const UScriptStruct* Struct, void* OutData, const ANSICHAR* Bytes, int32 Size);
+	static bool DecodeJson(const UScriptStruct* Struct, void* OutData, const FString& JsonString);
+
+	/** Encode a struct instance as condensed json */
+	static void EncodeJson(const UScriptStruct* Struct, const void* Data, FString& OutJson);
+
+	template <typename T>
+	static bool DecodeJson(const FString& JsonString, T& OutStruct)
+	{
+		return DecodeJson(T::StaticStruct(), &OutStruct, JsonString);
+	}
+
+	template <typename T>
+	static FString EncodeJson(const T& Struct)
+	{
+		FString Json;
+		EncodeJson(T::StaticStruct(), &Struct, Json);
+		return Json;
+	}
+};
@@ -6,10 +6,13 @@
 #include "VaRestJsonValue.h"
 #include "VaRestRequestJSON.h"
 
+#include "Containers/Deque.h"
 #include "Subsystems/EngineSubsystem.h"
 
 #include "VaRestSubsystem.generated.h"
 
+class FVaRestResponseCache;
+
 DECLARE_DYNAMIC_DELEGATE_OneParam(FVaRestCallDelegate, UVaRestRequestJSON*, Request);
 
 USTRUCT()
@@ -26,12 +29,31 @@ struct FVaRestCallResponse
 	FDelegateHandle CompleteDelegateHandle;
 	FDelegateHandle FailDelegateHandle;
 
+	/** Host the call holds (or waits for) a slot on */
+	FString Host;
+
 	FVaRestCallResponse()
 		: Request(nullptr)
 	{
 	}
 };
 
+/** Call waiting for a free slot on its host */
+struct FVaRestQueuedCall
+{
+	UVaRestRequestJSON* Request = nullptr;
+	FString URL;
+};
+
+/** Scheduling state of one host */
+struct FVaRestHostQueue
+{
+	int32 InFlight = 0;
+
+	/** One FIFO per EVaRestRequestPriority, highest first */
+	TDeque<FVaRestQueuedCall> Pending[(int32)EVaRestRequestPriority::Low + 1];
+};
+
 UCLASS()
 class VAREST_API UVaRestSubsystem : public UEngineSubsystem
 {
@@ -49,17 +71,55 @@ public:
 	// Easy URL processing
 
 public:
-	/** Easy way to process http requests */
-	UFUNCTION(BlueprintCallable, Category = "VaRest|Utility")
-	void CallURL(const FString& URL, EVaRestRequestVerb Verb, EVaRestRequestContentType ContentType, UVaRestJsonObject* VaRestJson, const FVaRestCallDelegate& Callback);
+	/**
+	 * Easy way to process http requests.
+	 * With MaxRequestsPerHost set, calls over the limit wait for a free slot, higher priority first and in call order within one priority.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Utility", meta = (AdvancedDisplay = "Priority"))
+	void CallURL(const FString& URL, EVaRestRequestVerb Verb, EVaRestRequestContentType ContentType, UVaRestJsonObject* VaRestJson, const FVaRestCallDelegate& Callback, EVaRestRequestPriority Priority = EVaRestRequestPriority::Normal);
 
 	/** Called when URL is processed (one for both success/unsuccess events)*/
 	void OnCallComplete(UVaRestRequestJSON* Request);
 
+	/** Calls waiting for a free slot */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Utility")
+	int32 GetQueuedRequestCount() const;
+
+	/** Calls sent and not completed yet */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Utility")
+	int32 GetInFlightRequestCount() const;
+
+	/** Waiting and sent calls to one host, e.g. "api.example.com" */
+	UFUNCTION(BlueprintPure, Category = "VaRest|Utility")
+	void GetHostRequestCounts(const FString& Host, int32& Queued, int32& InFlight) const;
+
 protected:
+	/** Send waiting calls to a host while it has free slots */
+	void PumpHostQueue(const FString& Host);
+
 	UPROPERTY()
 	TMap<UVaRestRequestJSON*, FVaRestCallResponse> RequestMap;
 
+	/** Per host scheduling, requests are kept alive by RequestMap */
+	TMap<FString, FVaRestHostQueue> HostQueues;
+
+	int32 NumQueued = 0;
+	int32 NumInFlight = 0;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Response cache
+
+public:
+	/** Forget all cached responses, including the ones persisted on disk */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Utility")
+	void ClearResponseCache();
+
+	/** Cache shared by all requests, nullptr unless UVaRestSettings::bEnableResponseCache is set */
+	TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> GetResponseCache() const { return ResponseCache; }
+
+protected:
+	TSharedPtr<FVaRestResponseCache, ESPMode::ThreadSafe> ResponseCache;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Construction helpers
 
@@ -116,6 +176,21 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VaRest|Subsystem")
 	UVaRestJsonObject* DecodeJsonObject(const FString& JsonString);
 
+	//////////////////////////////////////////////////////////////////////////
+	// Wrapper pooling
+
+public:
+	/**
+	 * Hand json values back for reuse by later getters (e.g. after looping over Get Array Field).
+	 * Released values are reset and must not be used or kept anywhere afterwards.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Subsystem")
+	void ReleaseJsonValues(const TArray<UVaRestJsonValue*>& Values);
+
+	/** Hand json objects back for reuse. Released objects are reset and must not be used or kept anywhere afterwards */
+	UFUNCTION(BlueprintCallable, Category = "VaRest|Subsystem")
+	void ReleaseJsonObjects(const TArray<UVaRestJsonObject*>& Objects);
+
 	//////////////////////////////////////////////////////////////////////////
 	// File system integration
 
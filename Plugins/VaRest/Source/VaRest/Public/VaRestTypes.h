@@ -46,6 +46,25 @@ enum class EVaRestRequestStatus : uint8
 	Succeeded
 };
 
+/** Text encoding used when json is written to a file */
+UENUM(BlueprintType)
+enum class EVaRestFileEncoding : uint8
+{
+	/** UCS-2 with byte order mark */
+	UCS2 UMETA(DisplayName = "UCS-2"),
+	/** UTF-8 without byte order mark */
+	UTF8 UMETA(DisplayName = "UTF-8")
+};
+
+/** Order in which queued subsystem calls to the same host are sent, see UVaRestSettings::MaxRequestsPerHost */
+UENUM(BlueprintType)
+enum class EVaRestRequestPriority : uint8
+{
+	High,
+	Normal,
+	Low
+};
+
 // Taken from Interfaces/IHttpResponse.h (had to make BlueprintType :/)
 UENUM(BlueprintType)
 namespace EVaRestHttpStatusCode